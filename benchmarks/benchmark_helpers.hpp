@@ -0,0 +1,64 @@
+#ifndef BENCHMARK_HELPERS_HPP
+#define BENCHMARK_HELPERS_HPP
+
+#include <arpa/inet.h>
+#include <cstdint>
+#include <netinet/in.h>
+#include <netinet/tcp.h>
+#include <sys/socket.h>
+#include <unistd.h>
+
+namespace benchmarkHelpers {
+    /**
+     * tcp socket connected to port on the loopback address.
+     * returns -1 on error
+     */
+    inline int connectToLoopback(uint16_t port) {
+        sockaddr_in address = {};
+        address.sin_family = AF_INET;
+        address.sin_port = htons(port);
+        address.sin_addr.s_addr = htonl(INADDR_LOOPBACK);
+        int client = socket(AF_INET, SOCK_STREAM, 0);
+        if (client == -1) return -1;
+        if (connect(client, reinterpret_cast<sockaddr *>(&address), sizeof(address)) == -1) {
+            close(client);
+            return -1;
+        }
+        return client;
+    }
+
+    /**
+     * connected loopback TCP sockets, sockets[0] is the accepted one (non-blocking if nonBlocking is true),
+     * sockets[1] sends without Nagle's delay.
+     * returns true on error
+     */
+    inline bool createTcpPair(int sockets[2], bool nonBlocking = false) {
+        int listener = socket(AF_INET, SOCK_STREAM, 0);
+        if (listener == -1) return true;
+        sockaddr_in address = {};
+        address.sin_family = AF_INET;
+        address.sin_addr.s_addr = htonl(INADDR_LOOPBACK);
+        socklen_t addressLength = sizeof(address);
+        if (bind(listener, reinterpret_cast<sockaddr *>(&address), sizeof(address)) != 0 || listen(listener, 1) != 0
+            || getsockname(listener, reinterpret_cast<sockaddr *>(&address), &addressLength) != 0) {
+            close(listener);
+            return true;
+        }
+        sockets[1] = connectToLoopback(ntohs(address.sin_port));
+        if (sockets[1] == -1) {
+            close(listener);
+            return true;
+        }
+        sockets[0] = accept4(listener, nullptr, nullptr, nonBlocking ? SOCK_NONBLOCK : 0);
+        close(listener);
+        if (sockets[0] == -1) {
+            close(sockets[1]);
+            return true;
+        }
+        int noDelay = 1;
+        setsockopt(sockets[1], IPPROTO_TCP, TCP_NODELAY, &noDelay, sizeof(noDelay));
+        return false;
+    }
+} // namespace benchmarkHelpers
+
+#endif // BENCHMARK_HELPERS_HPP
@@ -0,0 +1,127 @@
+#include "../src/network_output_handler/broadcast_group.hpp"
+#include "../src/network_output_handler/network_output_handler.hpp"
+#include "benchmark_helpers.hpp"
+#include <ctime>
+#include <iomanip>
+#include <iostream>
+#include <string>
+#include <unistd.h>
+#include <vector>
+
+/**
+ * cpu time spent by the sending thread per frame sent to every subscriber,
+ * when the frame is serialized and copied for each subscriber or serialized once and shared.
+ * zero copy only works on tcp sockets, so the shared frame is also sent over loopback tcp, with and without MSG_ZEROCOPY.
+ * the subscribers are drained outside of the measured time.
+ * usage: broadcast_benchmark [frames] [frame size]
+ */
+namespace {
+    double threadCpuTime() {
+        timespec time;
+        clock_gettime(CLOCK_THREAD_CPUTIME_ID, &time);
+        return time.tv_sec + time.tv_nsec / 1e9;
+    }
+
+    /**
+     * stands for the encoding of a generation
+     */
+    std::string serialize(const std::vector<char> &board) { return std::string(board.begin(), board.end()); }
+
+    void drain(int socket) {
+        char buffer[64 * 1024];
+        while (recv(socket, buffer, sizeof(buffer), MSG_DONTWAIT) > 0) {
+        }
+    }
+
+    enum class Mode { PER_COPY, SHARED, SHARED_TCP, ZERO_COPY_TCP };
+
+    const char *modeName(Mode mode) {
+        switch (mode) {
+        case Mode::PER_COPY:
+            return "per copy      ";
+        case Mode::SHARED:
+            return "shared        ";
+        case Mode::SHARED_TCP:
+            return "shared tcp    ";
+        case Mode::ZERO_COPY_TCP:
+            return "zero copy tcp ";
+        }
+        return "";
+    }
+
+    void run(Mode mode, size_t subscribersCount, size_t frames, size_t frameSize) {
+        bool tcp = mode == Mode::SHARED_TCP || mode == Mode::ZERO_COPY_TCP;
+        std::vector<int> senders;
+        std::vector<int> receivers;
+        std::vector<std::unique_ptr<NetworkOutputHandler>> outputs;
+        BroadcastGroup group;
+        for (size_t i = 0; i < subscribersCount; i++) {
+            int sockets[2];
+            if (tcp) {
+                // the accepted socket is the non-blocking one, it sends
+                if (benchmarkHelpers::createTcpPair(sockets, true)) {
+                    perror("can't create tcp sockets");
+                    break;
+                }
+            }
+            else if (socketpair(AF_UNIX, SOCK_STREAM | SOCK_NONBLOCK, 0, sockets) != 0) {
+                perror("can't create socket pair");
+                break;
+            }
+            senders.push_back(sockets[0]);
+            receivers.push_back(sockets[1]);
+            outputs.push_back(std::make_unique<NetworkOutputHandler>(sockets[0]));
+            if (mode == Mode::ZERO_COPY_TCP && outputs.back()->enableZeroCopy(frameSize)) {
+                std::cerr << "zero copy not supported\n";
+                outputs.pop_back();
+                break;
+            }
+            group.subscribe(*outputs.back());
+        }
+
+        std::vector<char> board(frameSize, 1);
+        double cpuTime = 0;
+        for (size_t frame = 0; frame < frames; frame++) {
+            board[frame % frameSize]++;
+            double start = threadCpuTime();
+            if (mode != Mode::PER_COPY) {
+                group.broadcast(serialize(board));
+            }
+            else {
+                for (std::unique_ptr<NetworkOutputHandler> &output : outputs) {
+                    output->write(serialize(board));
+                }
+            }
+            for (std::unique_ptr<NetworkOutputHandler> &output : outputs) {
+                output->flush();
+            }
+            cpuTime += threadCpuTime() - start;
+            for (int receiver : receivers) {
+                drain(receiver);
+            }
+        }
+
+        std::cout << std::setw(5) << outputs.size() << " subscribers, " << modeName(mode) << ": " << std::fixed
+                  << std::setprecision(1) << cpuTime / frames * 1e6 << " us cpu/frame, " << std::setprecision(3)
+                  << cpuTime / frames / outputs.size() * 1e6 << " us cpu/frame/subscriber\n";
+        // the handlers wait for the last zero copy completions, before the sockets are closed
+        outputs.clear();
+        for (size_t i = 0; i < senders.size(); i++) {
+            close(senders[i]);
+            close(receivers[i]);
+        }
+    }
+} // namespace
+
+int main(int argc, char *argv[]) {
+    size_t frames = argc > 1 ? std::stoul(argv[1]) : 200;
+    size_t frameSize = argc > 2 ? std::stoul(argv[2]) : 16 * 1024;
+    const size_t subscribersCounts[] = {1, 100, 1000};
+
+    for (size_t subscribersCount : subscribersCounts) {
+        for (Mode mode : {Mode::PER_COPY, Mode::SHARED, Mode::SHARED_TCP, Mode::ZERO_COPY_TCP}) {
+            run(mode, subscribersCount, frames, frameSize);
+        }
+    }
+    return 0;
+}
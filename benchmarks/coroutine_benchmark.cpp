@@ -0,0 +1,109 @@
+#include "../src/network_coroutines/async_input_handler.hpp"
+#include "../src/network_coroutines/coroutine_scheduler.hpp"
+#include <chrono>
+#include <iomanip>
+#include <iostream>
+#include <string>
+#include <thread>
+#include <vector>
+
+/**
+ * compares coroutine sessions on one thread with one blocking thread per connection,
+ * both reading delimited messages sent round-robin on every connection.
+ * usage: coroutine_benchmark [connections] [messages per connection] [message size]
+ */
+namespace {
+    CoroutineScheduler::Task session(AsyncInputHandler &input, size_t messages, size_t &received) {
+        while (received < messages) {
+            auto [errorCode, message] = co_await input.readUntil('\n');
+            if (errorCode) co_return;
+            received++;
+        }
+    }
+
+    void writeRoundRobin(const std::vector<int> &senders, size_t messages, size_t messageSize) {
+        // a few messages per write, like a client sending one tick of commands
+        std::string batch;
+        const size_t batchSize = 8;
+        for (size_t i = 0; i < batchSize; i++) {
+            batch += std::string(messageSize - 1, 'x') + "\n";
+        }
+        for (size_t sent = 0; sent < messages; sent += batchSize) {
+            for (int sender : senders) {
+                if (write(sender, batch.data(), batch.size()) != static_cast<ssize_t>(batch.size())) {
+                    perror("write");
+                    return;
+                }
+            }
+        }
+    }
+
+    void run(bool coroutines, size_t connections, size_t messages, size_t messageSize) {
+        std::vector<int> senders;
+        std::vector<int> receivers;
+        for (size_t i = 0; i < connections; i++) {
+            int sockets[2];
+            if (socketpair(AF_UNIX, SOCK_STREAM, 0, sockets) != 0) {
+                perror("can't create socket pair");
+                break;
+            }
+            receivers.push_back(sockets[0]);
+            senders.push_back(sockets[1]);
+        }
+        std::vector<size_t> received(receivers.size(), 0);
+
+        auto start = std::chrono::steady_clock::now();
+        std::thread writeThread(writeRoundRobin, std::cref(senders), messages, messageSize);
+        if (coroutines) {
+            CoroutineScheduler scheduler(1024);
+            std::vector<std::unique_ptr<AsyncInputHandler>> inputs;
+            for (size_t i = 0; i < receivers.size(); i++) {
+                inputs.push_back(std::make_unique<AsyncInputHandler>(scheduler, receivers[i], 4096));
+                scheduler.spawn(session(*inputs.back(), messages, received[i]));
+            }
+            scheduler.run();
+        }
+        else {
+            std::vector<std::thread> threads;
+            for (size_t i = 0; i < receivers.size(); i++) {
+                threads.emplace_back([&received, &receivers, i, messages] {
+                    NetworkInputHandler inputHandler(receivers[i], 4096);
+                    std::string_view message;
+                    while (received[i] < messages) {
+                        int errorCode = inputHandler.readUntilDelimiterView('\n', message, false, true);
+                        if (errorCode == 0) received[i]++;
+                        // 1 is also returned when only part of a message has been received yet
+                        else if (errorCode != 1) return;
+                    }
+                });
+            }
+            for (std::thread &thread : threads) {
+                thread.join();
+            }
+        }
+        std::chrono::duration<double> elapsed = std::chrono::steady_clock::now() - start;
+        writeThread.join();
+
+        size_t total = 0;
+        for (size_t count : received) {
+            total += count;
+        }
+        std::cout << std::setw(5) << receivers.size() << " connections, " << (coroutines ? "coroutines        " : "thread/connection ") << ": "
+                  << std::fixed << std::setprecision(2) << total / elapsed.count() / 1e6 << " M messages/s, " << std::setprecision(3)
+                  << elapsed.count() << " s\n";
+        for (size_t i = 0; i < receivers.size(); i++) {
+            close(senders[i]);
+            close(receivers[i]);
+        }
+    }
+} // namespace
+
+int main(int argc, char *argv[]) {
+    size_t connections = argc > 1 ? std::stoul(argv[1]) : 2000;
+    size_t messages = argc > 2 ? std::stoul(argv[2]) : 2000;
+    size_t messageSize = argc > 3 ? std::stoul(argv[3]) : 64;
+
+    run(true, connections, messages, messageSize);
+    run(false, connections, messages, messageSize);
+    return 0;
+}
@@ -0,0 +1,61 @@
+#include "../src/network_input_handler/delimiter_search.hpp"
+#include <chrono>
+#include <iomanip>
+#include <iostream>
+#include <string>
+
+namespace {
+    using FindByteFunction = const char *(*)(const char *, const char *, char);
+
+    /**
+     * returns the throughput in bytes per second of searching a delimiter placed at the end of frames of frameSize bytes
+     */
+    double measure(FindByteFunction function, size_t frameSize, size_t totalBytes) {
+        std::string frame(frameSize, 'x');
+        frame.back() = '\n';
+        const char *begin = frame.data();
+        const char *end = frame.data() + frame.size();
+        size_t iterations = std::max<size_t>(1, totalBytes / frameSize);
+        size_t found = 0;
+
+        auto start = std::chrono::steady_clock::now();
+        for (size_t i = 0; i < iterations; i++) {
+            const char *pos = function(begin, end, '\n');
+            // keep the compiler from removing the call
+            asm volatile("" : : "r"(pos) : "memory");
+            found += pos != end;
+        }
+        std::chrono::duration<double> elapsed = std::chrono::steady_clock::now() - start;
+        if (found != iterations) std::cerr << "delimiter not found\n";
+        return iterations * frameSize / elapsed.count();
+    }
+} // namespace
+
+int main() {
+    const size_t totalBytes = 1 << 30;
+    const size_t frameSizes[] = {64, 1024, 16 * 1024, 64 * 1024};
+    const struct {
+        const char *name;
+        FindByteFunction function;
+    } implementations[] = {
+        {"scalar", delimiterSearch::findByteScalar},
+        {"sse2", delimiterSearch::findByteSse2},
+        {"dispatched", delimiterSearch::findByte},
+    };
+
+    std::cout << "dispatched implementation: " << delimiterSearch::findByteImplementationName() << "\n";
+    std::cout << std::setw(12) << "frame size";
+    for (const auto &implementation : implementations) {
+        std::cout << std::setw(16) << implementation.name;
+    }
+    std::cout << "  (GB/s)\n";
+
+    for (size_t frameSize : frameSizes) {
+        std::cout << std::setw(12) << frameSize;
+        for (const auto &implementation : implementations) {
+            std::cout << std::setw(16) << std::fixed << std::setprecision(2) << measure(implementation.function, frameSize, totalBytes) / 1e9;
+        }
+        std::cout << "\n";
+    }
+    return 0;
+}
@@ -0,0 +1,85 @@
+#include "../src/network_input_handler/network_input_handler.hpp"
+#include <chrono>
+#include <iomanip>
+#include <iostream>
+#include <string>
+#include <thread>
+#include <unistd.h>
+
+/**
+ * compares read, which receives big messages directly into out, with readView followed by a copy,
+ * which receives into the internal buffer first.
+ * usage: direct_read_benchmark [total bytes per payload size] [buffer size]
+ */
+namespace {
+    void run(bool direct, size_t payloadSize, size_t totalBytes, size_t bufferSize) {
+        int sockets[2];
+        if (socketpair(AF_UNIX, SOCK_STREAM, 0, sockets) != 0) {
+            perror("can't create socket pair");
+            return;
+        }
+        // the sender can be ahead by a whole payload
+        int sendBufferSize = static_cast<int>(std::min<size_t>(payloadSize, 4 << 20));
+        setsockopt(sockets[1], SOL_SOCKET, SO_SNDBUF, &sendBufferSize, sizeof(sendBufferSize));
+
+        size_t payloads = std::max<size_t>(1, totalBytes / payloadSize);
+        std::string payload(payloadSize, 'x');
+        std::thread writeThread([&] {
+            for (size_t i = 0; i < payloads; i++) {
+                for (size_t sent = 0; sent < payload.size();) {
+                    ssize_t written = write(sockets[1], payload.data() + sent, payload.size() - sent);
+                    if (written <= 0) {
+                        perror("write");
+                        return;
+                    }
+                    sent += written;
+                }
+            }
+        });
+
+        NetworkInputHandler inputHandler(sockets[0], bufferSize);
+        std::string out;
+        std::string_view view;
+        size_t received = 0;
+        size_t callerCopies = 0;
+        auto start = std::chrono::steady_clock::now();
+        while (received < payloads) {
+            int errorCode;
+            if (direct) {
+                errorCode = inputHandler.read(payloadSize, out);
+            }
+            else {
+                errorCode = inputHandler.readView(payloadSize, view);
+                if (errorCode == 0) {
+                    out.assign(view);
+                    callerCopies += payloadSize;
+                }
+            }
+            if (errorCode == 0) received++;
+            // 1 is also returned when only part of a payload has been received yet
+            else if (errorCode != 1) break;
+        }
+        std::chrono::duration<double> elapsed = std::chrono::steady_clock::now() - start;
+        writeThread.join();
+
+        double copied = static_cast<double>(inputHandler.copiedBytes() + callerCopies);
+        std::cout << std::setw(9) << payloadSize << " bytes, " << (direct ? "read     " : "readView ") << ": " << std::fixed << std::setprecision(3)
+                  << copied / (received * payloadSize) << " copied bytes/payload byte, " << std::setprecision(0)
+                  << received * payloadSize / elapsed.count() / 1e6 << " MB/s, " << std::setprecision(2)
+                  << static_cast<double>(inputHandler.syscalls()) / received << " syscalls/payload\n";
+        close(sockets[0]);
+        close(sockets[1]);
+    }
+} // namespace
+
+int main(int argc, char *argv[]) {
+    size_t totalBytes = argc > 1 ? std::stoul(argv[1]) : 1 << 30;
+    size_t bufferSize = argc > 2 ? std::stoul(argv[2]) : 4096;
+    const size_t payloadSizes[] = {1024, 64 * 1024, 1 << 20, 4 << 20};
+
+    for (size_t payloadSize : payloadSizes) {
+        run(false, payloadSize, totalBytes, bufferSize);
+        run(true, payloadSize, totalBytes, bufferSize);
+    }
+    return 0;
+}
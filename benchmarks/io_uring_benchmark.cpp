@@ -0,0 +1,76 @@
+#include "../src/network_input_handler/network_input_handler.hpp"
+#include "benchmark_helpers.hpp"
+#include <chrono>
+#include <iostream>
+#include <string>
+#include <thread>
+#include <unistd.h>
+
+/**
+ * compares the recv and io_uring receive paths over loopback tcp.
+ * build with `make bench IO_URING=1`, otherwise only recv is measured.
+ * usage: io_uring_benchmark [messages] [message size] [buffer size]
+ */
+namespace {
+    void run(bool ioUring, size_t messages, size_t messageSize, size_t bufferSize) {
+        int sockets[2];
+        if (benchmarkHelpers::createTcpPair(sockets)) {
+            perror("can't create loopback connection");
+            return;
+        }
+        int server = sockets[0];
+        int client = sockets[1];
+
+        NetworkInputHandler inputHandler = NetworkInputHandler(server, bufferSize);
+        if (ioUring && inputHandler.useIoUring(64)) {
+            std::cout << "io_uring: not available\n";
+            close(server);
+            close(client);
+            return;
+        }
+
+        std::string batch;
+        const size_t batchSize = 64;
+        for (size_t i = 0; i < batchSize; i++) {
+            batch += std::string(messageSize - 1, 'x') + "\n";
+        }
+
+        std::thread writeThread([client, &batch, messages, batchSize] {
+            for (size_t sent = 0; sent < messages; sent += batchSize) {
+                if (write(client, batch.data(), batch.size()) != static_cast<ssize_t>(batch.size())) {
+                    perror("write");
+                    return;
+                }
+            }
+            shutdown(client, SHUT_WR);
+        });
+
+        auto start = std::chrono::steady_clock::now();
+        size_t received = 0;
+        std::string_view message;
+        while (received < messages) {
+            int errorCode = inputHandler.readUntilDelimiterView('\n', message, false, true);
+            if (errorCode == 0) received++;
+            // 1 is also returned when only part of a message has been received yet
+            else if (errorCode != 1) break;
+        }
+        std::chrono::duration<double> elapsed = std::chrono::steady_clock::now() - start;
+        writeThread.join();
+
+        std::cout << (ioUring ? "io_uring" : "recv") << ": " << received << " messages, " << received / elapsed.count() / 1e6 << " M messages/s, "
+                  << received * messageSize / elapsed.count() / 1e6 << " MB/s, " << static_cast<double>(inputHandler.syscalls()) / received
+                  << " syscalls/message\n";
+        close(server);
+        close(client);
+    }
+} // namespace
+
+int main(int argc, char *argv[]) {
+    size_t messages = argc > 1 ? std::stoul(argv[1]) : 4000000;
+    size_t messageSize = argc > 2 ? std::stoul(argv[2]) : 64;
+    size_t bufferSize = argc > 3 ? std::stoul(argv[3]) : 4096;
+
+    run(false, messages, messageSize, bufferSize);
+    run(true, messages, messageSize, bufferSize);
+    return 0;
+}
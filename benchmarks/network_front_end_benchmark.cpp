@@ -0,0 +1,88 @@
+#include "../src/network_front_end/network_front_end.hpp"
+#include "benchmark_helpers.hpp"
+#include <chrono>
+#include <iostream>
+#include <string>
+#include <thread>
+#include <vector>
+
+/**
+ * messages handled per second by a NetworkFrontEnd with 1 to N threads over loopback tcp.
+ * the pool has as many threads as the front end.
+ * usage: network_front_end_benchmark [max threads] [clients] [messages per client]
+ */
+namespace {
+    /**
+     * returns the number of messages handled per second, or -1 in case of error
+     */
+    double measure(size_t threads, size_t clientsCount, size_t messagesPerClient) {
+        WorkStealingPool pool = WorkStealingPool(threads);
+        std::atomic<size_t> handled = 0;
+        NetworkFrontEnd frontEnd = NetworkFrontEnd("127.0.0.1", 0, threads, pool, 16384);
+        // a little work per message, like applying a cell toggle
+        frontEnd.setDelimitedMessages("\n", [&handled](int, const std::string &message) {
+            size_t sum = 0;
+            for (char c : message) {
+                sum += c;
+            }
+            asm volatile("" : : "r"(sum));
+            handled.fetch_add(1, std::memory_order_relaxed);
+        });
+        if (frontEnd.start()) return -1;
+
+        std::vector<int> clients;
+        for (size_t i = 0; i < clientsCount; i++) {
+            int client = benchmarkHelpers::connectToLoopback(frontEnd.port());
+            if (client == -1) return -1;
+            clients.push_back(client);
+        }
+
+        std::string batch;
+        for (size_t i = 0; i < 64; i++) {
+            batch += "toggle 123 456\n";
+        }
+        size_t batches = messagesPerClient / 64;
+        size_t total = batches * 64 * clientsCount;
+
+        auto start = std::chrono::steady_clock::now();
+        std::vector<std::thread> writers;
+        for (size_t i = 0; i < clientsCount; i++) {
+            writers.emplace_back([client = clients[i], &batch, batches] {
+                for (size_t j = 0; j < batches; j++) {
+                    if (write(client, batch.data(), batch.size()) != static_cast<ssize_t>(batch.size())) return;
+                }
+            });
+        }
+        for (std::thread &writer : writers) {
+            writer.join();
+        }
+        while (handled < total) {
+            std::this_thread::sleep_for(std::chrono::microseconds(100));
+        }
+        std::chrono::duration<double> elapsed = std::chrono::steady_clock::now() - start;
+
+        frontEnd.stop();
+        pool.waitIdle();
+        for (int client : clients) {
+            close(client);
+        }
+        return total / elapsed.count();
+    }
+} // namespace
+
+int main(int argc, char *argv[]) {
+    size_t maxThreads = argc > 1 ? std::stoul(argv[1]) : std::max(1u, std::thread::hardware_concurrency());
+    size_t clients = argc > 2 ? std::stoul(argv[2]) : 8;
+    size_t messagesPerClient = argc > 3 ? std::stoul(argv[3]) : 100000;
+
+    std::cout << "threads  M messages/s\n";
+    for (size_t threads = 1; threads <= maxThreads; threads++) {
+        double rate = measure(threads, clients, messagesPerClient);
+        if (rate < 0) {
+            std::cerr << "can't run with " << threads << " threads\n";
+            return 1;
+        }
+        std::cout << threads << "        " << rate / 1e6 << "\n";
+    }
+    return 0;
+}
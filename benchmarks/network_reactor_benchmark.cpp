@@ -0,0 +1,73 @@
+#include "../src/network_reactor/network_reactor.hpp"
+#include <chrono>
+#include <cstring>
+#include <iostream>
+#include <string>
+#include <sys/resource.h>
+#include <thread>
+#include <vector>
+
+/**
+ * one reactor thread reading delimited messages from many socketpairs, fed by one writer thread.
+ * usage: network_reactor_benchmark [connections] [messages per connection] [message size]
+ */
+int main(int argc, char *argv[]) {
+    size_t connections = argc > 1 ? std::stoul(argv[1]) : 1000;
+    size_t messagesPerConnection = argc > 2 ? std::stoul(argv[2]) : 1000;
+    size_t messageSize = argc > 3 ? std::stoul(argv[3]) : 32;
+    // messages written per write call, like a client pipelining commands
+    const size_t batchSize = 16;
+
+    rlimit limit;
+    if (getrlimit(RLIMIT_NOFILE, &limit) == 0) {
+        limit.rlim_cur = limit.rlim_max;
+        setrlimit(RLIMIT_NOFILE, &limit);
+    }
+
+    NetworkReactor reactor = NetworkReactor(4096);
+    std::vector<int> writers;
+    size_t received = 0;
+    size_t total = connections * messagesPerConnection;
+
+    for (size_t i = 0; i < connections; i++) {
+        int sockets[2];
+        if (socketpair(AF_UNIX, SOCK_STREAM, 0, sockets) != 0) {
+            perror("socketpair");
+            return 1;
+        }
+        if (reactor.addDelimited(sockets[0], "\n", [&received, &reactor, total](int, std::string_view) {
+                if (++received == total) reactor.stop();
+            })) {
+            std::cerr << "can't register socket\n";
+            return 1;
+        }
+        writers.push_back(sockets[1]);
+    }
+
+    std::string batch;
+    for (size_t i = 0; i < batchSize; i++) {
+        batch += std::string(messageSize - 1, 'x') + "\n";
+    }
+
+    auto start = std::chrono::steady_clock::now();
+    std::thread writeThread([&writers, &batch, messagesPerConnection, batchSize] {
+        for (size_t sent = 0; sent < messagesPerConnection; sent += batchSize) {
+            size_t length = std::min(batchSize, messagesPerConnection - sent) * (batch.size() / batchSize);
+            for (int socket : writers) {
+                if (write(socket, batch.data(), length) != static_cast<ssize_t>(length)) perror("write");
+            }
+        }
+    });
+
+    reactor.run();
+    std::chrono::duration<double> elapsed = std::chrono::steady_clock::now() - start;
+    writeThread.join();
+
+    for (int socket : writers) {
+        close(socket);
+    }
+
+    std::cout << connections << " connections, " << total << " messages of " << messageSize << " bytes in " << elapsed.count() << " s\n";
+    std::cout << total / elapsed.count() / 1e6 << " M messages/s, " << total * messageSize / elapsed.count() / 1e6 << " MB/s\n";
+    return 0;
+}
@@ -0,0 +1,170 @@
+#include "../src/network_input_handler/network_input_handler.hpp"
+#include "benchmark_helpers.hpp"
+#include <chrono>
+#include <fstream>
+#include <iostream>
+#include <string>
+#include <thread>
+#include <unistd.h>
+#include <vector>
+
+/**
+ * throughput of read and readUntilDelimiter over a socket pair and loopback TCP, for every buffer size and message size.
+ * readAllUntilDelimiter is measured apart with the delimiter density as its own axis: each recv takes a fixed size
+ * (16 KiB, the buffer size) holding from 1 to 1024 delimiters.
+ * the results are written as JSON to track them between commits.
+ * usage: read_benchmark [output file, - for stdout] [total bytes per case] [label, like a commit hash]
+ */
+namespace {
+    enum class Transport { SOCKET_PAIR, TCP_LOOPBACK };
+
+    enum class Mode { READ, READ_UNTIL_DELIMITER, READ_ALL_UNTIL_DELIMITER };
+
+    const char *modeName(Mode mode) {
+        switch (mode) {
+        case Mode::READ:
+            return "read";
+        case Mode::READ_UNTIL_DELIMITER:
+            return "readUntilDelimiter";
+        default:
+            return "readAllUntilDelimiter";
+        }
+    }
+
+    struct Result {
+        Transport transport;
+        Mode mode;
+        size_t bufferSize;
+        size_t messageSize;
+        size_t messages;
+        double seconds;
+        NetworkInputStatistics statistics;
+    };
+
+    /**
+     * returns true on error
+     */
+    bool run(Result &result, size_t totalBytes) {
+        int sockets[2];
+        if (result.transport == Transport::SOCKET_PAIR ? socketpair(AF_UNIX, SOCK_STREAM, 0, sockets) != 0 : benchmarkHelpers::createTcpPair(sockets)) {
+            perror("can't create sockets");
+            return true;
+        }
+
+        // the writer sends chunks of about 64 KiB of whole messages, the last byte of each message is the delimiter
+        std::string message(result.messageSize - 1, 'x');
+        message += '\n';
+        std::string chunk;
+        while (chunk.size() < 64 * 1024 || chunk.empty()) {
+            chunk += message;
+        }
+        size_t messagesPerChunk = chunk.size() / result.messageSize;
+        size_t chunks = std::max<size_t>(1, totalBytes / chunk.size());
+        std::thread writeThread([&] {
+            for (size_t i = 0; i < chunks; i++) {
+                for (size_t sent = 0; sent < chunk.size();) {
+                    ssize_t written = write(sockets[1], chunk.data() + sent, chunk.size() - sent);
+                    if (written <= 0) {
+                        perror("write");
+                        return;
+                    }
+                    sent += written;
+                }
+            }
+            shutdown(sockets[1], SHUT_WR);
+        });
+
+        NetworkInputHandler inputHandler(sockets[0], result.bufferSize);
+        std::string out;
+        result.messages = 0;
+        auto start = std::chrono::steady_clock::now();
+        NetworkInputHandler::BatchCallback countMessage = [&result](std::string_view) {
+            result.messages++;
+            return true;
+        };
+        while (result.messages < chunks * messagesPerChunk) {
+            int errorCode;
+            if (result.mode == Mode::READ_ALL_UNTIL_DELIMITER) errorCode = inputHandler.readAllUntilDelimiter("\n", countMessage);
+            else {
+                errorCode = result.mode == Mode::READ ? inputHandler.read(result.messageSize, out) : inputHandler.readUntilDelimiter('\n', out, false, true);
+                if (errorCode == 0) result.messages++;
+            }
+            // 1 is also returned when only part of a message has been received yet
+            if (errorCode != 0 && errorCode != 1) break;
+        }
+        std::chrono::duration<double> elapsed = std::chrono::steady_clock::now() - start;
+        writeThread.join();
+        close(sockets[0]);
+        close(sockets[1]);
+        result.seconds = elapsed.count();
+        result.statistics = inputHandler.statistics();
+        return result.messages != chunks * messagesPerChunk;
+    }
+
+    void writeJson(std::ostream &out, const std::string &label, size_t totalBytes, const std::vector<Result> &results) {
+        out << "{\n  \"benchmark\": \"read\",\n  \"label\": \"" << label << "\",\n  \"bytesPerCase\": " << totalBytes << ",\n  \"results\": [";
+        for (size_t i = 0; i < results.size(); i++) {
+            const Result &result = results[i];
+            double bytes = static_cast<double>(result.messages * result.messageSize);
+            out << (i ? "," : "") << "\n    {\"transport\": \"" << (result.transport == Transport::SOCKET_PAIR ? "socketpair" : "tcp_loopback")
+                << "\", \"mode\": \"" << modeName(result.mode) << "\", \"bufferSize\": " << result.bufferSize
+                << ", \"messageSize\": " << result.messageSize;
+            // a fixed-length read doesn't look for delimiters
+            if (result.mode != Mode::READ) out << ", \"delimitersPerRead\": " << static_cast<double>(result.bufferSize) / result.messageSize;
+            out << ", \"messages\": " << result.messages << ", \"seconds\": " << result.seconds
+                << ", \"messagesPerSecond\": " << result.messages / result.seconds << ", \"megabytesPerSecond\": " << bytes / result.seconds / 1e6
+                << ", \"syscallsPerMessage\": " << static_cast<double>(result.statistics.syscalls) / result.messages
+                << ", \"copiedBytesPerByte\": " << static_cast<double>(result.statistics.bytesCopied) / bytes << "}";
+        }
+        out << "\n  ]\n}\n";
+    }
+} // namespace
+
+int main(int argc, char *argv[]) {
+    std::string outputPath = argc > 1 ? argv[1] : "-";
+    size_t totalBytes = argc > 2 ? std::stoul(argv[2]) : 32 << 20;
+    std::string label = argc > 3 ? argv[3] : "";
+    const size_t bufferSizes[] = {1024, 16 * 1024, 64 * 1024};
+    const size_t messageSizes[] = {16, 256, 4096};
+
+    const size_t delimitersPerRead[] = {1, 16, 256, 1024};
+    const size_t densityBufferSize = 16 * 1024;
+
+    std::vector<Result> results;
+    bool failed = false;
+    auto runCase = [&](Transport transport, Mode mode, size_t bufferSize, size_t messageSize) {
+        Result result = {transport, mode, bufferSize, messageSize, 0, 0, {}};
+        if (run(result, totalBytes)) {
+            std::cerr << "case stopped after " << result.messages << " messages\n";
+            failed = true;
+        }
+        std::cerr << (transport == Transport::SOCKET_PAIR ? "socketpair   " : "tcp_loopback ") << modeName(mode) << " " << bufferSize << " / "
+                  << messageSize << ": " << result.messages * messageSize / result.seconds / 1e6 << " MB/s\n";
+        results.push_back(result);
+    };
+    for (Transport transport : {Transport::SOCKET_PAIR, Transport::TCP_LOOPBACK}) {
+        for (Mode mode : {Mode::READ, Mode::READ_UNTIL_DELIMITER}) {
+            for (size_t bufferSize : bufferSizes) {
+                for (size_t messageSize : messageSizes) {
+                    runCase(transport, mode, bufferSize, messageSize);
+                }
+            }
+        }
+        for (size_t delimiters : delimitersPerRead) {
+            runCase(transport, Mode::READ_ALL_UNTIL_DELIMITER, densityBufferSize, densityBufferSize / delimiters);
+        }
+    }
+
+    if (outputPath == "-") {
+        writeJson(std::cout, label, totalBytes, results);
+    }
+    else {
+        std::ofstream file(outputPath);
+        writeJson(file, label, totalBytes, results);
+        if (!file) {
+            std::cerr << "can't write " << outputPath << "\n";
+            return 1;
+        }
+    }
+    return failed;
+}
@@ -0,0 +1,89 @@
+#include "../src/network_input_handler/network_input_handler.hpp"
+#include <chrono>
+#include <iostream>
+#include <random>
+#include <string>
+#include <thread>
+#include <unistd.h>
+
+/**
+ * replays a capture through readUntilDelimiter, at full speed (throughput) or at the recorded pacing (latency).
+ * without capture file, a capture of lines of random sizes is recorded from a socket pair first.
+ * usage: replay_benchmark [capture file, empty to record one] [delimiter, empty for \n] [paced (0 or 1)] [repetitions]
+ */
+namespace {
+    /**
+     * returns true on error
+     */
+    bool recordCapture(const std::string &path, size_t totalBytes) {
+        int sockets[2];
+        if (socketpair(AF_UNIX, SOCK_STREAM, 0, sockets) != 0) {
+            perror("can't create socket pair");
+            return true;
+        }
+        std::thread writeThread([&] {
+            std::mt19937 random(42);
+            std::uniform_int_distribution<size_t> lineSize(8, 512);
+            std::string chunk;
+            for (size_t sent = 0; sent < totalBytes;) {
+                chunk.clear();
+                while (chunk.size() < 16 * 1024) {
+                    chunk.append(lineSize(random), 'x');
+                    chunk += '\n';
+                }
+                if (write(sockets[1], chunk.data(), chunk.size()) != static_cast<ssize_t>(chunk.size())) break;
+                sent += chunk.size();
+            }
+            shutdown(sockets[1], SHUT_WR);
+        });
+
+        CaptureWriter capture(path);
+        NetworkInputHandler inputHandler(sockets[0], 64 * 1024);
+        inputHandler.setCapture(&capture);
+        std::string_view message;
+        while (inputHandler.readUntilDelimiterView('\n', message, false, true) != 2) {
+        }
+        writeThread.join();
+        close(sockets[0]);
+        close(sockets[1]);
+        std::cerr << "recorded " << capture.recordsCount() << " chunks in " << path << "\n";
+        return capture.flush();
+    }
+} // namespace
+
+int main(int argc, char *argv[]) {
+    std::string path = argc > 1 ? argv[1] : "";
+    char delimiter = argc > 2 && argv[2][0] ? argv[2][0] : '\n';
+    bool paced = argc > 3 && std::stoi(argv[3]) != 0;
+    size_t repetitions = argc > 4 ? std::stoul(argv[4]) : 5;
+    bool recorded = path.empty();
+    if (recorded) {
+        path = "/tmp/replay_benchmark_" + std::to_string(getpid());
+        if (recordCapture(path, 256 << 20)) return 1;
+    }
+
+    CaptureFile captureFile(path);
+    if (recorded) std::remove(path.c_str());
+    for (size_t i = 0; i < repetitions; i++) {
+        ReplayInputHandler inputHandler(ReplayTransport(captureFile, paced), 64 * 1024);
+        Histogram messageTime;
+        inputHandler.setLatencyHistograms(nullptr, &messageTime);
+        std::string_view message;
+        size_t messages = 0;
+        size_t bytes = 0;
+        auto start = std::chrono::steady_clock::now();
+        while (true) {
+            int errorCode = inputHandler.readUntilDelimiterView(delimiter, message, false, true, paced);
+            if (errorCode == 2) break;
+            if (errorCode == 0) {
+                messages++;
+                bytes += message.size() + 1;
+            }
+        }
+        std::chrono::duration<double> elapsed = std::chrono::steady_clock::now() - start;
+        std::cout << messages << " messages, " << messages / elapsed.count() / 1e6 << " M messages/s, " << bytes / elapsed.count() / 1e6
+                  << " MB/s, first byte to message p50 " << messageTime.percentile(50) << " ns, p99 " << messageTime.percentile(99) << " ns, max "
+                  << messageTime.max() << " ns\n";
+    }
+    return 0;
+}
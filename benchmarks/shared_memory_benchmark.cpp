@@ -0,0 +1,116 @@
+#include "../src/network_input_handler/network_input_handler.hpp"
+#include <chrono>
+#include <iostream>
+#include <string>
+#include <sys/resource.h>
+#include <sys/socket.h>
+#include <sys/wait.h>
+#include <unistd.h>
+
+/**
+ * fixed-size messages sent by a child process and read with readView, through a shared memory ring or a unix socket pair.
+ * prints the messages per second, the CPU time per message of both processes and the syscalls per message of the reader.
+ * usage: shared_memory_benchmark [bytes per case] [ring capacity]
+ */
+namespace {
+    struct Result {
+        double seconds;
+        double cpuSeconds;
+        size_t readerSyscalls;
+    };
+
+    double cpuSeconds(int who) {
+        rusage usage;
+        getrusage(who, &usage);
+        return usage.ru_utime.tv_sec + usage.ru_stime.tv_sec + (usage.ru_utime.tv_usec + usage.ru_stime.tv_usec) / 1e6;
+    }
+
+    /**
+     * forks a child who sends the messages with writeAll(message, messages) then exits, and reads them with inputHandler.
+     * returns true on error
+     */
+    template <class InputHandler, class WriteAll>
+    bool run(InputHandler &inputHandler, size_t messageSize, size_t messages, const WriteAll &writeAll, Result &result) {
+        double cpuBefore = cpuSeconds(RUSAGE_SELF) + cpuSeconds(RUSAGE_CHILDREN);
+        auto start = std::chrono::steady_clock::now();
+        pid_t child = fork();
+        if (child == -1) return true;
+        if (child == 0) {
+            _exit(writeAll(std::string(messageSize, 'x'), messages) ? 1 : 0);
+        }
+
+        std::string_view message;
+        for (size_t i = 0; i < messages;) {
+            int errorCode = inputHandler.readView(messageSize, message, true);
+            if (errorCode == 0) i++;
+            // part of the message is there, waits for the rest
+            else if (errorCode == 1 && errno == EAGAIN) inputHandler.transport().wait(-1);
+            else return true;
+        }
+        int status;
+        waitpid(child, &status, 0);
+        std::chrono::duration<double> elapsed = std::chrono::steady_clock::now() - start;
+        result = {elapsed.count(), cpuSeconds(RUSAGE_SELF) + cpuSeconds(RUSAGE_CHILDREN) - cpuBefore, inputHandler.syscalls()};
+        return !WIFEXITED(status) || WEXITSTATUS(status) != 0;
+    }
+
+    void print(const char *name, size_t messageSize, size_t messages, const Result &result) {
+        std::cout << name << " " << messageSize << " bytes: " << messages / result.seconds / 1e6 << " M messages/s, "
+                  << result.cpuSeconds / messages * 1e9 << " ns of CPU per message, " << static_cast<double>(result.readerSyscalls) / messages
+                  << " reader syscalls per message\n";
+    }
+} // namespace
+
+int main(int argc, char *argv[]) {
+    size_t totalBytes = argc > 1 ? std::stoul(argv[1]) : 256 << 20;
+    size_t capacity = argc > 2 ? std::stoul(argv[2]) : 1 << 20;
+
+    for (size_t messageSize : {64, 4096}) {
+        size_t messages = totalBytes / messageSize;
+        Result result;
+        {
+            SharedMemoryRing ring(capacity);
+            SharedMemoryInputHandler inputHandler(SharedMemoryTransport(ring), 64 * 1024);
+            bool error = run(
+                inputHandler, messageSize, messages,
+                [&ring](const std::string &message, size_t count) {
+                    SharedMemoryWriter writer(ring);
+                    for (size_t i = 0; i < count; i++) {
+                        if (writer.write(message, true) != 0) return true;
+                    }
+                    return false;
+                },
+                result);
+            if (error) {
+                std::cerr << "shared memory ring failed\n";
+                return 1;
+            }
+            print("shared memory ring", messageSize, messages, result);
+        }
+        {
+            int sockets[2];
+            if (socketpair(AF_UNIX, SOCK_STREAM, 0, sockets) != 0) {
+                perror("can't create socket pair");
+                return 1;
+            }
+            NetworkInputHandler inputHandler(sockets[0], 64 * 1024);
+            bool error = run(
+                inputHandler, messageSize, messages,
+                [&sockets](const std::string &message, size_t count) {
+                    for (size_t i = 0; i < count; i++) {
+                        if (write(sockets[1], message.data(), message.size()) != static_cast<ssize_t>(message.size())) return true;
+                    }
+                    return false;
+                },
+                result);
+            close(sockets[0]);
+            close(sockets[1]);
+            if (error) {
+                std::cerr << "socket pair failed\n";
+                return 1;
+            }
+            print("socket pair", messageSize, messages, result);
+        }
+    }
+    return 0;
+}
@@ -0,0 +1,115 @@
+#include "../src/network_input_handler/network_input_handler.hpp"
+#include "../src/network_input_handler/slab_pool.hpp"
+#include <chrono>
+#include <fstream>
+#include <iomanip>
+#include <iostream>
+#include <memory>
+#include <sys/wait.h>
+#include <thread>
+#include <unistd.h>
+#include <vector>
+
+/**
+ * resident memory of idle connections who each received one message, with and without a slab pool.
+ * each measure runs in its own process so the memory of one doesn't hide the other.
+ * then borrows and gives back from 1 to 8 threads at the same time: with a core per thread, the throughput of each thread should not drop.
+ * usage: slab_pool_benchmark [connections] [buffer size] [message size]
+ */
+namespace {
+    size_t residentBytes() {
+        std::ifstream statm("/proc/self/statm");
+        size_t pages = 0;
+        size_t residentPages = 0;
+        statm >> pages >> residentPages;
+        return residentPages * sysconf(_SC_PAGESIZE);
+    }
+
+    void run(bool pooled, size_t connections, size_t bufferSize, size_t messageSize) {
+        // both ends of each socket pair are connections, to use one file descriptor per connection
+        std::vector<int> sockets;
+        for (size_t i = 0; i < connections; i += 2) {
+            int pair[2];
+            if (socketpair(AF_UNIX, SOCK_STREAM | SOCK_NONBLOCK, 0, pair) != 0) {
+                perror("can't create socket pair");
+                return;
+            }
+            sockets.push_back(pair[0]);
+            sockets.push_back(pair[1]);
+        }
+        SlabPool pool(2 * bufferSize);
+        std::string message(messageSize, 'x');
+        size_t before = residentBytes();
+
+        std::vector<std::unique_ptr<NetworkInputHandler>> inputHandlers;
+        for (int socket : sockets) {
+            inputHandlers.push_back(std::make_unique<NetworkInputHandler>(socket, bufferSize));
+            if (pooled) inputHandlers.back()->useSlabPool(pool);
+        }
+        for (size_t i = 0; i < sockets.size(); i++) {
+            write(sockets[i ^ 1], message.data(), message.size());
+        }
+        std::string_view received;
+        for (std::unique_ptr<NetworkInputHandler> &inputHandler : inputHandlers) {
+            inputHandler->readView(messageSize, received);
+            // nothing more, the connection is idle
+            inputHandler->readView(messageSize, received);
+        }
+        size_t after = residentBytes();
+
+        std::cout << (pooled ? "slab pool : " : "no pool   : ") << sockets.size() << " idle connections, " << (after - before) / 1024 << " KiB ("
+                  << static_cast<double>(after - before) / sockets.size() << " bytes/connection)";
+        if (pooled) {
+            SlabPool::Statistics statistics = pool.statistics();
+            std::cout << ", slabs: " << statistics.allocatedSlabs << " allocated, " << statistics.borrowedSlabs << " borrowed, "
+                      << statistics.peakBorrowedSlabs << " peak borrowed, " << statistics.borrows << " borrows";
+        }
+        std::cout << "\n";
+        inputHandlers.clear();
+        for (int socket : sockets) {
+            close(socket);
+        }
+    }
+
+    void runThreads(size_t threadsCount, size_t borrowsPerThread) {
+        SlabPool pool(16 * 1024);
+        std::vector<std::thread> threads;
+        auto start = std::chrono::steady_clock::now();
+        for (size_t i = 0; i < threadsCount; i++) {
+            threads.emplace_back([&pool, borrowsPerThread]() {
+                for (size_t j = 0; j < borrowsPerThread; j++) {
+                    char *slab = pool.borrow();
+                    // touches the slab like a recv would
+                    slab[0] = static_cast<char>(j);
+                    pool.giveBack(slab);
+                }
+            });
+        }
+        for (std::thread &thread : threads) {
+            thread.join();
+        }
+        double seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+        SlabPool::Statistics statistics = pool.statistics();
+        std::cout << threadsCount << " threads: " << std::fixed << std::setprecision(1) << borrowsPerThread / seconds / 1e6
+                  << " M borrows/s/thread (" << threadsCount * borrowsPerThread / seconds / 1e6 << " M/s in total), " << statistics.sharedBorrows << " borrows with the mutex of " << statistics.borrows << "\n";
+    }
+} // namespace
+
+int main(int argc, char *argv[]) {
+    size_t connections = argc > 1 ? std::stoul(argv[1]) : 10000;
+    size_t bufferSize = argc > 2 ? std::stoul(argv[2]) : 4096;
+    size_t messageSize = argc > 3 ? std::stoul(argv[3]) : 1024;
+
+    for (bool pooled : {false, true}) {
+        pid_t pid = fork();
+        if (pid == 0) {
+            run(pooled, connections, bufferSize, messageSize);
+            return 0;
+        }
+        waitpid(pid, nullptr, 0);
+    }
+    for (size_t threadsCount : {1, 2, 4, 8}) {
+        runThreads(threadsCount, 10000000);
+    }
+    return 0;
+}
@@ -0,0 +1,33 @@
+#include "../src/network_trace/network_trace.hpp"
+#include <chrono>
+#include <iomanip>
+#include <iostream>
+
+/**
+ * cost of recording an event in the ring of the thread.
+ * usage: trace_benchmark [events]
+ */
+int main(int argc, char *argv[]) {
+    size_t events = argc > 1 ? std::stoul(argv[1]) : 100000000;
+
+    // creates the ring outside of the measure
+    networkTrace::record(networkTrace::Event::RECV, 0, 0);
+    auto start = std::chrono::steady_clock::now();
+    for (size_t i = 0; i < events; i++) {
+        networkTrace::record(networkTrace::Event::RECV, static_cast<int>(i & 1023), i);
+    }
+    std::chrono::duration<double, std::nano> elapsed = std::chrono::steady_clock::now() - start;
+
+    // the timestamp alone, rdtsc can be much slower in a virtual machine than on real hardware
+    uint64_t sum = 0;
+    start = std::chrono::steady_clock::now();
+    for (size_t i = 0; i < events; i++) {
+        sum += networkTrace::ticks();
+    }
+    std::chrono::duration<double, std::nano> timestampElapsed = std::chrono::steady_clock::now() - start;
+    asm volatile("" : : "r"(sum) : "memory");
+
+    std::cout << std::fixed << std::setprecision(2) << elapsed.count() / events << " ns/event, including " << timestampElapsed.count() / events
+              << " ns for the timestamp, " << events << " events\n";
+    return 0;
+}
@@ -0,0 +1,99 @@
+#include "../src/histogram/histogram.hpp"
+#include "../src/network_input_handler/network_input_handler.hpp"
+#include "benchmark_helpers.hpp"
+#include <chrono>
+#include <cstring>
+#include <fcntl.h>
+#include <iostream>
+#include <string>
+#include <sys/epoll.h>
+#include <thread>
+#include <unistd.h>
+
+/**
+ * fixed-size frames sent over loopback TCP in several segments, read from an edge-triggered epoll loop (like NetworkReactor).
+ * compares the epoll wakeups per frame and the latency (last segment sent to frame read) with SO_RCVLOWAT and SO_BUSY_POLL on and off.
+ * busy polling only acts on devices with NAPI, so it is not expected to change much on loopback.
+ * usage: wakeup_benchmark [frames] [frame size] [segments per frame] [microseconds between segments]
+ */
+namespace {
+    void spinFor(std::chrono::microseconds duration) {
+        auto until = std::chrono::steady_clock::now() + duration;
+        while (std::chrono::steady_clock::now() < until) {
+        }
+    }
+
+    void run(bool lowWatermark, bool busyPoll, size_t frames, size_t frameSize, size_t segments, std::chrono::microseconds gap) {
+        int sockets[2];
+        if (benchmarkHelpers::createTcpPair(sockets, true)) {
+            perror("can't create tcp sockets");
+            return;
+        }
+        NetworkInputHandler inputHandler(sockets[0], 64 * 1024);
+        if (lowWatermark && inputHandler.useReceiveLowWatermark()) std::cerr << "can't use SO_RCVLOWAT\n";
+        if (busyPoll && inputHandler.setBusyPoll(50)) std::cerr << "can't use SO_BUSY_POLL (" << strerror(errno) << ")\n";
+        int epoll = epoll_create1(0);
+        epoll_event event = {};
+        event.events = EPOLLIN | EPOLLET;
+        event.data.fd = sockets[0];
+        epoll_ctl(epoll, EPOLL_CTL_ADD, sockets[0], &event);
+
+        std::thread writeThread([&] {
+            std::string frame(frameSize, 'x');
+            size_t segmentSize = frameSize / segments;
+            for (size_t i = 0; i < frames; i++) {
+                for (size_t segment = 0; segment < segments; segment++) {
+                    size_t begin = segment * segmentSize;
+                    size_t end = segment + 1 == segments ? frameSize : begin + segmentSize;
+                    if (segment + 1 == segments) {
+                        // the frame ends with the time its last segment is sent
+                        int64_t now = std::chrono::steady_clock::now().time_since_epoch().count();
+                        std::memcpy(frame.data() + frameSize - sizeof(now), &now, sizeof(now));
+                    }
+                    if (write(sockets[1], frame.data() + begin, end - begin) != static_cast<ssize_t>(end - begin)) perror("write");
+                    spinFor(gap);
+                }
+                spinFor(gap * 4);
+            }
+        });
+
+        Histogram latency;
+        size_t received = 0;
+        size_t wakeups = 0;
+        std::string_view message;
+        while (received < frames) {
+            if (epoll_wait(epoll, &event, 1, 1000) <= 0) break;
+            wakeups++;
+            while (inputHandler.readView(frameSize, message) == 0) {
+                int64_t sent;
+                std::memcpy(&sent, message.data() + frameSize - sizeof(sent), sizeof(sent));
+                latency.record(std::chrono::steady_clock::now().time_since_epoch().count() - sent);
+                received++;
+            }
+        }
+        writeThread.join();
+        close(epoll);
+        close(sockets[0]);
+        close(sockets[1]);
+
+        std::cout << "SO_RCVLOWAT " << (lowWatermark ? "on " : "off") << ", SO_BUSY_POLL " << (busyPoll ? "on " : "off") << ": " << received << " frames, "
+                  << static_cast<double>(wakeups) / received << " wakeups/frame, "
+                  << static_cast<double>(inputHandler.syscalls()) / received << " handler syscalls/frame, latency p50 "
+                  << latency.percentile(50) / 1000.0 << " us, p99 " << latency.percentile(99) / 1000.0 << " us, p99.9 "
+                  << latency.percentile(99.9) / 1000.0 << " us\n";
+    }
+} // namespace
+
+int main(int argc, char *argv[]) {
+    size_t frames = argc > 1 ? std::stoul(argv[1]) : 5000;
+    size_t frameSize = argc > 2 ? std::stoul(argv[2]) : 16 * 1024;
+    size_t segments = argc > 3 ? std::stoul(argv[3]) : 4;
+    std::chrono::microseconds gap(argc > 4 ? std::stoul(argv[4]) : 20);
+
+    for (bool lowWatermark : {false, true}) {
+        for (bool busyPoll : {false, true}) {
+            run(lowWatermark, busyPoll, frames, frameSize, segments, gap);
+        }
+    }
+    return 0;
+}
@@ -0,0 +1,39 @@
+#include "histogram.hpp"
+
+uint64_t Histogram::bucketLowest(size_t index) {
+    if (index < SUB_BUCKETS) return index;
+    size_t shift = (index - SUB_BUCKETS) / SUB_BUCKETS;
+    uint64_t subBucket = (index - SUB_BUCKETS) % SUB_BUCKETS;
+    return (SUB_BUCKETS | subBucket) << shift;
+}
+
+uint64_t Histogram::bucketHighest(size_t index) {
+    if (index < SUB_BUCKETS) return index;
+    size_t shift = (index - SUB_BUCKETS) / SUB_BUCKETS;
+    return bucketLowest(index) + ((uint64_t(1) << shift) - 1);
+}
+
+void Histogram::merge(const Histogram &other) {
+    for (size_t i = 0; i < BUCKETS; i++) {
+        _counts[i] += other._counts[i];
+    }
+    _count += other._count;
+    _min = std::min(_min, other._min);
+    _max = std::max(_max, other._max);
+    _sum += other._sum;
+}
+
+void Histogram::reset() { *this = Histogram(); }
+
+uint64_t Histogram::percentile(double percentile) const {
+    if (_count == 0) return 0;
+    percentile = std::clamp(percentile, 0.0, 100.0);
+    // rank of the value, at least the first one
+    uint64_t rank = std::max<uint64_t>(1, static_cast<uint64_t>(percentile / 100 * _count + 0.5));
+    uint64_t seen = 0;
+    for (size_t i = 0; i < BUCKETS; i++) {
+        seen += _counts[i];
+        if (seen >= rank) return std::clamp(bucketHighest(i), min(), _max);
+    }
+    return _max;
+}
@@ -0,0 +1,80 @@
+#ifndef HISTOGRAM_HPP
+#define HISTOGRAM_HPP
+
+#include <algorithm>
+#include <array>
+#include <cstdint>
+#include <limits>
+
+/**
+ * log-bucketed histogram of unsigned 64 bits values (like HdrHistogram): each power of two is split into 32 linear buckets,
+ * so a value is known with a relative error of at most 1/32 (exactly below 32).
+ * the buckets are a fixed array, recording never allocates.
+ * not thread safe: each thread records into its own histogram, merged into another one to read them together
+ */
+class Histogram {
+public:
+    static constexpr unsigned SUB_BUCKET_BITS = 5;
+    static constexpr uint64_t SUB_BUCKETS = uint64_t(1) << SUB_BUCKET_BITS;
+    static constexpr size_t BUCKETS = SUB_BUCKETS + (64 - SUB_BUCKET_BITS) * SUB_BUCKETS;
+
+private:
+    std::array<uint64_t, BUCKETS> _counts = {};
+    uint64_t _count = 0;
+    uint64_t _min = std::numeric_limits<uint64_t>::max();
+    uint64_t _max = 0;
+    // may wrap for huge totals, only used for the mean
+    uint64_t _sum = 0;
+
+public:
+    static size_t bucketIndex(uint64_t value) {
+        if (value < SUB_BUCKETS) return value;
+        unsigned exponent = 63 - __builtin_clzll(value);
+        unsigned shift = exponent - SUB_BUCKET_BITS;
+        return SUB_BUCKETS + shift * SUB_BUCKETS + ((value >> shift) & (SUB_BUCKETS - 1));
+    }
+
+    /**
+     * smallest value of the bucket
+     */
+    static uint64_t bucketLowest(size_t index);
+
+    /**
+     * highest value of the bucket
+     */
+    static uint64_t bucketHighest(size_t index);
+
+    void record(uint64_t value) {
+        _counts[bucketIndex(value)]++;
+        _count++;
+        _min = std::min(_min, value);
+        _max = std::max(_max, value);
+        _sum += value;
+    }
+
+    /**
+     * adds the values of other
+     */
+    void merge(const Histogram &other);
+
+    void reset();
+
+    uint64_t count() const { return _count; }
+
+    /**
+     * 0 if empty
+     */
+    uint64_t min() const { return _count ? _min : 0; }
+
+    uint64_t max() const { return _max; }
+
+    double mean() const { return _count ? static_cast<double>(_sum) / _count : 0; }
+
+    /**
+     * value below which percentile % of the values are (highest value of its bucket, at most max).
+     * percentile is clamped between 0 and 100, 0 if empty
+     */
+    uint64_t percentile(double percentile) const;
+};
+
+#endif // HISTOGRAM_HPP
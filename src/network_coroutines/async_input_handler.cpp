@@ -0,0 +1,23 @@
+#include "async_input_handler.hpp"
+
+AsyncInputHandler::AsyncInputHandler(CoroutineScheduler &scheduler, int socket, size_t bufferSize)
+    : _scheduler{scheduler}, _socket{socket}, _inputHandler{socket, bufferSize} {
+    int flags = fcntl(socket, F_GETFL, 0);
+    if (flags == -1 || fcntl(socket, F_SETFL, flags | O_NONBLOCK) == -1) throw std::runtime_error("can't make the socket non-blocking");
+}
+
+AsyncInputHandler::ReadAwaitable AsyncInputHandler::readUntil(std::string_view delimiter, bool includeDelimiter) {
+    if (delimiter.empty()) throw std::invalid_argument("delimiter should not be empty");
+    return ReadAwaitable(*this, 0, delimiter, includeDelimiter);
+}
+
+bool AsyncInputHandler::ReadAwaitable::tryComplete() {
+    std::string_view message;
+    // errno is left to 0 when recv received less than asked without the whole message
+    errno = 0;
+    int errorCode = _delimiter.empty() ? _input._inputHandler.readView(_length, message)
+                                       : _input._inputHandler.readUntilDelimiterView(_delimiter, message, _includeDelimiter, true);
+    if (errorCode == 1 && (errno == 0 || errno == EAGAIN || errno == EWOULDBLOCK)) return false;
+    _result = {errorCode, message};
+    return true;
+}
@@ -0,0 +1,71 @@
+#ifndef ASYNC_INPUT_HANDLER_HPP
+#define ASYNC_INPUT_HANDLER_HPP
+
+#include "../network_input_handler/network_input_handler.hpp"
+#include "coroutine_scheduler.hpp"
+#include <fcntl.h>
+#include <string>
+#include <string_view>
+
+/**
+ * errorCode is the value returned by NetworkInputHandler::readView or readUntilDelimiterView, never 1 for incomplete messages.
+ * message is only valid until the next read of the handler
+ */
+struct AsyncReadResult {
+    int errorCode;
+    std::string_view message;
+};
+
+/**
+ * NetworkInputHandler for coroutine sessions: `auto [errorCode, header] = co_await input.read(4);`
+ * suspends the session until the whole message is received instead of returning an error.
+ * the socket is made non-blocking
+ */
+class AsyncInputHandler {
+public:
+    class ReadAwaitable : public CoroutineScheduler::Waiter {
+    private:
+        AsyncInputHandler &_input;
+        // fixed length read if the delimiter is empty
+        size_t _length;
+        std::string _delimiter;
+        bool _includeDelimiter;
+        AsyncReadResult _result = {1, {}};
+
+    public:
+        ReadAwaitable(AsyncInputHandler &input, size_t length, std::string_view delimiter, bool includeDelimiter)
+            : _input{input}, _length{length}, _delimiter{delimiter}, _includeDelimiter{includeDelimiter} {}
+
+        bool tryComplete() override;
+        void fail() override { _result = {1, {}}; }
+
+        bool await_ready() { return tryComplete(); }
+        void await_suspend(std::coroutine_handle<> handle) { _input._scheduler.wait(*this, _input._socket, handle); }
+        AsyncReadResult await_resume() { return _result; }
+    };
+
+private:
+    CoroutineScheduler &_scheduler;
+    int _socket;
+    NetworkInputHandler _inputHandler;
+
+public:
+    /**
+     * throws std::runtime_error if the socket can't be made non-blocking
+     */
+    AsyncInputHandler(CoroutineScheduler &scheduler, int socket, size_t bufferSize = 1024);
+
+    ReadAwaitable read(size_t length) { return ReadAwaitable(*this, length, "", false); }
+
+    /**
+     * the delimiter is always consumed, and only given with the message if includeDelimiter is true.
+     * throws std::invalid_argument if delimiter is empty
+     */
+    ReadAwaitable readUntil(std::string_view delimiter, bool includeDelimiter = false);
+
+    ReadAwaitable readUntil(char delimiter, bool includeDelimiter = false) { return readUntil(std::string_view(&delimiter, 1), includeDelimiter); }
+
+    NetworkInputHandler &inputHandler() { return _inputHandler; }
+};
+
+#endif // ASYNC_INPUT_HANDLER_HPP
@@ -0,0 +1,90 @@
+#include "coroutine_scheduler.hpp"
+
+CoroutineScheduler::Task::promise_type::~promise_type() {
+    if (scheduler) scheduler->_sessions.erase(std::coroutine_handle<promise_type>::from_promise(*this).address());
+}
+
+CoroutineScheduler::Task::~Task() {
+    // never spawned
+    if (_handle) _handle.destroy();
+}
+
+CoroutineScheduler::CoroutineScheduler(size_t maxEvents) : _epoll{epoll_create1(EPOLL_CLOEXEC)}, _maxEvents{maxEvents} {
+    if (_maxEvents <= 0) {
+        if (_epoll != -1) close(_epoll);
+        throw std::invalid_argument("max events should be greater than 0");
+    }
+    if (_epoll == -1) throw std::runtime_error("can't create epoll instance");
+    _events.resize(_maxEvents);
+}
+
+CoroutineScheduler::~CoroutineScheduler() {
+    // the destruction of a frame removes it from _sessions
+    std::vector<void *> sessions(_sessions.begin(), _sessions.end());
+    for (void *session : sessions) {
+        std::coroutine_handle<>::from_address(session).destroy();
+    }
+    close(_epoll);
+}
+
+void CoroutineScheduler::spawn(Task task) {
+    std::coroutine_handle<Task::promise_type> handle = task._handle;
+    task._handle = nullptr;
+    handle.promise().scheduler = this;
+    _sessions.insert(handle.address());
+    _ready.push_back(handle);
+}
+
+void CoroutineScheduler::wait(Waiter &waiter, int socket, std::coroutine_handle<> handle) {
+    waiter._socket = socket;
+    waiter._handle = handle;
+    epoll_event event = {};
+    event.events = EPOLLIN | EPOLLRDHUP | EPOLLONESHOT;
+    event.data.ptr = &waiter;
+    // the socket stays registered between waits, and is removed by the kernel when closed
+    if (epoll_ctl(_epoll, EPOLL_CTL_MOD, socket, &event) == -1 && (errno != ENOENT || epoll_ctl(_epoll, EPOLL_CTL_ADD, socket, &event) == -1)) {
+        NETWORK_TRACE_EVENT(WATCH_ERROR, socket, errno);
+        waiter.fail();
+        _ready.push_back(handle);
+    }
+}
+
+size_t CoroutineScheduler::resumeReady() {
+    size_t resumed = 0;
+    // sessions made ready while resuming are kept for the next call
+    for (size_t count = _ready.size(); count > 0 && !_stopped; count--) {
+        std::coroutine_handle<> handle = _ready.front();
+        _ready.pop_front();
+        handle.resume();
+        resumed++;
+    }
+    return resumed;
+}
+
+int CoroutineScheduler::runOnce(int timeout) {
+    int resumed = resumeReady();
+    // nothing left to wait for once every session ended
+    if (_stopped || _sessions.empty()) return resumed;
+
+    int eventsCount = epoll_wait(_epoll, _events.data(), _maxEvents, _ready.empty() ? timeout : 0);
+    if (eventsCount == -1) return errno == EINTR ? resumed : -1;
+    for (int i = 0; i < eventsCount; i++) {
+        Waiter *waiter = static_cast<Waiter *>(_events[i].data.ptr);
+        if (waiter->tryComplete()) {
+            _ready.push_back(waiter->_handle);
+        }
+        else {
+            // not enough bytes yet, watches the socket again
+            wait(*waiter, waiter->_socket, waiter->_handle);
+        }
+    }
+    return resumed + resumeReady();
+}
+
+void CoroutineScheduler::run() {
+    while (!_sessions.empty() && !_stopped) {
+        if (runOnce(-1) == -1) break;
+    }
+    // reset once run returns, a stop called before run is not lost
+    _stopped = false;
+}
@@ -0,0 +1,129 @@
+#ifndef COROUTINE_SCHEDULER_HPP
+#define COROUTINE_SCHEDULER_HPP
+
+#include "../network_trace/network_trace.hpp"
+#include <coroutine>
+#include <deque>
+#include <exception>
+#include <stdexcept>
+#include <sys/epoll.h>
+#include <unistd.h>
+#include <unordered_set>
+#include <vector>
+
+/**
+ * runs coroutine sessions on one thread: a session waiting for a socket is suspended
+ * and resumed when epoll tells the socket is readable.
+ * every function must be called from the thread running the scheduler
+ */
+class CoroutineScheduler {
+public:
+    /**
+     * coroutine type of a session, started by spawn.
+     * an exception escaping a session terminates the program
+     */
+    class Task {
+    public:
+        struct promise_type {
+            CoroutineScheduler *scheduler = nullptr;
+
+            Task get_return_object() { return Task(std::coroutine_handle<promise_type>::from_promise(*this)); }
+            std::suspend_always initial_suspend() noexcept { return {}; }
+            // the frame is destroyed as soon as the session ends
+            std::suspend_never final_suspend() noexcept { return {}; }
+            void return_void() {}
+            void unhandled_exception() { std::terminate(); }
+            ~promise_type();
+        };
+
+        Task(Task &&other) noexcept : _handle{other._handle} { other._handle = nullptr; }
+        Task(const Task &) = delete;
+        Task &operator=(const Task &) = delete;
+        ~Task();
+
+    private:
+        std::coroutine_handle<promise_type> _handle;
+
+        explicit Task(std::coroutine_handle<promise_type> handle) : _handle{handle} {}
+
+        friend class CoroutineScheduler;
+    };
+
+    /**
+     * awaiter waiting for a socket to be readable
+     */
+    class Waiter {
+    public:
+        virtual ~Waiter() = default;
+
+        /**
+         * called each time the socket is readable, the coroutine is resumed once it returns true
+         */
+        virtual bool tryComplete() = 0;
+
+        /**
+         * called instead of tryComplete if the socket can't be watched, the coroutine is resumed right after
+         */
+        virtual void fail() = 0;
+
+    protected:
+        int _socket = -1;
+        std::coroutine_handle<> _handle = nullptr;
+
+        friend class CoroutineScheduler;
+    };
+
+private:
+    int _epoll;
+    size_t _maxEvents;
+    std::vector<epoll_event> _events;
+    std::deque<std::coroutine_handle<>> _ready;
+    // every session not finished yet, destroyed with the scheduler
+    std::unordered_set<void *> _sessions;
+    bool _stopped = false;
+
+    /**
+     * resumes the sessions ready to continue, returns how many were resumed
+     */
+    size_t resumeReady();
+
+public:
+    /**
+     * throws std::invalid_argument if maxEvents is 0, std::runtime_error if epoll can't be created
+     */
+    CoroutineScheduler(size_t maxEvents = 256);
+    ~CoroutineScheduler();
+
+    CoroutineScheduler(const CoroutineScheduler &) = delete;
+    CoroutineScheduler &operator=(const CoroutineScheduler &) = delete;
+
+    /**
+     * the session starts on the next runOnce
+     */
+    void spawn(Task task);
+
+    /**
+     * suspends handle until waiter completes (one-shot: the socket is only watched while a session waits for it).
+     * handle is resumed on the next runOnce if the socket can't be watched.
+     * a socket must only be waited on by one session at a time
+     */
+    void wait(Waiter &waiter, int socket, std::coroutine_handle<> handle);
+
+    size_t sessionsCount() const { return _sessions.size(); }
+
+    /**
+     * resumes the ready sessions, then waits at most timeout milliseconds (negative means no timeout) for sockets.
+     * returns the number of sessions resumed, or -1 on error
+     */
+    int runOnce(int timeout = -1);
+
+    /**
+     * runs until every session is finished or stop is called.
+     * returns immediately if stop was called before, the next run is not stopped
+     */
+    void run();
+
+    void stop() { _stopped = true; }
+};
+
+#endif // COROUTINE_SCHEDULER_HPP
@@ -0,0 +1,204 @@
+#include "network_datagram.hpp"
+#include "../network_input_handler/big_endian.hpp"
+#include <algorithm>
+#include <cstring>
+
+namespace {
+    void checkDatagramSize(size_t maxDatagramSize) {
+        if (maxDatagramSize <= networkDatagram::HEADER_SIZE || maxDatagramSize > networkDatagram::MAX_DATAGRAM_SIZE) {
+            throw std::invalid_argument("max datagram size should be between " + std::to_string(networkDatagram::HEADER_SIZE + 1) + " and "
+                                        + std::to_string(networkDatagram::MAX_DATAGRAM_SIZE));
+        }
+    }
+} // namespace
+
+namespace networkDatagram {
+    void Header::encode(char *bytes) const {
+        bigEndian::encode(bytes, sequence, 8);
+        bigEndian::encode(bytes + 8, fragmentIndex, 2);
+        bigEndian::encode(bytes + 10, fragmentsCount, 2);
+        bigEndian::encode(bytes + 12, frameSize, 4);
+    }
+
+    bool Header::decode(const char *bytes, size_t datagramSize) {
+        if (datagramSize < HEADER_SIZE) return true;
+        sequence = bigEndian::decode(bytes, 8);
+        fragmentIndex = bigEndian::decode(bytes + 8, 2);
+        fragmentsCount = bigEndian::decode(bytes + 10, 2);
+        frameSize = bigEndian::decode(bytes + 12, 4);
+        if (sequence == 0 || fragmentsCount == 0 || fragmentIndex >= fragmentsCount) return true;
+        // an empty frame is one empty fragment, otherwise every fragment carries at least a byte
+        if (frameSize == 0) return fragmentsCount != 1 || datagramSize != HEADER_SIZE;
+        size_t offset = fragmentOffset();
+        return offset >= frameSize || datagramSize - HEADER_SIZE != std::min(fragmentCapacity(), frameSize - offset);
+    }
+} // namespace networkDatagram
+
+DatagramSender::DatagramSender(int socket, size_t maxDatagramSize, size_t batchSize)
+    : _socket{socket}, _maxDatagramSize{maxDatagramSize}, _headers(batchSize), _vectors(2 * batchSize), _messages(batchSize) {
+    checkDatagramSize(maxDatagramSize);
+    if (batchSize == 0) throw std::invalid_argument("batch size should be greater than 0");
+}
+
+int DatagramSender::send(std::string_view frame) {
+    size_t payloadSize = _maxDatagramSize - networkDatagram::HEADER_SIZE;
+    size_t fragmentsCount = std::max<size_t>(1, (frame.size() + payloadSize - 1) / payloadSize);
+    if (fragmentsCount > networkDatagram::MAX_FRAGMENTS || frame.size() > UINT32_MAX) return 4;
+
+    networkDatagram::Header header = {_sequence++, 0, static_cast<uint16_t>(fragmentsCount), static_cast<uint32_t>(frame.size())};
+    size_t capacity = header.fragmentCapacity();
+    size_t next = 0;
+    while (next < fragmentsCount) {
+        size_t batch = std::min(_messages.size(), fragmentsCount - next);
+        for (size_t i = 0; i < batch; i++) {
+            header.fragmentIndex = next + i;
+            header.encode(_headers[i].data());
+            size_t offset = header.fragmentOffset();
+            _vectors[2 * i] = {_headers[i].data(), networkDatagram::HEADER_SIZE};
+            _vectors[2 * i + 1] = {const_cast<char *>(frame.data()) + offset, std::min(capacity, frame.size() - offset)};
+            _messages[i] = {};
+            _messages[i].msg_hdr.msg_iov = &_vectors[2 * i];
+            _messages[i].msg_hdr.msg_iovlen = 2;
+        }
+        _syscalls++;
+        int sent = sendmmsg(_socket, _messages.data(), batch, 0);
+        if (sent == -1) {
+            if (errno == EINTR) continue;
+            return 1;
+        }
+        _datagramsSent += sent;
+        next += sent;
+    }
+    return 0;
+}
+
+DatagramReceiver::DatagramReceiver(int socket, size_t maxFrameSize, size_t maxDatagramSize, size_t batchSize)
+    : _socket{socket}, _maxFrameSize{maxFrameSize}, _maxDatagramSize{maxDatagramSize}, _vectors(batchSize), _messages(batchSize) {
+    checkDatagramSize(maxDatagramSize);
+    if (maxFrameSize == 0) throw std::invalid_argument("max frame size should be greater than 0");
+    if (batchSize == 0) throw std::invalid_argument("batch size should be greater than 0");
+    _datagrams = std::make_unique<char[]>(batchSize * (maxDatagramSize + 1));
+    for (size_t i = 0; i < batchSize; i++) {
+        _vectors[i] = {_datagrams.get() + i * (maxDatagramSize + 1), maxDatagramSize + 1};
+        _messages[i].msg_hdr.msg_iov = &_vectors[i];
+        _messages[i].msg_hdr.msg_iovlen = 1;
+    }
+}
+
+void DatagramReceiver::resync() {
+    for (Assembly &assembly : _assemblies) {
+        assembly.used = false;
+    }
+    _lastSequence = 0;
+    _readySequence = 0;
+    _statistics.resyncs++;
+}
+
+void DatagramReceiver::handle(const char *datagram, size_t size) {
+    networkDatagram::Header header;
+    if (header.decode(datagram, size) || header.frameSize > _maxFrameSize) {
+        _statistics.invalidDatagrams++;
+        return;
+    }
+    uint64_t newest = std::max(_lastSequence, _readySequence);
+    if (header.sequence <= newest) {
+        if (newest - header.sequence <= networkDatagram::REORDER_WINDOW) {
+            _statistics.staleDatagrams++;
+            return;
+        }
+        // too late to be reordered: the sender restarted, or the newest sequence was forged
+        resync();
+    }
+
+    Assembly *assembly = nullptr;
+    Assembly *unused = nullptr;
+    Assembly *oldest = nullptr;
+    for (Assembly &candidate : _assemblies) {
+        if (!candidate.used) unused = &candidate;
+        else if (candidate.header.sequence == header.sequence) {
+            assembly = &candidate;
+            break;
+        }
+        else if (!oldest || candidate.header.sequence < oldest->header.sequence) oldest = &candidate;
+    }
+    if (!assembly) {
+        // replaces the oldest incomplete frame if every assembly is used, it is counted as dropped once a newer frame is given
+        assembly = unused ? unused : oldest;
+        if (assembly == oldest && oldest->header.sequence > header.sequence) {
+            _statistics.staleDatagrams++;
+            return;
+        }
+        assembly->used = true;
+        assembly->header = header;
+        assembly->fragmentsReceived = 0;
+        assembly->received.assign(header.fragmentsCount, false);
+        assembly->bytes.resize(header.frameSize);
+    }
+    else if (assembly->header.frameSize != header.frameSize || assembly->header.fragmentsCount != header.fragmentsCount) {
+        _statistics.invalidDatagrams++;
+        return;
+    }
+    if (assembly->received[header.fragmentIndex]) {
+        _statistics.staleDatagrams++;
+        return;
+    }
+
+    std::memcpy(assembly->bytes.data() + header.fragmentOffset(), datagram + networkDatagram::HEADER_SIZE, size - networkDatagram::HEADER_SIZE);
+    assembly->received[header.fragmentIndex] = true;
+    if (++assembly->fragmentsReceived < header.fragmentsCount) return;
+
+    _ready.swap(assembly->bytes);
+    _readySequence = header.sequence;
+    // the older frames can't be given anymore
+    for (Assembly &candidate : _assemblies) {
+        if (candidate.used && candidate.header.sequence <= header.sequence) candidate.used = false;
+    }
+}
+
+bool DatagramReceiver::drain() {
+    while (true) {
+        _statistics.syscalls++;
+        int count = recvmmsg(_socket, _messages.data(), _messages.size(), MSG_DONTWAIT, nullptr);
+        if (count == -1) {
+            if (errno == EINTR) continue;
+            return errno != EAGAIN && errno != EWOULDBLOCK;
+        }
+        for (int i = 0; i < count; i++) {
+            _statistics.datagramsReceived++;
+            if ((_messages[i].msg_hdr.msg_flags & MSG_TRUNC) || _messages[i].msg_len > _maxDatagramSize) _statistics.invalidDatagrams++;
+            else handle(static_cast<const char *>(_vectors[i].iov_base), _messages[i].msg_len);
+        }
+        // a batch not full means the socket is empty, no need for a recvmmsg who would find nothing
+        if (static_cast<size_t>(count) < _messages.size()) return false;
+    }
+}
+
+int DatagramReceiver::receive(std::string_view &frame, bool retryIfNoFrame, int timeout) {
+    std::chrono::steady_clock::time_point deadline = std::chrono::steady_clock::now() + std::chrono::milliseconds(timeout);
+    while (true) {
+        if (drain()) return 1;
+        if (_readySequence > _lastSequence) {
+            if (_lastSequence != 0) _statistics.framesDropped += _readySequence - _lastSequence - 1;
+            _frame.swap(_ready);
+            _lastSequence = _readySequence;
+            _statistics.framesReceived++;
+            frame = _frame;
+            return 0;
+        }
+        if (!retryIfNoFrame) {
+            errno = EAGAIN;
+            return 1;
+        }
+
+        int remaining = -1;
+        if (timeout >= 0) {
+            remaining = std::chrono::ceil<std::chrono::milliseconds>(deadline - std::chrono::steady_clock::now()).count();
+            if (remaining <= 0) return 3;
+        }
+        pollfd pollEvent = {_socket, POLLIN, 0};
+        _statistics.syscalls++;
+        int ready = poll(&pollEvent, 1, remaining);
+        if (ready == 0) return 3;
+        if (ready == -1 && errno != EINTR) return 1;
+    }
+}
@@ -0,0 +1,194 @@
+#ifndef NETWORK_DATAGRAM_HPP
+#define NETWORK_DATAGRAM_HPP
+
+#include <array>
+#include <cerrno>
+#include <chrono>
+#include <cstdint>
+#include <memory>
+#include <poll.h>
+#include <stdexcept>
+#include <string>
+#include <string_view>
+#include <sys/socket.h>
+#include <sys/uio.h>
+#include <vector>
+
+/**
+ * frames (generations of the board for example) sent over UDP, where only the latest state matters:
+ * a lost datagram loses its frame instead of delaying every later frame like a TCP stream would.
+ * a frame is split in datagrams of at most maxDatagramSize bytes, each starting with a header (big-endian):
+ *  - sequence of the frame (8 bytes), increasing from 1
+ *  - index of the fragment and number of fragments of the frame (2 bytes each)
+ *  - size of the frame (4 bytes)
+ * every fragment but the last one carries ceil(frame size / fragments count) bytes, so the receiver doesn't need the sender's datagram size.
+ * the default datagram size fits in an ethernet MTU of 1500 bytes with the IPv4 and UDP headers (use 1452 for IPv6)
+ */
+namespace networkDatagram {
+    const size_t HEADER_SIZE = 16;
+    const size_t DEFAULT_DATAGRAM_SIZE = 1472;
+    // biggest UDP payload over IPv4
+    const size_t MAX_DATAGRAM_SIZE = 65507;
+    const size_t MAX_FRAGMENTS = UINT16_MAX;
+    // frames a datagram can be late by, a sequence further behind the newest one means the sender restarted
+    const uint64_t REORDER_WINDOW = 64;
+
+    struct Header {
+        uint64_t sequence;
+        uint16_t fragmentIndex;
+        uint16_t fragmentsCount;
+        uint32_t frameSize;
+
+        void encode(char *bytes) const;
+
+        /**
+         * returns true if the header is not valid
+         */
+        bool decode(const char *bytes, size_t datagramSize);
+
+        /**
+         * bytes of the frame carried by every fragment but the last one
+         */
+        size_t fragmentCapacity() const { return (frameSize + fragmentsCount - 1) / fragmentsCount; }
+
+        size_t fragmentOffset() const { return fragmentIndex * fragmentCapacity(); }
+    };
+} // namespace networkDatagram
+
+/**
+ * sends frames on a connected UDP socket, the datagrams of a batch of fragments are sent with one sendmmsg
+ */
+class DatagramSender {
+    int _socket;
+    size_t _maxDatagramSize;
+    uint64_t _sequence = 1;
+    size_t _syscalls = 0;
+    size_t _datagramsSent = 0;
+    std::vector<std::array<char, networkDatagram::HEADER_SIZE>> _headers;
+    std::vector<iovec> _vectors;
+    std::vector<mmsghdr> _messages;
+
+public:
+    /**
+     * throws std::invalid_argument if maxDatagramSize can't hold a header and a byte, or is bigger than MAX_DATAGRAM_SIZE
+     */
+    DatagramSender(int socket, size_t maxDatagramSize = networkDatagram::DEFAULT_DATAGRAM_SIZE, size_t batchSize = 64);
+
+    /**
+     * sends frame with the next sequence number, the sequence is used even if the frame is not entirely sent.
+     * returns:
+     *  - 0 if no errors
+     *  - 1 on error, or if the socket is non-blocking and full (errno is EAGAIN), the receiver drops the fragments already sent
+     *  - 4 if frame needs more than MAX_FRAGMENTS datagrams, nothing is sent
+     */
+    int send(std::string_view frame);
+
+    /**
+     * sequence number of the next frame
+     */
+    uint64_t sequence() const { return _sequence; }
+
+    size_t datagramsSent() const { return _datagramsSent; }
+
+    size_t syscalls() const { return _syscalls; }
+};
+
+/**
+ * counters of one DatagramReceiver
+ */
+struct DatagramStatistics {
+    // recvmmsg and poll
+    size_t syscalls = 0;
+    size_t datagramsReceived = 0;
+    // truncated, bad header, or frame bigger than the maximum frame size
+    size_t invalidDatagrams = 0;
+    // fragments of a frame older than the last complete one, or already received
+    size_t staleDatagrams = 0;
+    // sequences more than REORDER_WINDOW behind the newest one, taken as a restart of the sender
+    size_t resyncs = 0;
+    size_t framesReceived = 0;
+    // frames never given between two received frames: lost, incomplete or replaced by a newer complete one
+    size_t framesDropped = 0;
+};
+
+/**
+ * receives frames from a UDP socket, reassembling their fragments.
+ * only the newest complete frame is given: a frame older than one already complete is dropped, even if it completes later.
+ * a sequence more than REORDER_WINDOW frames behind the newest one starts over from it instead of being dropped,
+ * so a restarted sender (or a forged huge sequence) doesn't silence the receiver forever.
+ * a sender restarting less than REORDER_WINDOW frames after its last start loses these first frames
+ */
+class DatagramReceiver {
+    /**
+     * frame being reassembled
+     */
+    struct Assembly {
+        bool used = false;
+        networkDatagram::Header header;
+        size_t fragmentsReceived;
+        std::vector<bool> received;
+        std::string bytes;
+    };
+
+    // frames reassembled at the same time, fragments of reordered frames can be interleaved
+    static const size_t ASSEMBLIES_COUNT = 4;
+
+    int _socket;
+    size_t _maxFrameSize;
+    size_t _maxDatagramSize;
+    std::array<Assembly, ASSEMBLIES_COUNT> _assemblies;
+    // newest complete frame not given yet
+    std::string _ready;
+    uint64_t _readySequence = 0;
+    // the frame given by the last receive, its buffer is kept until the next receive
+    std::string _frame;
+    uint64_t _lastSequence = 0;
+    // received by recvmmsg, one extra byte per datagram to detect the truncated ones
+    std::unique_ptr<char[]> _datagrams;
+    std::vector<iovec> _vectors;
+    std::vector<mmsghdr> _messages;
+    DatagramStatistics _statistics;
+
+    /**
+     * forgets every frame, the next sequence received is the newest one
+     */
+    void resync();
+
+    /**
+     * adds a received datagram to its frame
+     */
+    void handle(const char *datagram, size_t size);
+
+    /**
+     * receives every datagram available without waiting, returns true on error
+     */
+    bool drain();
+
+public:
+    /**
+     * frames bigger than maxFrameSize are dropped.
+     * throws std::invalid_argument if maxFrameSize is 0, or maxDatagramSize can't hold a header and a byte or is bigger than MAX_DATAGRAM_SIZE
+     */
+    DatagramReceiver(int socket, size_t maxFrameSize, size_t maxDatagramSize = networkDatagram::DEFAULT_DATAGRAM_SIZE, size_t batchSize = 32);
+
+    /**
+     * receives every datagram available, then gives the newest complete frame newer than the last one given.
+     * frame is valid until the next call.
+     * if retryIfNoFrame is true, waits (without spinning) until a frame is complete.
+     * timeout is the maximum time to wait in milliseconds, negative means no timeout.
+     * returns:
+     *  - 0 if no errors
+     *  - 1 on error, or if no new frame is complete (errno is EAGAIN)
+     *  - 3 on timeout
+     */
+    int receive(std::string_view &frame, bool retryIfNoFrame = false, int timeout = -1);
+
+    /**
+     * sequence number of the last frame given, 0 if none or if the sender restarted since
+     */
+    uint64_t lastSequence() const { return _lastSequence; }
+
+    const DatagramStatistics &statistics() const { return _statistics; }
+};
+
+#endif // NETWORK_DATAGRAM_HPP
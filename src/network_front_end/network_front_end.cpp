@@ -0,0 +1,114 @@
+#include "network_front_end.hpp"
+
+NetworkFrontEnd::NetworkFrontEnd(const std::string &address, uint16_t port, size_t threadsCount, WorkStealingPool &pool, size_t bufferSize)
+    : _address{address}, _port{port}, _threadsCount{threadsCount}, _bufferSize{bufferSize}, _pool{pool} {
+    if (_threadsCount <= 0) throw std::invalid_argument("threads count should be greater than 0");
+    if (_bufferSize <= 0) throw std::invalid_argument("buffer size should be greater than 0");
+}
+
+NetworkFrontEnd::~NetworkFrontEnd() { stop(); }
+
+void NetworkFrontEnd::setFixedLengthMessages(size_t length, MessageHandler handler) {
+    _length = length;
+    _delimiter = "";
+    _handler = std::make_shared<const MessageHandler>(std::move(handler));
+}
+
+void NetworkFrontEnd::setDelimitedMessages(std::string_view delimiter, MessageHandler handler) {
+    _delimiter = delimiter;
+    _handler = std::make_shared<const MessageHandler>(std::move(handler));
+}
+
+int NetworkFrontEnd::createListener() {
+    sockaddr_in address = {};
+    address.sin_family = AF_INET;
+    address.sin_port = htons(_port);
+    if (inet_pton(AF_INET, _address.c_str(), &address.sin_addr) != 1) return -1;
+
+    int listener = socket(AF_INET, SOCK_STREAM | SOCK_NONBLOCK | SOCK_CLOEXEC, 0);
+    if (listener == -1) return -1;
+    int enabled = 1;
+    if (setsockopt(listener, SOL_SOCKET, SO_REUSEPORT, &enabled, sizeof(enabled)) == -1
+        || setsockopt(listener, SOL_SOCKET, SO_REUSEADDR, &enabled, sizeof(enabled)) == -1
+        || bind(listener, reinterpret_cast<sockaddr *>(&address), sizeof(address)) == -1 || listen(listener, SOMAXCONN) == -1) {
+        close(listener);
+        return -1;
+    }
+    if (_port == 0) {
+        // the next listeners must use the same port
+        socklen_t addressLength = sizeof(address);
+        if (getsockname(listener, reinterpret_cast<sockaddr *>(&address), &addressLength) == -1) {
+            close(listener);
+            return -1;
+        }
+        _port = ntohs(address.sin_port);
+    }
+    return listener;
+}
+
+void NetworkFrontEnd::handleNext(WorkStealingPool &pool, std::shared_ptr<const MessageHandler> handler, std::shared_ptr<Connection> connection,
+                                 int socket) {
+    std::string message;
+    {
+        std::lock_guard<std::mutex> lock(connection->mutex);
+        message = std::move(connection->messages.front());
+        connection->messages.pop_front();
+    }
+    (*handler)(socket, message);
+
+    std::lock_guard<std::mutex> lock(connection->mutex);
+    if (connection->messages.empty()) connection->scheduled = false;
+    else pool.submit([&pool, handler, connection, socket] { handleNext(pool, handler, connection, socket); });
+}
+
+void NetworkFrontEnd::registerConnection(NetworkReactor &reactor, int socket) {
+    NetworkReactor::MessageCallback callback = [this, connection = std::make_shared<Connection>()](int socket, std::string_view message) {
+        // the message only lives during the callback
+        std::lock_guard<std::mutex> lock(connection->mutex);
+        connection->messages.emplace_back(message);
+        // tasks of a connection could run at the same time on different threads, only one is submitted at a time to keep the order
+        if (connection->scheduled) return;
+        connection->scheduled = true;
+        _pool.submit([&pool = _pool, handler = _handler, connection, socket] { handleNext(pool, handler, connection, socket); });
+    };
+    bool error;
+    if (_delimiter.empty()) error = reactor.addFixedLength(socket, _length, std::move(callback));
+    else error = reactor.addDelimited(socket, _delimiter, std::move(callback));
+    if (error) close(socket);
+}
+
+bool NetworkFrontEnd::start() {
+    if (!_handler || !_threads.empty()) return true;
+    if (_delimiter.empty() && _length == 0) return true;
+
+    for (size_t i = 0; i < _threadsCount; i++) {
+        int listener = createListener();
+        if (listener == -1) {
+            _reactors.clear();
+            return true;
+        }
+        _reactors.push_back(std::make_unique<NetworkReactor>(_bufferSize));
+        NetworkReactor *reactor = _reactors.back().get();
+        if (reactor->addListener(listener, [this, reactor](int socket) { registerConnection(*reactor, socket); })) {
+            close(listener);
+            _reactors.clear();
+            return true;
+        }
+    }
+
+    for (const std::unique_ptr<NetworkReactor> &reactor : _reactors) {
+        _threads.emplace_back([reactor = reactor.get()] { reactor->run(); });
+    }
+    return false;
+}
+
+void NetworkFrontEnd::stop() {
+    for (const std::unique_ptr<NetworkReactor> &reactor : _reactors) {
+        reactor->stop();
+    }
+    for (std::thread &thread : _threads) {
+        thread.join();
+    }
+    _threads.clear();
+    _reactors.clear();
+}
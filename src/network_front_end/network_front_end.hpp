@@ -0,0 +1,101 @@
+#ifndef NETWORK_FRONT_END_HPP
+#define NETWORK_FRONT_END_HPP
+
+#include "../network_reactor/network_reactor.hpp"
+#include "../work_stealing_pool/work_stealing_pool.hpp"
+#include <arpa/inet.h>
+#include <deque>
+#include <memory>
+#include <mutex>
+#include <netinet/in.h>
+#include <string>
+#include <thread>
+#include <vector>
+
+/**
+ * tcp server reading messages with several threads.
+ * each thread has its own SO_REUSEPORT listener on the same port and its own NetworkReactor,
+ * so the kernel spreads the connections between the threads.
+ * decoded messages are handled by the tasks of a WorkStealingPool,
+ * one message of a connection at a time and in the order they were received.
+ */
+class NetworkFrontEnd {
+public:
+    /**
+     * socket only identifies the connection, it may already be closed when the message is handled
+     */
+    using MessageHandler = std::function<void(int socket, const std::string &message)>;
+
+private:
+    /**
+     * messages of a connection waiting to be handled, shared by its reactor callback and its task
+     */
+    struct Connection {
+        std::mutex mutex;
+        std::deque<std::string> messages;
+        // a task of the connection is queued or running, the next messages wait for it
+        bool scheduled = false;
+    };
+
+    std::string _address;
+    uint16_t _port;
+    size_t _threadsCount;
+    size_t _bufferSize;
+    WorkStealingPool &_pool;
+    // shared with the queued tasks, which can outlive the front end
+    std::shared_ptr<const MessageHandler> _handler = nullptr;
+    // messages are either of a fixed length, or ends with the delimiter if it is not empty
+    size_t _length = 0;
+    std::string _delimiter = "";
+    std::vector<std::unique_ptr<NetworkReactor>> _reactors;
+    std::vector<std::thread> _threads;
+
+    /**
+     * returns the listening socket, or -1 in case of error
+     */
+    int createListener();
+
+    void registerConnection(NetworkReactor &reactor, int socket);
+
+    /**
+     * handles the oldest message of connection, then submits a task for the next one if any
+     */
+    static void handleNext(WorkStealingPool &pool, std::shared_ptr<const MessageHandler> handler, std::shared_ptr<Connection> connection, int socket);
+
+public:
+    /**
+     * port can be 0 to use any free port, port() gives it after start.
+     * bufferSize is the buffer size of the NetworkInputHandler of each connection
+     */
+    NetworkFrontEnd(const std::string &address, uint16_t port, size_t threadsCount, WorkStealingPool &pool, size_t bufferSize = 1024);
+
+    /**
+     * stops the threads and closes every socket
+     */
+    ~NetworkFrontEnd();
+
+    NetworkFrontEnd(const NetworkFrontEnd &) = delete;
+    NetworkFrontEnd &operator=(const NetworkFrontEnd &) = delete;
+
+    /**
+     * must be called before start
+     */
+    void setFixedLengthMessages(size_t length, MessageHandler handler);
+
+    /**
+     * must be called before start, the delimiter is not given to the handler
+     */
+    void setDelimitedMessages(std::string_view delimiter, MessageHandler handler);
+
+    /**
+     * creates the listeners and starts the threads.
+     * returns true in case of error
+     */
+    bool start();
+
+    void stop();
+
+    uint16_t port() const { return _port; }
+};
+
+#endif // NETWORK_FRONT_END_HPP
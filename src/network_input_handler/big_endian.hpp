@@ -0,0 +1,30 @@
+#ifndef BIG_ENDIAN_HPP
+#define BIG_ENDIAN_HPP
+
+#include <cstddef>
+#include <cstdint>
+
+/**
+ * unsigned integers of 1 to 8 bytes in network byte order, used by the length headers
+ */
+namespace bigEndian {
+    inline uint64_t decode(const char *bytes, size_t size) {
+        uint64_t value = 0;
+        for (size_t i = 0; i < size; i++) {
+            value = (value << 8) | static_cast<unsigned char>(bytes[i]);
+        }
+        return value;
+    }
+
+    /**
+     * writes the size lowest bytes of value
+     */
+    inline void encode(char *bytes, uint64_t value, size_t size) {
+        for (size_t i = size; i > 0; i--) {
+            bytes[i - 1] = static_cast<char>(value & 0xff);
+            value >>= 8;
+        }
+    }
+} // namespace bigEndian
+
+#endif // BIG_ENDIAN_HPP
@@ -0,0 +1,186 @@
+#include "capture.hpp"
+#include <cerrno>
+#include <cstring>
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <thread>
+#include <unistd.h>
+
+namespace {
+    const char MAGIC[4] = {'N', 'C', 'A', 'P'};
+    const uint32_t VERSION = 1;
+    const size_t WRITE_SIZE = 64 * 1024;
+    // nanoseconds (8 bytes) then length (4 bytes)
+    const size_t RECORD_HEADER_SIZE = 12;
+
+    struct FileHeader {
+        char magic[4];
+        uint32_t version;
+        // system clock at the start of the capture, in nanoseconds since the epoch
+        int64_t startTime;
+    };
+
+    /**
+     * returns true on error
+     */
+    bool writeAll(int fd, const char *data, size_t length) {
+        while (length > 0) {
+            ssize_t written = write(fd, data, length);
+            if (written == -1 && errno == EINTR) continue;
+            if (written <= 0) return true;
+            data += written;
+            length -= written;
+        }
+        return false;
+    }
+} // namespace
+
+CaptureWriter::CaptureWriter(const std::string &path) : _start{std::chrono::steady_clock::now()} {
+    _fd = open(path.c_str(), O_WRONLY | O_CREAT | O_TRUNC | O_CLOEXEC, 0644);
+    if (_fd == -1) throw std::runtime_error("can't create capture file " + path);
+    FileHeader header = {};
+    std::memcpy(header.magic, MAGIC, sizeof(MAGIC));
+    header.version = VERSION;
+    header.startTime = std::chrono::nanoseconds(std::chrono::system_clock::now().time_since_epoch()).count();
+    _pending.reserve(WRITE_SIZE + RECORD_HEADER_SIZE);
+    _pending.append(reinterpret_cast<const char *>(&header), sizeof(header));
+}
+
+CaptureWriter::~CaptureWriter() {
+    flush();
+    close(_fd);
+}
+
+bool CaptureWriter::writePending() {
+    if (!_failed && writeAll(_fd, _pending.data(), _pending.size())) _failed = true;
+    _pending.clear();
+    return _failed;
+}
+
+bool CaptureWriter::append(std::string_view first, std::string_view second) {
+    if (_failed) return true;
+    uint64_t nanoseconds = std::chrono::nanoseconds(std::chrono::steady_clock::now() - _start).count();
+    uint32_t length = first.size() + second.size();
+    char header[RECORD_HEADER_SIZE];
+    std::memcpy(header, &nanoseconds, sizeof(nanoseconds));
+    std::memcpy(header + sizeof(nanoseconds), &length, sizeof(length));
+    _pending.append(header, RECORD_HEADER_SIZE);
+    _recordsCount++;
+    if (_pending.size() + length > WRITE_SIZE && writePending()) return true;
+    if (length > WRITE_SIZE) {
+        // big chunks are written from where they are instead of being copied
+        if (writeAll(_fd, first.data(), first.size()) || writeAll(_fd, second.data(), second.size())) _failed = true;
+        return _failed;
+    }
+    _pending.append(first);
+    _pending.append(second);
+    return false;
+}
+
+bool CaptureWriter::flush() { return writePending(); }
+
+CaptureFile::CaptureFile(const std::string &path) {
+    int fd = open(path.c_str(), O_RDONLY | O_CLOEXEC);
+    if (fd == -1) throw std::runtime_error("can't open capture file " + path);
+    struct stat status;
+    if (fstat(fd, &status) == -1 || static_cast<size_t>(status.st_size) < sizeof(FileHeader)) {
+        close(fd);
+        throw std::runtime_error(path + " is not a capture file");
+    }
+    _size = status.st_size;
+    void *data = mmap(nullptr, _size, PROT_READ, MAP_PRIVATE, fd, 0);
+    close(fd);
+    if (data == MAP_FAILED) throw std::runtime_error("can't map capture file " + path);
+    _data = static_cast<const char *>(data);
+    // the records are read in order
+    madvise(data, _size, MADV_SEQUENTIAL);
+
+    FileHeader header;
+    std::memcpy(&header, _data, sizeof(header));
+    if (std::memcmp(header.magic, MAGIC, sizeof(MAGIC)) != 0 || header.version != VERSION) {
+        munmap(data, _size);
+        throw std::runtime_error(path + " is not a capture file");
+    }
+}
+
+CaptureFile::~CaptureFile() { munmap(const_cast<char *>(_data), _size); }
+
+size_t CaptureFile::firstRecord() { return sizeof(FileHeader); }
+
+bool CaptureFile::read(size_t &offset, CaptureRecord &record) const {
+    if (offset > _size || _size - offset < RECORD_HEADER_SIZE) return true;
+    uint32_t length;
+    std::memcpy(&record.nanoseconds, _data + offset, sizeof(record.nanoseconds));
+    std::memcpy(&length, _data + offset + sizeof(record.nanoseconds), sizeof(length));
+    if (_size - offset - RECORD_HEADER_SIZE < length) return true;
+    record.bytes = std::string_view(_data + offset + RECORD_HEADER_SIZE, length);
+    offset += RECORD_HEADER_SIZE + length;
+    return false;
+}
+
+ReplayTransport::ReplayTransport(const CaptureFile &capture, bool paced)
+    : _capture{&capture}, _paced{paced}, _nextOffset{CaptureFile::firstRecord()} {}
+
+bool ReplayTransport::nextRecord() {
+    while (!_ended && _position == _record.bytes.size()) {
+        if (_capture->read(_nextOffset, _record)) {
+            _ended = true;
+            break;
+        }
+        _position = 0;
+    }
+    if (!_started) {
+        // the pacing starts with the first chunk asked
+        _started = true;
+        _start = std::chrono::steady_clock::now();
+        _firstNanoseconds = _record.nanoseconds;
+    }
+    return _ended;
+}
+
+std::chrono::steady_clock::time_point ReplayTransport::due() const {
+    return _start + std::chrono::nanoseconds(_record.nanoseconds - _firstNanoseconds);
+}
+
+ssize_t ReplayTransport::receive(char *buffer, size_t length) {
+    if (nextRecord()) return 0;
+    if (_paced && std::chrono::steady_clock::now() < due()) {
+        errno = EAGAIN;
+        return -1;
+    }
+    length = std::min(length, _record.bytes.size() - _position);
+    std::memcpy(buffer, _record.bytes.data() + _position, length);
+    _position += length;
+    return length;
+}
+
+ssize_t ReplayTransport::receive(const iovec *vectors, int count) {
+    if (nextRecord()) return 0;
+    if (_paced && std::chrono::steady_clock::now() < due()) {
+        errno = EAGAIN;
+        return -1;
+    }
+    // like readv, one chunk is spread over the vectors
+    size_t received = 0;
+    for (int i = 0; i < count && _position < _record.bytes.size(); i++) {
+        size_t length = std::min(vectors[i].iov_len, _record.bytes.size() - _position);
+        std::memcpy(vectors[i].iov_base, _record.bytes.data() + _position, length);
+        _position += length;
+        received += length;
+    }
+    return received;
+}
+
+int ReplayTransport::wait(int timeout) {
+    if (nextRecord() || !_paced) return 1;
+    std::chrono::steady_clock::time_point until = due();
+    if (timeout >= 0) until = std::min(until, std::chrono::steady_clock::now() + std::chrono::milliseconds(timeout));
+    std::this_thread::sleep_until(until);
+    return std::chrono::steady_clock::now() >= due() ? 1 : 0;
+}
+
+size_t ReplayTransport::pendingBytes() {
+    if (nextRecord() || (_paced && std::chrono::steady_clock::now() < due())) return 0;
+    return _record.bytes.size() - _position;
+}
@@ -0,0 +1,148 @@
+#ifndef CAPTURE_HPP
+#define CAPTURE_HPP
+
+#include <chrono>
+#include <cstdint>
+#include <stdexcept>
+#include <string>
+#include <string_view>
+#include <sys/types.h>
+#include <sys/uio.h>
+
+/**
+ * captures of received bytes, to replay real traffic through the read functions.
+ * a capture file is a header followed by one record per recv: the time since the start of the capture in nanoseconds,
+ * the number of bytes and the bytes (native byte order, 12 bytes of overhead per recv)
+ */
+
+/**
+ * appends the chunks received by a handler (see BasicNetworkInputHandler::setCapture) to a capture file.
+ * the records are buffered and written by blocks of about 64 KiB, not thread safe
+ */
+class CaptureWriter {
+    int _fd;
+    std::string _pending;
+    std::chrono::steady_clock::time_point _start;
+    bool _failed = false;
+    size_t _recordsCount = 0;
+
+    /**
+     * writes the pending records, returns true on error
+     */
+    bool writePending();
+
+public:
+    /**
+     * creates (or truncates) the capture file.
+     * throws std::runtime_error if it can't be created
+     */
+    explicit CaptureWriter(const std::string &path);
+
+    /**
+     * writes the pending records and closes the file
+     */
+    ~CaptureWriter();
+
+    CaptureWriter(const CaptureWriter &) = delete;
+    CaptureWriter &operator=(const CaptureWriter &) = delete;
+
+    /**
+     * appends one chunk made of first followed by second, timestamped now.
+     * returns true on error, nothing is written anymore after an error
+     */
+    bool append(std::string_view first, std::string_view second = {});
+
+    /**
+     * writes the pending records, returns true on error
+     */
+    bool flush();
+
+    bool failed() const { return _failed; }
+
+    size_t recordsCount() const { return _recordsCount; }
+};
+
+struct CaptureRecord {
+    // time since the start of the capture
+    uint64_t nanoseconds;
+    std::string_view bytes;
+};
+
+/**
+ * capture file mapped in memory (read only)
+ */
+class CaptureFile {
+    const char *_data = nullptr;
+    size_t _size = 0;
+
+public:
+    /**
+     * throws std::runtime_error if the file can't be mapped or is not a capture
+     */
+    explicit CaptureFile(const std::string &path);
+
+    ~CaptureFile();
+
+    CaptureFile(const CaptureFile &) = delete;
+    CaptureFile &operator=(const CaptureFile &) = delete;
+
+    /**
+     * offset of the first record
+     */
+    static size_t firstRecord();
+
+    /**
+     * reads the record at offset and moves offset to the next one.
+     * returns true at the end of the file, or if the record is truncated
+     */
+    bool read(size_t &offset, CaptureRecord &record) const;
+};
+
+/**
+ * transport (see network_transport.hpp) replaying a capture: each recv gives at most one recorded chunk, like the original recv.
+ * without pacing, the chunks are given as fast as they are read.
+ * with pacing, each chunk is only available once as much time as in the capture has passed since the first receive,
+ * receive fails with EAGAIN before (like a non-blocking socket) and wait sleeps until it.
+ * the end of the capture is seen as a closed socket. the capture file must outlive the transport
+ */
+class ReplayTransport {
+    const CaptureFile *_capture;
+    bool _paced;
+    size_t _nextOffset;
+    CaptureRecord _record = {0, {}};
+    // bytes of _record already given
+    size_t _position = 0;
+    bool _ended = false;
+    bool _started = false;
+    std::chrono::steady_clock::time_point _start;
+    uint64_t _firstNanoseconds = 0;
+
+    /**
+     * makes _record the next chunk with bytes left, returns true at the end of the capture
+     */
+    bool nextRecord();
+
+    /**
+     * time when _record can be given, pacing only
+     */
+    std::chrono::steady_clock::time_point due() const;
+
+public:
+    explicit ReplayTransport(const CaptureFile &capture, bool paced = false);
+
+    int id() const { return -1; }
+
+    ssize_t receive(char *buffer, size_t length);
+
+    bool receivesVectors() const { return true; }
+
+    ssize_t receive(const iovec *vectors, int count);
+
+    int wait(int timeout);
+
+    size_t pendingBytes();
+
+    size_t syscalls() const { return 0; }
+};
+
+#endif // CAPTURE_HPP
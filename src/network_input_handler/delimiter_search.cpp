@@ -0,0 +1,94 @@
+#include "delimiter_search.hpp"
+
+#if defined(__x86_64__) || defined(__i386__)
+#include <immintrin.h>
+#define DELIMITER_SEARCH_X86
+#endif
+
+namespace delimiterSearch {
+    const char *findByteScalar(const char *begin, const char *end, char delimiter) { return std::find(begin, end, delimiter); }
+
+#ifdef DELIMITER_SEARCH_X86
+    const char *findByteSse2(const char *begin, const char *end, char delimiter) {
+        const __m128i needle = _mm_set1_epi8(delimiter);
+        while (end - begin >= 16) {
+            __m128i chunk = _mm_loadu_si128(reinterpret_cast<const __m128i *>(begin));
+            int mask = _mm_movemask_epi8(_mm_cmpeq_epi8(chunk, needle));
+            if (mask) return begin + __builtin_ctz(mask);
+            begin += 16;
+        }
+        return findByteScalar(begin, end, delimiter);
+    }
+
+    __attribute__((target("avx2"))) const char *findByteAvx2(const char *begin, const char *end, char delimiter) {
+        const __m256i needle = _mm256_set1_epi8(delimiter);
+        // two vectors per iteration, frames of several kilobytes rarely contain the delimiter
+        while (end - begin >= 64) {
+            __m256i first = _mm256_loadu_si256(reinterpret_cast<const __m256i *>(begin));
+            __m256i second = _mm256_loadu_si256(reinterpret_cast<const __m256i *>(begin + 32));
+            __m256i firstMatches = _mm256_cmpeq_epi8(first, needle);
+            __m256i secondMatches = _mm256_cmpeq_epi8(second, needle);
+            if (!_mm256_testz_si256(_mm256_or_si256(firstMatches, secondMatches), _mm256_or_si256(firstMatches, secondMatches))) {
+                unsigned int mask = _mm256_movemask_epi8(firstMatches);
+                if (mask) return begin + __builtin_ctz(mask);
+                return begin + 32 + __builtin_ctz(static_cast<unsigned int>(_mm256_movemask_epi8(secondMatches)));
+            }
+            begin += 64;
+        }
+        while (end - begin >= 32) {
+            __m256i chunk = _mm256_loadu_si256(reinterpret_cast<const __m256i *>(begin));
+            unsigned int mask = _mm256_movemask_epi8(_mm256_cmpeq_epi8(chunk, needle));
+            if (mask) return begin + __builtin_ctz(mask);
+            begin += 32;
+        }
+        return findByteSse2(begin, end, delimiter);
+    }
+#else
+    const char *findByteSse2(const char *begin, const char *end, char delimiter) { return findByteScalar(begin, end, delimiter); }
+
+    const char *findByteAvx2(const char *begin, const char *end, char delimiter) { return findByteScalar(begin, end, delimiter); }
+#endif
+
+    namespace {
+        using FindByteFunction = const char *(*)(const char *, const char *, char);
+
+        struct Implementation {
+            FindByteFunction function;
+            const char *name;
+        };
+
+        Implementation selectImplementation() {
+#ifdef DELIMITER_SEARCH_X86
+            __builtin_cpu_init();
+            if (__builtin_cpu_supports("avx2")) return {findByteAvx2, "avx2"};
+            return {findByteSse2, "sse2"};
+#else
+            return {findByteScalar, "scalar"};
+#endif
+        }
+
+        const Implementation &implementation() {
+            static const Implementation selected = selectImplementation();
+            return selected;
+        }
+    } // namespace
+
+    const char *findByte(const char *begin, const char *end, char delimiter) { return implementation().function(begin, end, delimiter); }
+
+    const char *find(const char *begin, const char *end, std::string_view delimiter) {
+        if (delimiter.size() == 1) return findByte(begin, end, delimiter[0]);
+        if (static_cast<size_t>(end - begin) < delimiter.size()) return end;
+
+        // last position where a complete delimiter can start
+        const char *lastStart = end - delimiter.size() + 1;
+        while (begin < lastStart) {
+            begin = findByte(begin, lastStart, delimiter[0]);
+            if (begin == lastStart) break;
+            if (std::memcmp(begin + 1, delimiter.data() + 1, delimiter.size() - 1) == 0) return begin;
+            begin++;
+        }
+        return end;
+    }
+
+    const char *findByteImplementationName() { return implementation().name; }
+} // namespace delimiterSearch
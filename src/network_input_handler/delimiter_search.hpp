@@ -0,0 +1,39 @@
+#ifndef DELIMITER_SEARCH_HPP
+#define DELIMITER_SEARCH_HPP
+
+#include <algorithm>
+#include <cstring>
+#include <string_view>
+
+namespace delimiterSearch {
+    /**
+     * all the find functions return end if the delimiter is not in [begin, end)
+     */
+
+    const char *findByteScalar(const char *begin, const char *end, char delimiter);
+
+    const char *findByteSse2(const char *begin, const char *end, char delimiter);
+
+    /**
+     * must only be called if the cpu supports avx2
+     */
+    const char *findByteAvx2(const char *begin, const char *end, char delimiter);
+
+    /**
+     * uses the fastest implementation supported by the cpu, selected on first call
+     */
+    const char *findByte(const char *begin, const char *end, char delimiter);
+
+    /**
+     * returns a pointer to the first byte of the first complete occurrence of delimiter.
+     * delimiter should not be empty
+     */
+    const char *find(const char *begin, const char *end, std::string_view delimiter);
+
+    /**
+     * name of the implementation used by findByte
+     */
+    const char *findByteImplementationName();
+} // namespace delimiterSearch
+
+#endif // DELIMITER_SEARCH_HPP
@@ -0,0 +1,112 @@
+#include "frame_reader.hpp"
+#include "big_endian.hpp"
+
+namespace {
+    const size_t MAX_VARINT_SIZE = 10;
+
+    size_t fixedHeaderSize(FrameReaderBase::HeaderType headerType) {
+        switch (headerType) {
+        case FrameReaderBase::HeaderType::FIXED_8:
+            return 1;
+        case FrameReaderBase::HeaderType::FIXED_16:
+            return 2;
+        case FrameReaderBase::HeaderType::FIXED_32:
+            return 4;
+        case FrameReaderBase::HeaderType::FIXED_64:
+            return 8;
+        default:
+            return 0;
+        }
+    }
+
+    /**
+     * timeout left for the next peek, 0 once the deadline is passed so the bytes already received are still read
+     */
+    int remainingTimeout(int timeout, std::chrono::steady_clock::time_point deadline) {
+        if (timeout < 0) return timeout;
+        return std::max<int>(0, std::chrono::ceil<std::chrono::milliseconds>(deadline - std::chrono::steady_clock::now()).count());
+    }
+} // namespace
+
+template <class Transport>
+BasicFrameReader<Transport>::BasicFrameReader(BasicNetworkInputHandler<Transport> &inputHandler, HeaderType headerType, size_t maxFrameSize)
+    // the size of a frame with its header must not overflow
+    : _inputHandler{inputHandler}, _headerType{headerType}, _maxFrameSize{std::min(maxFrameSize, SIZE_MAX - MAX_VARINT_SIZE)} {}
+
+template <class Transport>
+int BasicFrameReader<Transport>::readHeader(size_t &headerSize, size_t &payloadSize, bool retryIfNoByteReceived, int timeout,
+                                            std::chrono::steady_clock::time_point deadline) {
+    std::string_view header;
+    int errorCode;
+    payloadSize = 0;
+
+    if (_headerType != HeaderType::VARINT) {
+        headerSize = fixedHeaderSize(_headerType);
+        errorCode = _inputHandler.peekView(headerSize, header, retryIfNoByteReceived, remainingTimeout(timeout, deadline));
+        if (errorCode) return errorCode;
+        payloadSize = bigEndian::decode(header.data(), headerSize);
+        return 0;
+    }
+
+    for (headerSize = 1; headerSize <= MAX_VARINT_SIZE; headerSize++) {
+        // the input handler doesn't wait once bytes are received, so only the first peek can wait: a split header returns 1
+        errorCode = _inputHandler.peekView(headerSize, header, headerSize == 1 && retryIfNoByteReceived, remainingTimeout(timeout, deadline));
+        if (errorCode) return errorCode;
+        unsigned char byte = header.back();
+        size_t bits = byte & 0x7f;
+        size_t shift = 7 * (headerSize - 1);
+        // the 10th byte can only hold the highest bit of a 64 bits value
+        if (headerSize == MAX_VARINT_SIZE && bits > 1) return 4;
+        payloadSize |= bits << shift;
+        if (!(byte & 0x80)) return 0;
+    }
+    return 4;
+}
+
+template <class Transport>
+int BasicFrameReader<Transport>::readFrame(std::string_view &payload, bool retryIfNoByteReceived, int timeout) {
+    std::chrono::steady_clock::time_point deadline = std::chrono::steady_clock::now() + std::chrono::milliseconds(timeout);
+    size_t headerSize;
+    size_t payloadSize;
+    int errorCode = readHeader(headerSize, payloadSize, retryIfNoByteReceived, timeout, deadline);
+    if (errorCode) return errorCode;
+    if (payloadSize > _maxFrameSize) {
+        NETWORK_TRACE_EVENT(OVERSIZE_MESSAGE, _inputHandler.transport().id(), payloadSize);
+        return 4;
+    }
+
+    std::string_view frame;
+    errorCode = _inputHandler.peekView(headerSize + payloadSize, frame, retryIfNoByteReceived, remainingTimeout(timeout, deadline));
+    if (errorCode) return errorCode;
+    payload = frame.substr(headerSize);
+    _inputHandler.discard(frame.size());
+    return 0;
+}
+
+template <class Transport>
+int BasicFrameReader<Transport>::readFrame(std::string &payload, bool retryIfNoByteReceived, int timeout) {
+    std::string_view view;
+    int errorCode = readFrame(view, retryIfNoByteReceived, timeout);
+    if (errorCode == 0) payload.assign(view);
+    return errorCode;
+}
+
+void FrameReaderBase::encodeHeader(HeaderType headerType, size_t payloadSize, std::string &out) {
+    if (headerType != HeaderType::VARINT) {
+        size_t headerSize = fixedHeaderSize(headerType);
+        out.resize(out.size() + headerSize);
+        bigEndian::encode(out.data() + out.size() - headerSize, payloadSize, headerSize);
+        return;
+    }
+    while (payloadSize >= 0x80) {
+        out.push_back(static_cast<char>((payloadSize & 0x7f) | 0x80));
+        payloadSize >>= 7;
+    }
+    out.push_back(static_cast<char>(payloadSize));
+}
+
+template class BasicFrameReader<SocketTransport>;
+template class BasicFrameReader<FileTransport>;
+template class BasicFrameReader<MemoryTransport>;
+template class BasicFrameReader<ReplayTransport>;
+template class BasicFrameReader<SharedMemoryTransport>;
@@ -0,0 +1,83 @@
+#ifndef FRAME_READER_HPP
+#define FRAME_READER_HPP
+
+#include "network_input_handler.hpp"
+#include <chrono>
+#include <string>
+#include <string_view>
+
+/**
+ * header format of the frames, shared by the readers of every transport
+ */
+class FrameReaderBase {
+public:
+    enum class HeaderType {
+        // big-endian unsigned integers
+        FIXED_8,
+        FIXED_16,
+        FIXED_32,
+        FIXED_64,
+        // unsigned LEB128, 7 bits per byte starting with the lowest ones, at most 10 bytes
+        VARINT,
+    };
+
+    /**
+     * writes the header of a frame of payloadSize bytes at the end of out
+     */
+    static void encodeHeader(HeaderType headerType, size_t payloadSize, std::string &out);
+};
+
+/**
+ * reads binary frames made of a length header followed by a payload of this length.
+ * the payload is given from the buffer of the input handler, without copy.
+ */
+template <class Transport> class BasicFrameReader : public FrameReaderBase {
+    BasicNetworkInputHandler<Transport> &_inputHandler;
+    HeaderType _headerType;
+    size_t _maxFrameSize;
+
+    /**
+     * same return values as readFrame, the peeks share the deadline of the whole readFrame
+     */
+    int readHeader(size_t &headerSize, size_t &payloadSize, bool retryIfNoByteReceived, int timeout, std::chrono::steady_clock::time_point deadline);
+
+public:
+    /**
+     * maxFrameSize is the maximum payload size, at most SIZE_MAX minus the size of the longest header
+     */
+    BasicFrameReader(BasicNetworkInputHandler<Transport> &inputHandler, HeaderType headerType = HeaderType::FIXED_32, size_t maxFrameSize = 1 << 20);
+
+    /**
+     * payload is only valid until the next call to any read function of the input handler.
+     * nothing is consumed if the frame is not complete, so a header split between two recv is read by the next call.
+     * timeout is the maximum time to wait in milliseconds for the whole frame, negative means no timeout.
+     * returns:
+     *  - 0 if no errors
+     *  - 1 on error
+     *  - 2 on socket closed
+     *  - 3 on timeout
+     *  - 4 if the frame is bigger than maxFrameSize or the header is invalid,
+     *    nothing is consumed and the connection should be closed since the next frames can't be found
+     */
+    int readFrame(std::string_view &payload, bool retryIfNoByteReceived = false, int timeout = -1);
+
+    /**
+     * same as above, with a copy of the payload
+     */
+    int readFrame(std::string &payload, bool retryIfNoByteReceived = false, int timeout = -1);
+};
+
+using FrameReader = BasicFrameReader<SocketTransport>;
+using FileFrameReader = BasicFrameReader<FileTransport>;
+using MemoryFrameReader = BasicFrameReader<MemoryTransport>;
+using ReplayFrameReader = BasicFrameReader<ReplayTransport>;
+using SharedMemoryFrameReader = BasicFrameReader<SharedMemoryTransport>;
+
+// the functions are defined and instantiated for these transports in frame_reader.cpp
+extern template class BasicFrameReader<SocketTransport>;
+extern template class BasicFrameReader<FileTransport>;
+extern template class BasicFrameReader<MemoryTransport>;
+extern template class BasicFrameReader<ReplayTransport>;
+extern template class BasicFrameReader<SharedMemoryTransport>;
+
+#endif // FRAME_READER_HPP
@@ -0,0 +1,305 @@
+#include "io_uring_receiver.hpp"
+#include "../network_trace/network_trace.hpp"
+
+#ifdef NETWORK_IO_URING
+#include <algorithm>
+#include <cerrno>
+#include <cstring>
+#include <fcntl.h>
+#include <linux/io_uring.h>
+#include <sys/mman.h>
+#include <sys/syscall.h>
+#include <unistd.h>
+
+namespace {
+    const unsigned int BUFFER_GROUP = 0;
+    const unsigned long long RECV_USER_DATA = 1;
+    const unsigned long long CANCEL_USER_DATA = 2;
+
+    int ioUringSetup(unsigned int entries, io_uring_params *params) { return syscall(__NR_io_uring_setup, entries, params); }
+
+    int ioUringEnter(int ring, unsigned int toSubmit, unsigned int minComplete, unsigned int flags) {
+        return syscall(__NR_io_uring_enter, ring, toSubmit, minComplete, flags, nullptr, 0);
+    }
+
+    int ioUringRegister(int ring, unsigned int opcode, void *arg, unsigned int argsCount) {
+        return syscall(__NR_io_uring_register, ring, opcode, arg, argsCount);
+    }
+
+    size_t roundUpToPowerOf2(size_t value) {
+        size_t result = 1;
+        while (result < value) {
+            result <<= 1;
+        }
+        return result;
+    }
+} // namespace
+
+struct IoUringReceiver::Ring {
+    int fd = -1;
+    void *ringMemory = MAP_FAILED;
+    size_t ringMemorySize = 0;
+    void *sqesMemory = MAP_FAILED;
+    size_t sqesMemorySize = 0;
+    unsigned int *sqTail = nullptr;
+    unsigned int *sqMask = nullptr;
+    unsigned int *sqArray = nullptr;
+    io_uring_sqe *sqes = nullptr;
+    unsigned int *cqHead = nullptr;
+    unsigned int *cqTail = nullptr;
+    unsigned int *cqMask = nullptr;
+    io_uring_cqe *cqes = nullptr;
+
+    io_uring_buf_ring *bufferRing = static_cast<io_uring_buf_ring *>(MAP_FAILED);
+    size_t bufferRingSize = 0;
+    size_t buffersCount = 0;
+    size_t bufferSize = 0;
+    std::unique_ptr<char[]> buffers;
+
+    ~Ring() {
+        if (bufferRing != MAP_FAILED) munmap(bufferRing, bufferRingSize);
+        if (sqesMemory != MAP_FAILED) munmap(sqesMemory, sqesMemorySize);
+        if (ringMemory != MAP_FAILED) munmap(ringMemory, ringMemorySize);
+        if (fd != -1) close(fd);
+    }
+};
+
+IoUringReceiver::IoUringReceiver(int socket, std::unique_ptr<Ring> ring, bool nonBlocking)
+    : _ring{std::move(ring)}, _socket{socket}, _nonBlocking{nonBlocking} {}
+
+IoUringReceiver::~IoUringReceiver() {
+    if (_armed) cancel();
+}
+
+std::unique_ptr<IoUringReceiver> IoUringReceiver::create(int socket, size_t bufferSize, size_t buffersCount) {
+    int flags = fcntl(socket, F_GETFL, 0);
+    if (flags == -1 || bufferSize == 0 || buffersCount == 0) return nullptr;
+    buffersCount = roundUpToPowerOf2(buffersCount);
+    // buffer ids are 16 bits
+    if (buffersCount > 32768) return nullptr;
+
+    std::unique_ptr<Ring> ring = std::make_unique<Ring>();
+    io_uring_params params = {};
+    // one sqe is enough for the multishot recv, the cq must hold one completion per provided buffer
+    params.flags = IORING_SETUP_CQSIZE;
+    params.cq_entries = buffersCount * 2;
+    ring->fd = ioUringSetup(4, &params);
+    if (ring->fd == -1) {
+        NETWORK_TRACE_EVENT(IO_URING_SETUP_ERROR, socket, errno);
+        return nullptr;
+    }
+    if (!(params.features & IORING_FEAT_SINGLE_MMAP)) return nullptr;
+
+    ring->ringMemorySize = std::max(params.sq_off.array + params.sq_entries * sizeof(unsigned int),
+                                    params.cq_off.cqes + params.cq_entries * sizeof(io_uring_cqe));
+    ring->ringMemory = mmap(nullptr, ring->ringMemorySize, PROT_READ | PROT_WRITE, MAP_SHARED | MAP_POPULATE, ring->fd, IORING_OFF_SQ_RING);
+    if (ring->ringMemory == MAP_FAILED) return nullptr;
+    ring->sqesMemorySize = params.sq_entries * sizeof(io_uring_sqe);
+    ring->sqesMemory = mmap(nullptr, ring->sqesMemorySize, PROT_READ | PROT_WRITE, MAP_SHARED | MAP_POPULATE, ring->fd, IORING_OFF_SQES);
+    if (ring->sqesMemory == MAP_FAILED) return nullptr;
+
+    char *ringMemory = static_cast<char *>(ring->ringMemory);
+    ring->sqTail = reinterpret_cast<unsigned int *>(ringMemory + params.sq_off.tail);
+    ring->sqMask = reinterpret_cast<unsigned int *>(ringMemory + params.sq_off.ring_mask);
+    ring->sqArray = reinterpret_cast<unsigned int *>(ringMemory + params.sq_off.array);
+    ring->sqes = static_cast<io_uring_sqe *>(ring->sqesMemory);
+    ring->cqHead = reinterpret_cast<unsigned int *>(ringMemory + params.cq_off.head);
+    ring->cqTail = reinterpret_cast<unsigned int *>(ringMemory + params.cq_off.tail);
+    ring->cqMask = reinterpret_cast<unsigned int *>(ringMemory + params.cq_off.ring_mask);
+    ring->cqes = reinterpret_cast<io_uring_cqe *>(ringMemory + params.cq_off.cqes);
+
+    ring->buffersCount = buffersCount;
+    ring->bufferSize = bufferSize;
+    ring->bufferRingSize = buffersCount * sizeof(io_uring_buf);
+    ring->bufferRing = static_cast<io_uring_buf_ring *>(mmap(nullptr, ring->bufferRingSize, PROT_READ | PROT_WRITE, MAP_PRIVATE | MAP_ANONYMOUS, -1, 0));
+    if (ring->bufferRing == MAP_FAILED) return nullptr;
+
+    io_uring_buf_reg bufferRegistration = {};
+    bufferRegistration.ring_addr = reinterpret_cast<unsigned long long>(ring->bufferRing);
+    bufferRegistration.ring_entries = buffersCount;
+    bufferRegistration.bgid = BUFFER_GROUP;
+    if (ioUringRegister(ring->fd, IORING_REGISTER_PBUF_RING, &bufferRegistration, 1) == -1) {
+        NETWORK_TRACE_EVENT(IO_URING_SETUP_ERROR, socket, errno);
+        return nullptr;
+    }
+
+    ring->buffers = std::make_unique_for_overwrite<char[]>(bufferSize * buffersCount);
+    std::unique_ptr<IoUringReceiver> receiver(new IoUringReceiver(socket, std::move(ring), flags & O_NONBLOCK));
+    for (size_t buffer = 0; buffer < buffersCount; buffer++) {
+        receiver->recycle(buffer);
+    }
+    if (receiver->arm()) return nullptr;
+    return receiver;
+}
+
+void IoUringReceiver::recycle(int buffer) {
+    io_uring_buf_ring *bufferRing = _ring->bufferRing;
+    unsigned short tail = bufferRing->tail;
+    // bufs can't be used in c++, its flexible array declaration adds an empty struct before it
+    io_uring_buf *entry = reinterpret_cast<io_uring_buf *>(bufferRing) + (tail & (_ring->buffersCount - 1));
+    entry->addr = reinterpret_cast<unsigned long long>(_ring->buffers.get() + buffer * _ring->bufferSize);
+    entry->len = _ring->bufferSize;
+    entry->bid = buffer;
+    __atomic_store_n(&bufferRing->tail, static_cast<unsigned short>(tail + 1), __ATOMIC_RELEASE);
+}
+
+bool IoUringReceiver::arm() {
+    unsigned int tail = *_ring->sqTail;
+    unsigned int index = tail & *_ring->sqMask;
+    io_uring_sqe *sqe = &_ring->sqes[index];
+    std::memset(sqe, 0, sizeof(*sqe));
+    sqe->opcode = IORING_OP_RECV;
+    sqe->fd = _socket;
+    sqe->ioprio = IORING_RECV_MULTISHOT;
+    sqe->flags = IOSQE_BUFFER_SELECT;
+    sqe->buf_group = BUFFER_GROUP;
+    sqe->user_data = RECV_USER_DATA;
+    _ring->sqArray[index] = index;
+    __atomic_store_n(_ring->sqTail, tail + 1, __ATOMIC_RELEASE);
+
+    _syscalls++;
+    while (ioUringEnter(_ring->fd, 1, 0, 0) == -1) {
+        if (errno != EINTR) return true;
+    }
+    _armed = true;
+    return false;
+}
+
+bool IoUringReceiver::nextCompletion(int &result, unsigned int &flags) {
+    unsigned int head = *_ring->cqHead;
+    if (head == __atomic_load_n(_ring->cqTail, __ATOMIC_ACQUIRE)) return false;
+    const io_uring_cqe &cqe = _ring->cqes[head & *_ring->cqMask];
+    result = cqe.res;
+    flags = cqe.flags;
+    __atomic_store_n(_ring->cqHead, head + 1, __ATOMIC_RELEASE);
+    return true;
+}
+
+bool IoUringReceiver::waitCompletion() {
+    _syscalls++;
+    if (ioUringEnter(_ring->fd, 0, 1, IORING_ENTER_GETEVENTS) == -1 && errno != EINTR) return true;
+    return false;
+}
+
+void IoUringReceiver::cancel() {
+    unsigned int tail = *_ring->sqTail;
+    unsigned int index = tail & *_ring->sqMask;
+    io_uring_sqe *sqe = &_ring->sqes[index];
+    std::memset(sqe, 0, sizeof(*sqe));
+    sqe->opcode = IORING_OP_ASYNC_CANCEL;
+    sqe->fd = -1;
+    sqe->addr = RECV_USER_DATA;
+    sqe->user_data = CANCEL_USER_DATA;
+    _ring->sqArray[index] = index;
+    __atomic_store_n(_ring->sqTail, tail + 1, __ATOMIC_RELEASE);
+
+    unsigned int toSubmit = 1;
+    bool cancelDone = false;
+    while (_armed || !cancelDone) {
+        _syscalls++;
+        int submitted = ioUringEnter(_ring->fd, toSubmit, 1, IORING_ENTER_GETEVENTS);
+        if (submitted == -1) {
+            if (errno == EINTR) continue;
+            return;
+        }
+        toSubmit -= std::min<unsigned int>(toSubmit, submitted);
+
+        unsigned int head = *_ring->cqHead;
+        while (head != __atomic_load_n(_ring->cqTail, __ATOMIC_ACQUIRE)) {
+            const io_uring_cqe &cqe = _ring->cqes[head & *_ring->cqMask];
+            if (cqe.user_data == RECV_USER_DATA && !(cqe.flags & IORING_CQE_F_MORE)) _armed = false;
+            if (cqe.user_data == CANCEL_USER_DATA) {
+                cancelDone = true;
+                // the recv already ended, its last completion was reaped by receive or in this loop
+                if (cqe.res == -ENOENT) _armed = false;
+            }
+            head++;
+        }
+        __atomic_store_n(_ring->cqHead, head, __ATOMIC_RELEASE);
+    }
+}
+
+int IoUringReceiver::pollFd() const { return _ring->fd; }
+
+ssize_t IoUringReceiver::receive(char *buffer, size_t length) {
+    size_t copied = 0;
+    int result;
+    unsigned int flags;
+
+    while (copied < length) {
+        if (_pendingLength > 0) {
+            size_t size = std::min(_pendingLength, length - copied);
+            std::memcpy(buffer + copied, _ring->buffers.get() + _pendingBuffer * _ring->bufferSize + _pendingOffset, size);
+            copied += size;
+            _pendingOffset += size;
+            _pendingLength -= size;
+            if (_pendingLength == 0) recycle(_pendingBuffer);
+            continue;
+        }
+        if (_closed || _pendingError) break;
+
+        if (!nextCompletion(result, flags)) {
+            if (copied > 0) break;
+            if (!_armed) {
+                // the multishot recv stopped (no more provided buffers for example), bytes may be waiting in the socket
+                if (arm()) return -1;
+                continue;
+            }
+            if (_nonBlocking) {
+                errno = EAGAIN;
+                return -1;
+            }
+            if (waitCompletion()) return -1;
+            continue;
+        }
+
+        if (!(flags & IORING_CQE_F_MORE)) _armed = false;
+        if (result > 0) {
+            _receivedBytes = true;
+            _starved = false;
+            _pendingBuffer = flags >> IORING_CQE_BUFFER_SHIFT;
+            _pendingOffset = 0;
+            _pendingLength = result;
+        }
+        else if (result == 0) {
+            _closed = true;
+        }
+        else if (result == -ENOBUFS) {
+            // every buffer is given back before re-arming, so it should not happen twice in a row
+            if (_starved) _pendingError = ENOBUFS;
+            _starved = true;
+        }
+        else {
+            if (result == -EINVAL && !_receivedBytes) {
+                // multishot recv or provided buffers not supported by this kernel
+                _unsupported = true;
+            }
+            _pendingError = -result;
+        }
+    }
+
+    if (copied > 0) return copied;
+    if (_pendingError) {
+        errno = _pendingError;
+        _pendingError = 0;
+        return -1;
+    }
+    return 0; // closed
+}
+
+#else
+
+struct IoUringReceiver::Ring {};
+
+IoUringReceiver::IoUringReceiver(int socket, std::unique_ptr<Ring> ring, bool nonBlocking)
+    : _ring{std::move(ring)}, _socket{socket}, _nonBlocking{nonBlocking} {}
+
+IoUringReceiver::~IoUringReceiver() = default;
+
+std::unique_ptr<IoUringReceiver> IoUringReceiver::create(int, size_t, size_t) { return nullptr; }
+
+ssize_t IoUringReceiver::receive(char *, size_t) { return -1; }
+
+int IoUringReceiver::pollFd() const { return -1; }
+
+#endif
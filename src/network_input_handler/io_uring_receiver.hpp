@@ -0,0 +1,89 @@
+#ifndef IO_URING_RECEIVER_HPP
+#define IO_URING_RECEIVER_HPP
+
+#include <cstddef>
+#include <memory>
+#include <sys/types.h>
+
+/**
+ * receives from a socket with an io_uring multishot recv into a ring of provided buffers,
+ * so one io_uring_enter can bring many recv worth of data.
+ * only compiled when building with IO_URING=1 (NETWORK_IO_URING), create always fails otherwise.
+ * must be used from one thread at a time
+ */
+class IoUringReceiver {
+    struct Ring;
+    std::unique_ptr<Ring> _ring;
+    int _socket;
+    bool _nonBlocking;
+    bool _armed = false;
+    bool _closed = false;
+    bool _unsupported = false;
+    bool _receivedBytes = false;
+    // the kernel had no buffer left to receive into
+    bool _starved = false;
+    // error received after some bytes were already given, returned by the next call
+    int _pendingError = 0;
+    // current provided buffer, not yet entirely given to the caller
+    int _pendingBuffer = -1;
+    size_t _pendingOffset = 0;
+    size_t _pendingLength = 0;
+    size_t _syscalls = 0;
+
+    IoUringReceiver(int socket, std::unique_ptr<Ring> ring, bool nonBlocking);
+
+    /**
+     * submits the multishot recv.
+     * returns true in case of error
+     */
+    bool arm();
+
+    /**
+     * gives the buffer back to the kernel
+     */
+    void recycle(int buffer);
+
+    /**
+     * returns false if there is no completion
+     */
+    bool nextCompletion(int &result, unsigned int &flags);
+
+    /**
+     * returns true in case of error
+     */
+    bool waitCompletion();
+
+    /**
+     * cancels the multishot recv and waits for its last completion, the kernel can write into the buffers until then
+     */
+    void cancel();
+
+public:
+    /**
+     * returns nullptr if io_uring, provided buffer rings or multishot recv are not supported.
+     * buffersCount is rounded up to a power of 2.
+     * the blocking mode of the socket is read here, it should not change after.
+     */
+    static std::unique_ptr<IoUringReceiver> create(int socket, size_t bufferSize, size_t buffersCount);
+    ~IoUringReceiver();
+
+    /**
+     * same semantics as recv(socket, buffer, length, 0)
+     */
+    ssize_t receive(char *buffer, size_t length);
+
+    /**
+     * true if the kernel rejected the multishot recv, recv should be used instead.
+     * no byte has been received when it happens
+     */
+    bool unsupported() const { return _unsupported; }
+
+    /**
+     * file descriptor becoming readable when receive has something to return
+     */
+    int pollFd() const;
+
+    size_t syscalls() const { return _syscalls; }
+};
+
+#endif // IO_URING_RECEIVER_HPP
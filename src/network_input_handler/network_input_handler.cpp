@@ -1,156 +1,584 @@
 #include "network_input_handler.hpp"
+#include "big_endian.hpp"
 
-NetworkInputHandler::NetworkInputHandler(int socket, size_t bufferSize) : _socket{socket}, _bufferSize{bufferSize} {
+template <class Transport>
+BasicNetworkInputHandler<Transport>::BasicNetworkInputHandler(Transport transport, size_t bufferSize)
+    : _transport{std::move(transport)}, _bufferSize{bufferSize} {
     if (_bufferSize <= 0) throw std::invalid_argument("buffer size should be greater than 0");
+    reallocate(_bufferSize * 2);
 }
 
-int NetworkInputHandler::read(size_t length, std::string &out, bool retryIfNoByteReceived) {
-    out = _buffer.substr(_index, length);
-    _index += out.size();
-    length -= out.size();
-    if (length == 0) return 0;
-    _buffer.clear();
+template <class Transport>
+void BasicNetworkInputHandler<Transport>::setAdaptiveBufferSize(size_t minBufferSize, size_t maxBufferSize) {
+    if (minBufferSize <= 0) throw std::invalid_argument("minimum buffer size should be greater than 0");
+    if (minBufferSize > maxBufferSize) throw std::invalid_argument("minimum buffer size should not be greater than maximum buffer size");
+    _adaptive = true;
+    _minBufferSize = minBufferSize;
+    _maxBufferSize = maxBufferSize;
+    _bufferSize = std::clamp(_bufferSize, _minBufferSize, _maxBufferSize);
+    _smallReceives = 0;
+}
+
+template <class Transport>
+void BasicNetworkInputHandler<Transport>::setMaxMessageSize(size_t maxMessageSize, bool discardOversize) {
+    if (maxMessageSize <= 0) throw std::invalid_argument("maximum message size should be greater than 0");
+    _maxMessageSize = maxMessageSize;
+    _discardOversize = discardOversize;
+    _discarding = false;
+}
+
+template <class Transport>
+BasicNetworkInputHandler<Transport>::ReadScope::ReadScope(BasicNetworkInputHandler &handler) : _handler{handler} {
+    if (_handler._readDepth++ > 0) return;
+    if (_handler._readTimeHistogram) _start = std::chrono::steady_clock::now();
+    // the view given by the previous call is not valid anymore
+    _handler._viewGiven = false;
+    _handler.releaseIfDrained();
+}
+
+template <class Transport>
+BasicNetworkInputHandler<Transport>::ReadScope::~ReadScope() {
+    if (--_handler._readDepth > 0) return;
+    // a blocking socket, or a read of exactly the bytes queued, never sees a recv finding nothing
+    if (!_handler._viewGiven) _handler.releaseIfDrained();
+    if (_handler._readTimeHistogram) {
+        _handler._readTimeHistogram->record(std::chrono::nanoseconds(std::chrono::steady_clock::now() - _start).count());
+    }
+}
+
+template <class Transport>
+void BasicNetworkInputHandler<Transport>::setLatencyHistograms(Histogram *readTime, Histogram *messageTime) {
+    _readTimeHistogram = readTime;
+    _messageTimeHistogram = messageTime;
+    // the bytes already received are timed from now
+    _lastReceiveTime = std::chrono::steady_clock::now();
+    _pendingSince = _lastReceiveTime;
+}
+
+template <class Transport>
+void BasicNetworkInputHandler<Transport>::consume(size_t length) {
+    _index += length;
+    if (_index == _end) {
+        // nothing left, next recv can start at the beginning of the buffer
+        _index = 0;
+        _end = 0;
+    }
+}
+
+template <class Transport>
+void BasicNetworkInputHandler<Transport>::useSlabPool(SlabPool &pool) {
+    _slabPool = &pool;
+    releaseIfDrained();
+}
+
+template <class Transport>
+void BasicNetworkInputHandler<Transport>::releaseIfDrained() {
+    if (!_slabPool || available() > 0 || !_buffer) return;
+    _buffer.reset();
+    _capacity = 0;
+    _index = 0;
+    _end = 0;
+}
+
+template <class Transport>
+void BasicNetworkInputHandler<Transport>::countTransportSyscalls() {
+    size_t syscalls = _transport.syscalls();
+    count(&NetworkInputStatistics::syscalls, syscalls - _transportSyscalls);
+    _transportSyscalls = syscalls;
+}
+
+template <class Transport>
+void BasicNetworkInputHandler<Transport>::count(networkStatistics::Counter counter, size_t value) {
+    _statistics.*counter += value;
+    networkStatistics::current().add(counter, value);
+}
+
+template <class Transport>
+void BasicNetworkInputHandler<Transport>::countReceive(ssize_t bytesRead) {
+    count(&NetworkInputStatistics::recvCalls);
+    if (bytesRead > 0) count(&NetworkInputStatistics::bytesReceived, bytesRead);
+    else if (bytesRead == -1 && (errno == EAGAIN || errno == EWOULDBLOCK)) count(&NetworkInputStatistics::wouldBlock);
+}
+
+template <class Transport>
+void BasicNetworkInputHandler<Transport>::countMessage(size_t length) {
+    count(&NetworkInputStatistics::messagesRead);
+    _statistics.largestMessage = std::max(_statistics.largestMessage, length);
+    networkStatistics::current().max(&NetworkInputStatistics::largestMessage, length);
+    if (_messageTimeHistogram) {
+        _messageTimeHistogram->record(std::chrono::nanoseconds(std::chrono::steady_clock::now() - _pendingSince).count());
+        _pendingSince = _lastReceiveTime;
+    }
+}
+
+template <class Transport>
+void BasicNetworkInputHandler<Transport>::refuseMessage(size_t length) {
+    count(&NetworkInputStatistics::oversizeMessages);
+    NETWORK_TRACE_EVENT(OVERSIZE_MESSAGE, _transport.id(), length);
+    if (!_discardOversize) return;
+    count(&NetworkInputStatistics::bytesDiscarded, length);
+    consume(length);
+}
+
+template <class Transport>
+void BasicNetworkInputHandler<Transport>::markReceived(size_t previouslyAvailable) {
+    if (!_messageTimeHistogram) return;
+    _lastReceiveTime = std::chrono::steady_clock::now();
+    if (previouslyAvailable == 0) _pendingSince = _lastReceiveTime;
+}
+
+template <class Transport>
+void BasicNetworkInputHandler<Transport>::reallocate(size_t capacity) {
+    std::unique_ptr<char[], BufferDeleter> buffer;
+    if (_slabPool && capacity <= _slabPool->slabSize()) {
+        buffer = std::unique_ptr<char[], BufferDeleter>(_slabPool->borrow(), BufferDeleter{_slabPool});
+        capacity = _slabPool->slabSize();
+    }
+    else {
+        // new char[] leaves the bytes uninitialized, recv overwrites them anyway
+        buffer = std::unique_ptr<char[], BufferDeleter>(new char[capacity]);
+    }
+    if (available() > 0) std::memcpy(buffer.get(), _buffer.get() + _index, available());
+    count(&NetworkInputStatistics::bytesCopied, available());
+    count(&NetworkInputStatistics::bytesCarriedOver, available());
+    _end = available();
     _index = 0;
+    _buffer = std::move(buffer);
+    _capacity = capacity;
+    NETWORK_TRACE_EVENT(BUFFER_REALLOCATED, _transport.id(), _capacity);
+}
+
+template <class Transport>
+void BasicNetworkInputHandler<Transport>::reserveTail() {
+    if (_adaptive && available() == 0 && _capacity > 4 * _bufferSize) {
+        // an idle connection doesn't keep the memory taken by a big message
+        reallocate(_bufferSize * 2);
+        return;
+    }
+    if (_capacity - _end >= _bufferSize) return;
+    if (_index > 0) {
+        std::memmove(_buffer.get(), _buffer.get() + _index, available());
+        count(&NetworkInputStatistics::bytesCopied, available());
+        count(&NetworkInputStatistics::bytesCarriedOver, available());
+        _end -= _index;
+        _index = 0;
+        NETWORK_TRACE_EVENT(BYTES_CARRIED_OVER, _transport.id(), _end);
+    }
+    if (_capacity - _end < _bufferSize) reallocate(std::max(_capacity * 2, _end + _bufferSize));
+}
+
+template <class Transport>
+void BasicNetworkInputHandler<Transport>::adaptBufferSize(size_t missingBytes) {
+    size_t target = _bufferSize;
+    if (missingBytes > _bufferSize) {
+        // the size of the message is known
+        target = missingBytes;
+    }
+    else if (_lastReceived == _bufferSize) {
+        // the last recv filled the buffer, the kernel can have a lot more
+        size_t pending = _transport.pendingBytes();
+        countTransportSyscalls();
+        target = std::max(_bufferSize * 2, pending);
+    }
+    else if (_lastReceived > 0 && _lastReceived < _bufferSize / 4) {
+        // shrinks slowly, a single small message doesn't undo the growth
+        if (++_smallReceives >= 8) {
+            target = _bufferSize / 2;
+            _smallReceives = 0;
+        }
+    }
+    else {
+        _smallReceives = 0;
+    }
+    target = std::clamp(target, _minBufferSize, _maxBufferSize);
+    if (target != _bufferSize) NETWORK_TRACE_EVENT(BUFFER_SIZE_ADAPTED, _transport.id(), target);
+    _bufferSize = target;
+}
+
+template <class Transport>
+ssize_t BasicNetworkInputHandler<Transport>::receive(size_t missingBytes) {
+    if (_adaptive) adaptBufferSize(missingBytes);
+    reserveTail();
+    ssize_t bytesRead = _transport.receive(_buffer.get() + _end, _bufferSize);
+    countTransportSyscalls();
+    countReceive(bytesRead);
+    if (bytesRead > 0) NETWORK_TRACE_EVENT(RECV, _transport.id(), bytesRead);
+    else if (bytesRead == 0) NETWORK_TRACE_EVENT(SOCKET_CLOSED, _transport.id(), 0);
+    else NETWORK_TRACE_EVENT(RECV_ERROR, _transport.id(), errno);
+    if (bytesRead > 0) {
+        markReceived(available());
+        if (_capture) _capture->append(std::string_view(_buffer.get() + _end, bytesRead));
+        _end += bytesRead;
+    }
+    _lastReceived = bytesRead > 0 ? bytesRead : 0;
+    // nothing to keep until the next recv
+    if (bytesRead <= 0) releaseIfDrained();
+    return bytesRead;
+}
+
+template <class Transport>
+int BasicNetworkInputHandler<Transport>::waitForData(int timeout, std::chrono::steady_clock::time_point deadline) {
+    while (true) {
+        int remaining = -1;
+        if (timeout >= 0) {
+            remaining = std::chrono::ceil<std::chrono::milliseconds>(deadline - std::chrono::steady_clock::now()).count();
+            if (remaining <= 0) return 3;
+        }
+        NETWORK_TRACE_EVENT(WAIT, _transport.id(), remaining);
+        int ready = _transport.wait(remaining);
+        countTransportSyscalls();
+        if (ready > 0) return 0; // readable, closed or in error, recv will tell
+        if (ready == 0) return 3;
+        if (errno != EINTR) return 1;
+    }
+}
 
-    char buffer[_bufferSize] = {0};
+template <class Transport>
+int BasicNetworkInputHandler<Transport>::read(size_t length, std::string &out, bool retryIfNoByteReceived, int timeout) {
+    ReadScope scope(*this);
+    if (length > _maxMessageSize) {
+        count(&NetworkInputStatistics::oversizeMessages);
+        return 4;
+    }
+    size_t missing = length - std::min(length, available());
+    if (_transport.receivesVectors() && missing > _bufferSize) {
+        // only if the whole message can be received now: the bytes of an incomplete message go back to the buffer,
+        // and would be copied again by every call until it is complete
+        size_t pending = _transport.pendingBytes();
+        countTransportSyscalls();
+        if (pending >= missing) return readDirect(length, out, retryIfNoByteReceived, timeout);
+    }
+    std::string_view view;
+    int errorCode = readView(length, view, retryIfNoByteReceived, timeout);
+    if (errorCode == 0) {
+        out.assign(view);
+        count(&NetworkInputStatistics::bytesCopied, length);
+    }
+    return errorCode;
+}
+
+template <class Transport>
+int BasicNetworkInputHandler<Transport>::readDirect(size_t length, std::string &out, bool retryIfNoByteReceived, int timeout) {
+    std::chrono::steady_clock::time_point deadline = std::chrono::steady_clock::now() + std::chrono::milliseconds(timeout);
+    int errorCode = 0;
+
+    out.resize_and_overwrite(length, [&](char *data, size_t) -> size_t {
+        size_t filled = available();
+        if (filled > 0) std::memcpy(data, _buffer.get() + _index, filled);
+        count(&NetworkInputStatistics::bytesCopied, filled);
+        consume(filled);
+
+        while (filled < length) {
+            reserveTail();
+            // the message goes straight into out, only the overshoot goes to the internal buffer
+            iovec vectors[2] = {{data + filled, length - filled}, {_buffer.get() + _end, _bufferSize}};
+            ssize_t bytesRead = _transport.receive(vectors, 2);
+            countTransportSyscalls();
+            countReceive(bytesRead);
+            if (bytesRead > 0) {
+                NETWORK_TRACE_EVENT(DIRECT_RECV, _transport.id(), bytesRead);
+                markReceived(filled);
+                if (_capture) {
+                    size_t intoOut = std::min<size_t>(bytesRead, length - filled);
+                    _capture->append(std::string_view(data + filled, intoOut), std::string_view(_buffer.get() + _end, bytesRead - intoOut));
+                }
+            }
+            else if (bytesRead == -1) NETWORK_TRACE_EVENT(RECV_ERROR, _transport.id(), errno);
+
+            if (bytesRead == -1) {
+                expectBytes(length - filled);
+                if (filled == 0 && retryIfNoByteReceived && (errno == EAGAIN || errno == EWOULDBLOCK)) {
+                    errorCode = waitForData(timeout, deadline);
+                    if (errorCode == 0) continue;
+                }
+                else {
+                    errorCode = 1;
+                }
+            }
+            else if (bytesRead == 0) {
+                NETWORK_TRACE_EVENT(SOCKET_CLOSED, _transport.id(), 0);
+                errorCode = 2;
+            }
+            else if (static_cast<size_t>(bytesRead) > length - filled) {
+                _end += bytesRead - (length - filled);
+                filled = length;
+            }
+            else {
+                // a short read is not an error yet, the next readv tells if more bytes are available
+                filled += bytesRead;
+            }
+
+            if (errorCode) {
+                // the bytes already received are kept for the next call, the internal buffer is empty here
+                if (errorCode == 1) count(&NetworkInputStatistics::incompleteReads);
+                NETWORK_TRACE_EVENT(INCOMPLETE, _transport.id(), filled);
+                if (filled == 0) {
+                    releaseIfDrained();
+                    return 0;
+                }
+                if (_capacity < filled + _bufferSize) reallocate(filled + _bufferSize);
+                std::memcpy(_buffer.get(), data, filled);
+                count(&NetworkInputStatistics::bytesCopied, filled);
+                _end = filled;
+                return 0;
+            }
+        }
+        expectBytes(1);
+        countMessage(length);
+        return length;
+    });
+    return errorCode;
+}
+
+template <class Transport>
+int BasicNetworkInputHandler<Transport>::fill(size_t length, bool retryIfNoByteReceived, int timeout) {
+    std::chrono::steady_clock::time_point deadline = std::chrono::steady_clock::now() + std::chrono::milliseconds(timeout);
     ssize_t bytesRead = 0;
-    size_t bytesAdded = 0;
 
-    while (length > 0) {
-#ifdef DEBUG
-        std::cerr << "need to read " << length << " bytes\n";
-#endif
-        bytesRead = recv(_socket, buffer, _bufferSize, 0);
+    while (available() < length) {
+        bytesRead = receive(length - available());
 
         if (bytesRead == -1) {
-#ifdef DEBUG
-            std::cerr << "recv returned -1. Is it because of non-blocking? " << (errno == EAGAIN || errno == EWOULDBLOCK ? "yes" : "no") << "\n";
-            std::cerr << "string readed before last recv: \"" << out << "\"\n";
-#endif
-            if (out.size() == 0 && retryIfNoByteReceived && (errno == EAGAIN || errno == EWOULDBLOCK)) continue; // TODO: don't run indefinitely, wait for something new to be send
+            // the next wakeup can wait for the whole message
+            expectBytes(length - available());
+            if (available() == 0 && retryIfNoByteReceived && (errno == EAGAIN || errno == EWOULDBLOCK)) {
+                int errorCode = waitForData(timeout, deadline);
+                if (errorCode) return errorCode;
+                continue;
+            }
             return 1;
         }
-        if (bytesRead == 0) {
-#ifdef DEBUG
-            std::cerr << "socket closed\n";
-            std::cerr << "string readed before last recv: \"" << out << "\"\n";
-#endif
-            return 2;
-        }
+        if (bytesRead == 0) return 2;
 
-        if (static_cast<size_t>(bytesRead) < _bufferSize && static_cast<size_t>(bytesRead) < length) {
-#ifdef DEBUG
-            std::cerr << "can't read as much bytes as needed\n";
-            std::cerr << "string readed before last recv: \"" << out << "\"\n";
-            std::cerr << "string readed with last recv: \"";
-            std::cerr.write(buffer, bytesRead);
-            std::cerr << "\"\n";
-#endif
+        if (static_cast<size_t>(bytesRead) < _bufferSize && available() < length) {
+            count(&NetworkInputStatistics::incompleteReads);
+            NETWORK_TRACE_EVENT(INCOMPLETE, _transport.id(), available());
+            expectBytes(length - available());
             return 1; // error, can't read as much bytes as needed
         }
-#ifdef DEBUG
-        std::cerr << static_cast<size_t>(bytesRead) << " bytes effectively read\n";
-        std::cerr << "content: '";
-        std::cerr.write(buffer, bytesRead);
-        std::cerr << buffer << "'\n";
-#endif
-
-        bytesAdded = std::min(static_cast<size_t>(bytesRead), length);
+    }
+    expectBytes(1);
+    return 0;
+}
 
-        out.append(buffer, bytesAdded);
-        length -= bytesAdded;
+template <class Transport>
+int BasicNetworkInputHandler<Transport>::readView(size_t length, std::string_view &out, bool retryIfNoByteReceived, int timeout) {
+    ReadScope scope(*this);
+    if (length > _maxMessageSize) {
+        count(&NetworkInputStatistics::oversizeMessages);
+        return 4;
     }
-    _buffer = std::string(buffer + bytesAdded, bytesRead - bytesAdded);
+    int errorCode = fill(length, retryIfNoByteReceived, timeout);
+    if (errorCode) return errorCode;
+    out = std::string_view(_buffer.get() + _index, length);
+    markViewGiven();
+    consume(length);
+    countMessage(length);
     return 0;
 }
 
-int NetworkInputHandler::readUntilDelimiter(char delimiter, std::string &out, bool includeDelimiter, bool flushDelimiter, bool retryIfNoByteReceived) {
-    bool flush = (!includeDelimiter && flushDelimiter);
-    size_t index = _buffer.find(delimiter, _index);
-    if (index == std::string::npos) {
-        out = _buffer.substr(_index);
-        _buffer.clear();
-        _index = 0;
-#ifdef DEBUG
-        std::cerr << "delimiter not found\n";
-#endif
+template <class Transport>
+int BasicNetworkInputHandler<Transport>::peekView(size_t length, std::string_view &out, bool retryIfNoByteReceived, int timeout) {
+    ReadScope scope(*this);
+    if (length > _maxMessageSize) {
+        count(&NetworkInputStatistics::oversizeMessages);
+        return 4;
     }
-    else {
-        out = _buffer.substr(_index, index + includeDelimiter);
-        _index += index - _index + flush;
-#ifdef DEBUG
-        std::cerr << "delimiter found\n";
-#endif
-        return 0;
+    int errorCode = fill(length, retryIfNoByteReceived, timeout);
+    if (errorCode) return errorCode;
+    out = std::string_view(_buffer.get() + _index, length);
+    markViewGiven();
+    return 0;
+}
+
+template <class Transport>
+void BasicNetworkInputHandler<Transport>::discard(size_t length) { consume(std::min(length, available())); }
+
+template <class Transport>
+int BasicNetworkInputHandler<Transport>::readUntilDelimiter(char delimiter, std::string &out, bool includeDelimiter, bool flushDelimiter, bool retryIfNoByteReceived,
+                                            int timeout) {
+    return readUntilDelimiter(std::string_view(&delimiter, 1), out, includeDelimiter, flushDelimiter, retryIfNoByteReceived, timeout);
+}
+
+template <class Transport>
+int BasicNetworkInputHandler<Transport>::readUntilDelimiterView(char delimiter, std::string_view &out, bool includeDelimiter, bool flushDelimiter,
+                                                bool retryIfNoByteReceived, int timeout) {
+    return readUntilDelimiterView(std::string_view(&delimiter, 1), out, includeDelimiter, flushDelimiter, retryIfNoByteReceived, timeout);
+}
+
+template <class Transport>
+int BasicNetworkInputHandler<Transport>::readUntilDelimiter(std::string_view delimiter, std::string &out, bool includeDelimiter, bool flushDelimiter,
+                                            bool retryIfNoByteReceived, int timeout) {
+    ReadScope scope(*this);
+    std::string_view view;
+    int errorCode = readUntilDelimiterView(delimiter, view, includeDelimiter, flushDelimiter, retryIfNoByteReceived, timeout);
+    if (errorCode == 0) {
+        out.assign(view);
+        count(&NetworkInputStatistics::bytesCopied, view.size());
     }
+    return errorCode;
+}
 
-    char buffer[_bufferSize] = {0};
+template <class Transport>
+int BasicNetworkInputHandler<Transport>::readUntilDelimiterView(std::string_view delimiter, std::string_view &out, bool includeDelimiter, bool flushDelimiter,
+                                                bool retryIfNoByteReceived, int timeout) {
+    ReadScope scope(*this);
+    if (delimiter.empty()) throw std::invalid_argument("delimiter should not be empty");
+    // the length of the message is unknown
+    expectBytes(1);
+    std::chrono::steady_clock::time_point deadline = std::chrono::steady_clock::now() + std::chrono::milliseconds(timeout);
+    size_t searchStart = _index;
+    const char *pos = nullptr;
     ssize_t bytesRead = 0;
-    size_t bytesAdded = 0;
 
     while (true) {
-        bytesRead = recv(_socket, buffer, _bufferSize, 0);
-
-        if (bytesRead == -1) {
-#ifdef DEBUG
-            std::cerr << "recv returned an error. Is it because of non-blocking? " << (errno != EAGAIN && errno != EWOULDBLOCK) << "\n";
-            std::cerr << "string readed before last recv: \"" << out << "\"\n";
-#endif
-            if (out.size() == 0 && retryIfNoByteReceived && (errno == EAGAIN || errno == EWOULDBLOCK)) continue; // TODO: don't run indefinitely, wait for something new to be send
-            return 1;
+        const char *bufferEnd = _buffer.get() + _end;
+        pos = delimiterSearch::find(_buffer.get() + searchStart, bufferEnd, delimiter);
+        if (pos != bufferEnd && _discarding) {
+            // end of a refused message, the next one starts after the delimiter
+            count(&NetworkInputStatistics::bytesDiscarded, pos + delimiter.size() - (_buffer.get() + _index));
+            consume(pos + delimiter.size() - (_buffer.get() + _index));
+            _discarding = false;
+            searchStart = _index;
+            continue;
         }
-        if (bytesRead == 0) {
-#ifdef DEBUG
-            std::cerr << "socket closed\n";
-            std::cerr << "string readed before last recv: \"" << out << "\"\n";
-#endif
-            return 2;
+        if (pos != bufferEnd) break;
+        // the last bytes can be the beginning of a delimiter
+        size_t kept = std::min(available(), delimiter.size() - 1);
+        if (_discarding) {
+            count(&NetworkInputStatistics::bytesDiscarded, available() - kept);
+            consume(available() - kept);
         }
-
-        char *bufferEnd = buffer + bytesRead;
-#ifdef DEBUG
-        std::cerr
-            << "buffer: "
-            << static_cast<void *>(buffer)
-            << ", bytesRead: "
-            << bytesRead
-            << ", bufferEnd: "
-            << static_cast<void *>(bufferEnd)
-            << ", bufferSize: "
-            << (bufferEnd - buffer)
-            << "\n";
-#endif
-
-        char *pos = std::find(buffer, bufferEnd, delimiter);
-#ifdef DEBUG
-        std::cerr << "pos: " << static_cast<void *>(pos) << "\n";
-#endif
-
-        if (pos != bufferEnd) {
-            bytesAdded = pos - buffer + includeDelimiter;
-#ifdef DEBUG
-            std::cerr << "found, appending to out(size=" << out.size() << ") " << bytesAdded << " bytes:\n";
-            std::cerr << std::string(buffer, bytesAdded) << "\n";
-#endif
-            out.append(buffer, bytesAdded);
-            break;
+        else if (available() - kept > _maxMessageSize) {
+            refuseMessage(available() - kept);
+            _discarding = _discardOversize;
+            return 4;
         }
-#ifdef DEBUG
-        std::cerr << "not found, appending to out(size=" << out.size() << ") " << " bytes:\n";
-        std::cerr << std::string(buffer, bytesRead) << "\n";
-#endif
-        out.append(buffer, bytesRead);
-        if (static_cast<size_t>(bytesRead) < _bufferSize) {
-#ifdef DEBUG
-            std::cerr << "can't read any more bytes\n";
-            std::cerr << "string readed before last recv: \"" << out << "\"\n";
-            std::cerr << "string readed with last recv: \"";
-            std::cerr.write(buffer, bytesRead);
-            std::cerr << "\"\n";
-#endif
+        if (bytesRead > 0 && static_cast<size_t>(bytesRead) < _bufferSize) {
+            count(&NetworkInputStatistics::incompleteReads);
+            NETWORK_TRACE_EVENT(INCOMPLETE, _transport.id(), available());
             return 1; // error, can't read any more bytes.
         }
+        // everything before the end has been searched, even if the buffer is compacted by the next recv.
+        // the last bytes are searched again since a delimiter can be split between two recv
+        searchStart = available() - kept;
+
+        bytesRead = receive();
+        searchStart += _index;
+
+        if (bytesRead == -1) {
+            if (available() == 0 && retryIfNoByteReceived && (errno == EAGAIN || errno == EWOULDBLOCK)) {
+                int errorCode = waitForData(timeout, deadline);
+                if (errorCode) return errorCode;
+                bytesRead = 0;
+                continue;
+            }
+            return 1;
+        }
+        if (bytesRead == 0) return 2;
+    }
+
+    size_t messageLength = pos - (_buffer.get() + _index);
+    NETWORK_TRACE_EVENT(DELIMITER_FOUND, _transport.id(), messageLength);
+    if (messageLength > _maxMessageSize) {
+        refuseMessage(messageLength + delimiter.size());
+        return 4;
+    }
+    out = std::string_view(_buffer.get() + _index, messageLength + (includeDelimiter ? delimiter.size() : 0));
+    markViewGiven();
+    countMessage(out.size());
+    consume(messageLength + (includeDelimiter || flushDelimiter ? delimiter.size() : 0));
+    return 0;
+}
+
+template <class Transport>
+int BasicNetworkInputHandler<Transport>::readAllUntilDelimiter(std::string_view delimiter, const BatchCallback &callback, bool includeDelimiter, bool retryIfNoByteReceived,
+                                               int timeout) {
+    ReadScope scope(*this);
+    // the messages given to the callback can be kept until the next call (see the vector overload)
+    markViewGiven();
+    std::string_view message;
+    // the first message can need to receive bytes, the others are only taken from the bytes already received
+    int errorCode = readUntilDelimiterView(delimiter, message, includeDelimiter, true, retryIfNoByteReceived, timeout);
+    if (errorCode) return errorCode;
+    if (!callback(message)) return 0;
+
+    while (available() >= delimiter.size()) {
+        const char *begin = _buffer.get() + _index;
+        const char *bufferEnd = _buffer.get() + _end;
+        const char *pos = delimiterSearch::find(begin, bufferEnd, delimiter);
+        if (pos == bufferEnd) break;
+        size_t messageLength = pos - begin;
+        // refused by the next call
+        if (messageLength > _maxMessageSize) break;
+        message = std::string_view(begin, messageLength + (includeDelimiter ? delimiter.size() : 0));
+        countMessage(message.size());
+        consume(messageLength + delimiter.size());
+        if (!callback(message)) break;
     }
-    _buffer = std::string(buffer + bytesAdded + flush, bytesRead - bytesAdded - flush);
+    NETWORK_TRACE_EVENT(BATCH_LEFT, _transport.id(), available());
     return 0;
 }
+
+template <class Transport>
+int BasicNetworkInputHandler<Transport>::readAllUntilDelimiter(std::string_view delimiter, std::vector<std::string_view> &out, bool includeDelimiter,
+                                               bool retryIfNoByteReceived, int timeout) {
+    out.clear();
+    return readAllUntilDelimiter(
+        delimiter,
+        [&out](std::string_view message) {
+            out.push_back(message);
+            return true;
+        },
+        includeDelimiter, retryIfNoByteReceived, timeout);
+}
+
+template <class Transport>
+int BasicNetworkInputHandler<Transport>::readAllLengthPrefixed(size_t headerSize, const BatchCallback &callback, bool retryIfNoByteReceived, int timeout) {
+    ReadScope scope(*this);
+    markViewGiven();
+    if (headerSize < 1 || headerSize > sizeof(size_t)) throw std::invalid_argument("header size should be between 1 and 8");
+
+    int errorCode = fill(headerSize, retryIfNoByteReceived, timeout);
+    if (errorCode) return errorCode;
+    size_t length = bigEndian::decode(_buffer.get() + _index, headerSize);
+    // headerSize + length must not overflow, even without maximum message size
+    if (length > _maxMessageSize || length > SIZE_MAX - headerSize) {
+        count(&NetworkInputStatistics::oversizeMessages);
+        return 4;
+    }
+    // nothing is consumed until the whole message is received
+    errorCode = fill(headerSize + length, false);
+    if (errorCode) return errorCode;
+
+    while (true) {
+        std::string_view message(_buffer.get() + _index + headerSize, length);
+        countMessage(length);
+        consume(headerSize + length);
+        if (!callback(message)) break;
+
+        if (available() < headerSize) break;
+        length = bigEndian::decode(_buffer.get() + _index, headerSize);
+        if (length > _maxMessageSize || available() - headerSize < length) break;
+    }
+    NETWORK_TRACE_EVENT(BATCH_LEFT, _transport.id(), available());
+    return 0;
+}
+
+template <class Transport>
+int BasicNetworkInputHandler<Transport>::readAllLengthPrefixed(size_t headerSize, std::vector<std::string_view> &out, bool retryIfNoByteReceived, int timeout) {
+    out.clear();
+    return readAllLengthPrefixed(
+        headerSize,
+        [&out](std::string_view message) {
+            out.push_back(message);
+            return true;
+        },
+        retryIfNoByteReceived, timeout);
+}
+
+template class BasicNetworkInputHandler<SocketTransport>;
+template class BasicNetworkInputHandler<FileTransport>;
+template class BasicNetworkInputHandler<MemoryTransport>;
+template class BasicNetworkInputHandler<ReplayTransport>;
+template class BasicNetworkInputHandler<SharedMemoryTransport>;
@@ -1,40 +1,445 @@
 #ifndef NETWORK_INPUT_HANDLER_HPP
 #define NETWORK_INPUT_HANDLER_HPP
 
+#include "../histogram/histogram.hpp"
+#include "../network_trace/network_trace.hpp"
+#include "capture.hpp"
+#include "delimiter_search.hpp"
+#include "network_statistics.hpp"
+#include "network_transport.hpp"
+#include "shared_memory_ring.hpp"
+#include "slab_pool.hpp"
 #include <algorithm>
+#include <cstdint>
+#include <cerrno>
+#include <chrono>
+#include <cstring>
+#include <functional>
+#include <memory>
 #include <stdexcept>
 #include <string>
+#include <poll.h>
+#include <string_view>
+#include <type_traits>
+#include <sys/ioctl.h>
 #include <sys/socket.h>
-#ifdef DEBUG
-#include <iostream>
-#endif
+#include <sys/uio.h>
+#include <vector>
 
-class NetworkInputHandler {
-    int _socket;
+/**
+ * buffered reader of messages from any byte source, Transport is one of the classes of network_transport.hpp
+ */
+template <class Transport> class BasicNetworkInputHandler {
+public:
+    /**
+     * called for each message of a batch, returns false to stop the batch.
+     * the messages not given yet stay in the buffer for the next call
+     */
+    using BatchCallback = std::function<bool(std::string_view message)>;
+
+private:
+    /**
+     * gives the buffer back to the pool it was borrowed from, or frees it
+     */
+    struct BufferDeleter {
+        SlabPool *pool;
+
+        void operator()(char *buffer) const {
+            if (pool) pool->giveBack(buffer);
+            else delete[] buffer;
+        }
+    };
+
+    Transport _transport;
+    // syscalls of the transport already counted
+    size_t _transportSyscalls = 0;
     size_t _bufferSize;
-    std::string _buffer = "";
+    /**
+     * persistent receive area, recv writes directly at its tail.
+     * unread bytes are in [_index, _end).
+     * it is compacted (unread bytes moved to the front) instead of reallocated,
+     * and only grows when a single message doesn't fit in it.
+     */
+    std::unique_ptr<char[], BufferDeleter> _buffer;
+    size_t _capacity = 0;
+    // buffers of at most the slab size are borrowed from it, if set
+    SlabPool *_slabPool = nullptr;
     size_t _index = 0;
+    size_t _end = 0;
+    // adaptive mode, _bufferSize is changed between _minBufferSize and _maxBufferSize
+    bool _adaptive = false;
+    size_t _minBufferSize = 1;
+    size_t _maxBufferSize = SIZE_MAX;
+    size_t _lastReceived = 0;
+    size_t _smallReceives = 0;
+    // longer messages are refused (result 4)
+    size_t _maxMessageSize = SIZE_MAX;
+    bool _discardOversize = false;
+    // the bytes are dropped until the next delimiter, the end of a refused message
+    bool _discarding = false;
+    NetworkInputStatistics _statistics;
+    // latency histograms in nanoseconds, not recorded if null
+    Histogram *_readTimeHistogram = nullptr;
+    Histogram *_messageTimeHistogram = nullptr;
+    // nested read calls are only timed once
+    unsigned _readDepth = 0;
+    // the last public read call gave a view of the buffer, valid until the next call
+    bool _viewGiven = false;
+    // time of the last recv, and of the recv who received the first byte of the next message (approximated by the
+    // last recv for the bytes left after a message)
+    std::chrono::steady_clock::time_point _lastReceiveTime;
+    std::chrono::steady_clock::time_point _pendingSince;
+    // every received chunk is appended to it, if set
+    CaptureWriter *_capture = nullptr;
+
+    /**
+     * lasts for a public read call: times it into _readTimeHistogram,
+     * and gives the slab back if the buffer is drained before the call and after it (unless the call gave a view)
+     */
+    class ReadScope {
+        BasicNetworkInputHandler &_handler;
+        std::chrono::steady_clock::time_point _start;
+
+    public:
+        explicit ReadScope(BasicNetworkInputHandler &handler);
+        ~ReadScope();
+    };
+
+    /**
+     * called by the read functions giving views of the buffer, so it is kept until the next call
+     */
+    void markViewGiven() {
+        if (_readDepth == 1) _viewGiven = true;
+    }
+
+    size_t available() const { return _end - _index; }
+
+    /**
+     * counts the syscalls done by the transport since the last call
+     */
+    void countTransportSyscalls();
+
+    /**
+     * tells the transport how many bytes the current read still needs (1 if unknown or done), if it wants to know
+     */
+    void expectBytes(size_t bytes) {
+        if constexpr (requires(Transport &transport) { transport.expectBytes(bytes); }) {
+            // the caller can still need the errno of the read
+            int readErrno = errno;
+            _transport.expectBytes(bytes);
+            countTransportSyscalls();
+            errno = readErrno;
+        }
+    }
+
+    /**
+     * adds value to a counter of the handler and of the thread
+     */
+    void count(networkStatistics::Counter counter, size_t value = 1);
+
+    /**
+     * counts a recv who returned bytesRead
+     */
+    void countReceive(ssize_t bytesRead);
+
+    /**
+     * counts a complete message and records the time since its first byte was received
+     */
+    void countMessage(size_t length);
+
+    /**
+     * counts a refused message, and consumes length bytes of it (if discarded)
+     */
+    void refuseMessage(size_t length);
+
+    /**
+     * remembers when bytes were received, previouslyAvailable is the number of unread bytes before them
+     */
+    void markReceived(size_t previouslyAvailable);
+
+    /**
+     * consumes `length` bytes from the buffer
+     */
+    void consume(size_t length);
+
+    /**
+     * replaces the buffer by an uninitialized one of capacity bytes, the unread bytes are moved to its front
+     */
+    void reallocate(size_t capacity);
+
+    /**
+     * gives the buffer back if nothing is left in it and a slab pool is used
+     */
+    void releaseIfDrained();
+
+    /**
+     * makes sure at least _bufferSize bytes are free after _end
+     */
+    void reserveTail();
+
+    /**
+     * adaptive mode only, changes _bufferSize from the size of the last recv,
+     * the bytes waiting in the socket (FIONREAD) and missingBytes (0 if unknown)
+     */
+    void adaptBufferSize(size_t missingBytes);
+
+    /**
+     * recv at most _bufferSize bytes at the end of the buffer.
+     * missingBytes is the number of bytes still needed by the caller, 0 if unknown.
+     * returns the value returned by recv
+     */
+    ssize_t receive(size_t missingBytes = 0);
+
+    /**
+     * blocks until the socket is readable or until the deadline (only checked if timeout is not negative).
+     * returns:
+     *  - 0 if the socket is readable
+     *  - 1 on error
+     *  - 3 on timeout
+     */
+    int waitForData(int timeout, std::chrono::steady_clock::time_point deadline);
+
+    /**
+     * read for messages bigger than the buffer: out is resized to length and the bytes are received directly into it,
+     * with readv so the bytes after the message go to the internal buffer.
+     * same arguments and return values as read
+     */
+    int readDirect(size_t length, std::string &out, bool retryIfNoByteReceived, int timeout);
+
+    /**
+     * receives until at least length bytes are in the buffer, without consuming them.
+     * same arguments and return values as read
+     */
+    int fill(size_t length, bool retryIfNoByteReceived, int timeout = -1);
 
 public:
-    NetworkInputHandler(int socket, size_t bufferSize = 1024);
+    BasicNetworkInputHandler(Transport transport, size_t bufferSize = 1024);
+
+    Transport &transport() { return _transport; }
 
     /**
+     * receives with io_uring (multishot recv into buffersCount provided buffers of bufferSize bytes) instead of recv.
+     * only available for sockets, when built with IO_URING=1 on a kernel supporting it (5.19+).
+     * the socket must not be read by anything else, nor its blocking mode changed, after this call.
+     * returns true if io_uring can't be used, recv is still used in this case
+     */
+    bool useIoUring(size_t buffersCount = 64)
+        requires std::is_same_v<Transport, SocketTransport>
+    {
+        return _transport.useIoUring(_bufferSize, buffersCount);
+    }
+
+    bool usesIoUring() const
+        requires std::is_same_v<Transport, SocketTransport>
+    {
+        return _transport.usesIoUring();
+    }
+
+    /**
+     * when a read of known length (read, readView, peekView, length prefixed messages) can't complete yet,
+     * sets SO_RCVLOWAT to the bytes it still needs so poll, epoll and blocking receives only wake up once the message is complete,
+     * and sets it back to 1 once the message is read.
+     * saves the wakeups of messages arriving in several segments, for a setsockopt each time the watermark changes.
+     * the kernel caps the watermark to half the receive buffer of the socket. can't be used with io_uring.
+     * returns true on error
+     */
+    bool useReceiveLowWatermark(bool enabled = true)
+        requires std::is_same_v<Transport, SocketTransport>
+    {
+        bool error = _transport.useReceiveLowWatermark(enabled);
+        countTransportSyscalls();
+        return error;
+    }
+
+    /**
+     * sets SO_BUSY_POLL: blocking receives and poll on the socket poll the device queue up to microseconds before sleeping,
+     * for a lower latency at the cost of cpu time (0 disables it).
+     * values above net.core.busy_read need CAP_NET_ADMIN.
+     * returns true on error
+     */
+    bool setBusyPoll(unsigned microseconds)
+        requires std::is_same_v<Transport, SocketTransport>
+    {
+        bool error = _transport.setBusyPoll(microseconds);
+        countTransportSyscalls();
+        return error;
+    }
+
+    /**
+     * lets the handler change the size of each recv between minBufferSize and maxBufferSize:
+     * it grows for big messages (known size or bytes waiting in the socket) and shrinks back after many small recv.
+     * the memory taken by a big message is freed once it is consumed.
+     * the buffer size given to the constructor is used as the starting size.
+     * throws std::invalid_argument if minBufferSize is 0 or greater than maxBufferSize
+     */
+    void setAdaptiveBufferSize(size_t minBufferSize, size_t maxBufferSize);
+
+    /**
+     * borrows the buffer from pool while bytes are received and not consumed yet, and gives it back once drained
+     * (when a recv finds nothing more to read, or a read call ends with every byte consumed and no view given): an idle connection takes no buffer.
+     * a buffer bigger than the slabs (buffer size or message bigger than a slab) is allocated as before
+     */
+    void useSlabPool(SlabPool &pool = SlabPool::global());
+
+    /**
+     * records in nanoseconds the time spent inside each read call into readTime (waits included, whatever the result),
+     * (callbacks of the batch functions included), and the time between the recv of the first byte of each message and the message being complete into messageTime.
+     * the histograms belong to the caller and must outlive the handler or be unset, null disables each of them.
+     * recording never allocates, the histograms of several handlers of a thread can be shared,
+     * and merged with the ones of other threads to be read
+     */
+    void setLatencyHistograms(Histogram *readTime, Histogram *messageTime);
+
+    /**
+     * messages longer than maxMessageSize bytes (delimiter and length header excluded) are refused with 4
+     * instead of being buffered until they are complete: a handler never keeps much more than maxMessageSize + buffer size bytes.
+     * by default the bytes of a refused message are kept, every read returns 4 again and the connection should be closed.
+     * with discardOversize, the functions reading until a delimiter drop the bytes of a refused message as they arrive
+     * (without buffering them) until the next delimiter, and read the messages after it normally.
+     * throws std::invalid_argument if maxMessageSize is 0
+     */
+    void setMaxMessageSize(size_t maxMessageSize, bool discardOversize = false);
+
+    size_t maxMessageSize() const { return _maxMessageSize; }
+
+    /**
+     * bytes allocated for the receive buffer (0 if given back to the slab pool)
+     */
+    size_t bufferCapacity() const { return _capacity; }
+
+    /**
+     * appends every chunk received from now on to capture, with its time, to be replayed later with ReplayTransport.
+     * the capture belongs to the caller and must outlive the handler or be unset, null stops the capture.
+     * a capture error doesn't stop the reads, it is given by capture.failed()
+     */
+    void setCapture(CaptureWriter *capture) { _capture = capture; }
+
+    /**
+     * current maximum number of bytes asked to each recv
+     */
+    size_t bufferSize() const { return _bufferSize; }
+
+    /**
+     * counters since the creation of the handler
+     */
+    const NetworkInputStatistics &statistics() const { return _statistics; }
+
+    /**
+     * counters of every handler since the start of the process, cheap enough to be exported periodically
+     */
+    static NetworkInputStatistics globalStatistics() { return networkStatistics::global(); }
+
+    /**
+     * number of syscalls done to receive or wait for data since the creation of the handler
+     */
+    size_t syscalls() const { return _statistics.syscalls; }
+
+    /**
+     * number of bytes copied by the handler (compaction, growth of the buffer and copies into out) since its creation
+     */
+    size_t copiedBytes() const { return _statistics.bytesCopied; }
+
+    /**
+     * if retryIfNoByteReceived is true and the socket is non-blocking, waits (without spinning) for the first bytes to arrive.
+     * timeout is the maximum time to wait in milliseconds for the whole call, negative means no timeout.
      * returns:
      *  - 0 if no errors
      *  - 1 on error
      *  - 2 on socket closed
+     *  - 3 on timeout
+     *  - 4 if length is greater than the maximum message size, nothing is received
+     * on error, the bytes already received are kept for the next call.
+     * when more than the buffer size is missing and the transport already has every missing byte, they are received directly into out.
+     * otherwise they are received into the buffer, growing it, so a message arriving in many parts is only copied once
      */
-    int read(size_t length, std::string &out, bool retryIfNoByteReceived = false);
+    int read(size_t length, std::string &out, bool retryIfNoByteReceived = false, int timeout = -1);
 
     /**
      * flushDelimiter is only checked if includeDelimiter is false
+     * retryIfNoByteReceived and timeout work like in read
      * returns:
      *  - 0 if no errors
      *  - 1 on error
      *  - 2 on socket closed
+     *  - 3 on timeout
+     *  - 4 if the message is longer than the maximum message size (see setMaxMessageSize)
+     * on error, the bytes already received are kept for the next call
      */
     int readUntilDelimiter(char delimiter, std::string &out, bool includeDelimiter = false, bool flushDelimiter = false,
-                           bool retryIfNoByteReceived = false);
+                           bool retryIfNoByteReceived = false, int timeout = -1);
+
+    /**
+     * same as read, but out points into the internal buffer instead of being a copy.
+     * out is only valid until the next call to any read function of this handler
+     */
+    int readView(size_t length, std::string_view &out, bool retryIfNoByteReceived = false, int timeout = -1);
+
+    /**
+     * same as readView, but the bytes are not consumed: the next read starts with them.
+     * used to decode headers before knowing the size of a message
+     */
+    int peekView(size_t length, std::string_view &out, bool retryIfNoByteReceived = false, int timeout = -1);
+
+    /**
+     * consumes length bytes already received, length must not be greater than the size of the last peeked view
+     */
+    void discard(size_t length);
+
+    /**
+     * same as readUntilDelimiter, but out points into the internal buffer instead of being a copy.
+     * out is only valid until the next call to any read function of this handler
+     */
+    int readUntilDelimiterView(char delimiter, std::string_view &out, bool includeDelimiter = false, bool flushDelimiter = false,
+                               bool retryIfNoByteReceived = false, int timeout = -1);
+
+    /**
+     * same as readUntilDelimiter, with a delimiter of one or more bytes (like "\r\n").
+     * a delimiter split between two recv is found.
+     * throws std::invalid_argument if delimiter is empty
+     */
+    int readUntilDelimiter(std::string_view delimiter, std::string &out, bool includeDelimiter = false, bool flushDelimiter = false,
+                           bool retryIfNoByteReceived = false, int timeout = -1);
+
+    int readUntilDelimiterView(std::string_view delimiter, std::string_view &out, bool includeDelimiter = false, bool flushDelimiter = false,
+                               bool retryIfNoByteReceived = false, int timeout = -1);
+
+    /**
+     * receives like readUntilDelimiterView for the first message, then gives every other complete message already received, without any recv.
+     * the delimiter is always consumed, and only given with the message if includeDelimiter is true.
+     * the messages are only valid until the next call to any read function of this handler.
+     * returns the same values as readUntilDelimiter, callback is called at least once if 0 is returned
+     */
+    int readAllUntilDelimiter(std::string_view delimiter, const BatchCallback &callback, bool includeDelimiter = false, bool retryIfNoByteReceived = false,
+                              int timeout = -1);
+
+    /**
+     * same as above, filling out (cleared first) with the messages
+     */
+    int readAllUntilDelimiter(std::string_view delimiter, std::vector<std::string_view> &out, bool includeDelimiter = false,
+                              bool retryIfNoByteReceived = false, int timeout = -1);
+
+    /**
+     * same as readAllUntilDelimiter, for messages prefixed by their length as a big-endian unsigned integer of headerSize bytes.
+     * the messages are given without their header, 4 is returned (and nothing consumed) if the first one is longer than the maximum message size,
+     * or than the biggest size who can be addressed with its header.
+     * throws std::invalid_argument if headerSize is not between 1 and 8
+     */
+    int readAllLengthPrefixed(size_t headerSize, const BatchCallback &callback, bool retryIfNoByteReceived = false, int timeout = -1);
+
+    int readAllLengthPrefixed(size_t headerSize, std::vector<std::string_view> &out, bool retryIfNoByteReceived = false, int timeout = -1);
 };
 
+using NetworkInputHandler = BasicNetworkInputHandler<SocketTransport>;
+using FileInputHandler = BasicNetworkInputHandler<FileTransport>;
+using MemoryInputHandler = BasicNetworkInputHandler<MemoryTransport>;
+using ReplayInputHandler = BasicNetworkInputHandler<ReplayTransport>;
+using SharedMemoryInputHandler = BasicNetworkInputHandler<SharedMemoryTransport>;
+
+// the functions are defined and instantiated for these transports in network_input_handler.cpp
+extern template class BasicNetworkInputHandler<SocketTransport>;
+extern template class BasicNetworkInputHandler<FileTransport>;
+extern template class BasicNetworkInputHandler<MemoryTransport>;
+extern template class BasicNetworkInputHandler<ReplayTransport>;
+extern template class BasicNetworkInputHandler<SharedMemoryTransport>;
+
 #endif // NETWORK_INPUT_HANDLER_HPP
@@ -0,0 +1,81 @@
+#include "network_statistics.hpp"
+
+NetworkInputStatistics &NetworkInputStatistics::operator+=(const NetworkInputStatistics &other) {
+    recvCalls += other.recvCalls;
+    syscalls += other.syscalls;
+    bytesReceived += other.bytesReceived;
+    bytesCopied += other.bytesCopied;
+    wouldBlock += other.wouldBlock;
+    incompleteReads += other.incompleteReads;
+    bytesCarriedOver += other.bytesCarriedOver;
+    messagesRead += other.messagesRead;
+    largestMessage = std::max(largestMessage, other.largestMessage);
+    oversizeMessages += other.oversizeMessages;
+    bytesDiscarded += other.bytesDiscarded;
+    return *this;
+}
+
+namespace networkStatistics {
+    namespace {
+        struct Registry {
+            std::mutex mutex;
+            std::vector<ThreadCounters *> threads;
+            // counters of the threads who ended
+            NetworkInputStatistics retired;
+        };
+
+        Registry &registry() {
+            // never destroyed, threads can end after the static destructors
+            static Registry *registry = new Registry();
+            return *registry;
+        }
+
+        /**
+         * gives the counters of its thread to the retired counters when the thread ends
+         */
+        struct ThreadCountersOwner {
+            ThreadCounters counters;
+
+            ~ThreadCountersOwner() {
+                Registry &threads = registry();
+                std::lock_guard<std::mutex> lock(threads.mutex);
+                threads.retired += counters.load();
+                threads.threads.erase(std::find(threads.threads.begin(), threads.threads.end(), &counters));
+                threadCounters = nullptr;
+            }
+        };
+    } // namespace
+
+    NetworkInputStatistics ThreadCounters::load() const {
+        NetworkInputStatistics statistics;
+        Counter counters[] = {
+            &NetworkInputStatistics::recvCalls,        &NetworkInputStatistics::syscalls,        &NetworkInputStatistics::bytesReceived,
+            &NetworkInputStatistics::bytesCopied,      &NetworkInputStatistics::wouldBlock,      &NetworkInputStatistics::incompleteReads,
+            &NetworkInputStatistics::bytesCarriedOver, &NetworkInputStatistics::messagesRead,    &NetworkInputStatistics::largestMessage,
+            &NetworkInputStatistics::oversizeMessages, &NetworkInputStatistics::bytesDiscarded,
+        };
+        for (Counter counter : counters) {
+            statistics.*counter = std::atomic_ref<size_t>(const_cast<size_t &>(values.*counter)).load(std::memory_order_relaxed);
+        }
+        return statistics;
+    }
+
+    ThreadCounters *createThreadCounters() {
+        thread_local ThreadCountersOwner owner;
+        Registry &threads = registry();
+        std::lock_guard<std::mutex> lock(threads.mutex);
+        threads.threads.push_back(&owner.counters);
+        threadCounters = &owner.counters;
+        return threadCounters;
+    }
+
+    NetworkInputStatistics global() {
+        Registry &threads = registry();
+        std::lock_guard<std::mutex> lock(threads.mutex);
+        NetworkInputStatistics statistics = threads.retired;
+        for (const ThreadCounters *counters : threads.threads) {
+            statistics += counters->load();
+        }
+        return statistics;
+    }
+} // namespace networkStatistics
@@ -0,0 +1,78 @@
+#ifndef NETWORK_STATISTICS_HPP
+#define NETWORK_STATISTICS_HPP
+
+#include <algorithm>
+#include <atomic>
+#include <cstddef>
+#include <mutex>
+#include <vector>
+
+/**
+ * counters of one NetworkInputHandler, or of every handler of the process
+ */
+struct NetworkInputStatistics {
+    // recv and readv, or receives from io_uring buffers
+    size_t recvCalls = 0;
+    // every syscall done to receive or wait for data (recv, readv, poll, ioctl, io_uring_enter)
+    size_t syscalls = 0;
+    size_t bytesReceived = 0;
+    // bytes copied by the handler: compaction, growth of the buffer and copies into strings
+    size_t bytesCopied = 0;
+    // recv who found nothing to read on a non-blocking socket (EAGAIN)
+    size_t wouldBlock = 0;
+    // reads who returned 1 because the message was not complete yet
+    size_t incompleteReads = 0;
+    // unread bytes moved by a compaction or a growth of the buffer
+    size_t bytesCarriedOver = 0;
+    size_t messagesRead = 0;
+    size_t largestMessage = 0;
+    // messages refused because they were longer than the maximum message size
+    size_t oversizeMessages = 0;
+    // bytes of refused messages dropped without being given
+    size_t bytesDiscarded = 0;
+
+    NetworkInputStatistics &operator+=(const NetworkInputStatistics &other);
+};
+
+/**
+ * aggregates the counters of every handler: each thread adds to its own counters,
+ * summed by global() only when a snapshot is asked
+ */
+namespace networkStatistics {
+    using Counter = size_t NetworkInputStatistics::*;
+
+    /**
+     * only written by its thread, read by global with relaxed atomics
+     */
+    struct ThreadCounters {
+        NetworkInputStatistics values;
+
+        void add(Counter counter, size_t value) {
+            std::atomic_ref<size_t> field(values.*counter);
+            field.store(field.load(std::memory_order_relaxed) + value, std::memory_order_relaxed);
+        }
+
+        void max(Counter counter, size_t value) {
+            std::atomic_ref<size_t> field(values.*counter);
+            if (value > field.load(std::memory_order_relaxed)) field.store(value, std::memory_order_relaxed);
+        }
+
+        NetworkInputStatistics load() const;
+    };
+
+    /**
+     * registers the counters of the calling thread, added to the retired counters when the thread ends
+     */
+    ThreadCounters *createThreadCounters();
+
+    inline thread_local ThreadCounters *threadCounters = nullptr;
+
+    inline ThreadCounters &current() { return threadCounters ? *threadCounters : *createThreadCounters(); }
+
+    /**
+     * counters of every handler since the start of the process
+     */
+    NetworkInputStatistics global();
+} // namespace networkStatistics
+
+#endif // NETWORK_STATISTICS_HPP
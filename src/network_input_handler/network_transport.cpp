@@ -0,0 +1,77 @@
+#include "network_transport.hpp"
+
+namespace {
+    int waitReadable(int fd, int timeout) {
+        pollfd pollFd = {fd, POLLIN, 0};
+        return poll(&pollFd, 1, timeout);
+    }
+
+    size_t pendingBytesOf(int fd) {
+        int pending = 0;
+        if (ioctl(fd, FIONREAD, &pending) == -1 || pending < 0) return 0;
+        return pending;
+    }
+} // namespace
+
+bool SocketTransport::useIoUring(size_t bufferSize, size_t buffersCount) {
+    if (_ioUring) return false;
+    _ioUring = IoUringReceiver::create(_socket, bufferSize, buffersCount);
+    return _ioUring == nullptr;
+}
+
+ssize_t SocketTransport::receive(char *buffer, size_t length) {
+    if (_ioUring) {
+        ssize_t bytesRead = _ioUring->receive(buffer, length);
+        if (bytesRead != -1 || !_ioUring->unsupported()) return bytesRead;
+        NETWORK_TRACE_EVENT(IO_URING_FALLBACK, _socket, 0);
+        _syscalls += _ioUring->syscalls();
+        _ioUring.reset();
+    }
+    _syscalls++;
+    return recv(_socket, buffer, length, 0);
+}
+
+bool SocketTransport::useReceiveLowWatermark(bool enabled) {
+    // io_uring takes the bytes from the socket as soon as they arrive
+    if (enabled && _ioUring) return true;
+    _useLowWatermark = enabled;
+    if (!enabled && _lowWatermark != 1) return setLowWatermark(1);
+    return false;
+}
+
+bool SocketTransport::setLowWatermark(size_t bytes) {
+    int value = std::clamp<size_t>(bytes, 1, INT_MAX);
+    _syscalls++;
+    if (setsockopt(_socket, SOL_SOCKET, SO_RCVLOWAT, &value, sizeof(value)) == -1) return true;
+    _lowWatermark = value;
+    return false;
+}
+
+bool SocketTransport::setBusyPoll(unsigned microseconds) {
+    int value = std::min<unsigned>(microseconds, INT_MAX);
+    _syscalls++;
+    return setsockopt(_socket, SOL_SOCKET, SO_BUSY_POLL, &value, sizeof(value)) == -1;
+}
+
+int SocketTransport::wait(int timeout) {
+    _syscalls++;
+    // with io_uring, the bytes are taken from the socket by the kernel as soon as they arrive
+    return waitReadable(_ioUring ? _ioUring->pollFd() : _socket, timeout);
+}
+
+size_t SocketTransport::pendingBytes() {
+    // the bytes are already taken from the socket with io_uring
+    if (_ioUring) return 0;
+    _syscalls++;
+    return pendingBytesOf(_socket);
+}
+
+int FileTransport::wait(int timeout) {
+    _syscalls++;
+    return waitReadable(_fd, timeout);
+}
+
+size_t FileTransport::pendingBytes() {
+    _syscalls++;
+    return pendingBytesOf(_fd);
+}
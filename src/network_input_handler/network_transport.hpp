@@ -0,0 +1,165 @@
+#ifndef NETWORK_TRANSPORT_HPP
+#define NETWORK_TRANSPORT_HPP
+
+#include "../network_trace/network_trace.hpp"
+#include "io_uring_receiver.hpp"
+#include <algorithm>
+#include <cerrno>
+#include <climits>
+#include <cstring>
+#include <memory>
+#include <poll.h>
+#include <string_view>
+#include <sys/ioctl.h>
+#include <sys/socket.h>
+#include <sys/uio.h>
+#include <unistd.h>
+
+/**
+ * byte sources of BasicNetworkInputHandler, its functions are called directly (resolved at compile time, no virtual dispatch).
+ * a transport has:
+ *  - int id() const: identifier of the source in the traces (its file descriptor if any)
+ *  - ssize_t receive(char *buffer, size_t length): same semantics as recv, -1 with errno EAGAIN if nothing is available yet, 0 at the end
+ *  - bool receivesVectors() const: true if receive(vectors, count) can be used right now
+ *  - ssize_t receive(const iovec *vectors, int count): same semantics as readv
+ *  - int wait(int timeout): same semantics as poll on the source for reading (timeout in milliseconds, negative means no timeout)
+ *  - size_t pendingBytes(): bytes ready to be received (like FIONREAD), 0 if unknown
+ *  - size_t syscalls() const: number of syscalls done since the creation of the transport
+ *  - optionally void expectBytes(size_t bytes): number of bytes needed by the current read before it can complete, 1 when unknown or done
+ * a new transport needs an explicit instantiation of BasicNetworkInputHandler in network_input_handler.cpp
+ */
+
+/**
+ * socket file descriptor, read with recv (or io_uring if enabled).
+ * implicitly built from the socket so NetworkInputHandler(socket, bufferSize) still works
+ */
+class SocketTransport {
+    int _socket;
+    // replaces recv if enabled and supported
+    std::unique_ptr<IoUringReceiver> _ioUring = nullptr;
+    size_t _syscalls = 0;
+    bool _useLowWatermark = false;
+    // current SO_RCVLOWAT of the socket
+    int _lowWatermark = 1;
+
+public:
+    SocketTransport(int socket) : _socket{socket} {}
+
+    /**
+     * see BasicNetworkInputHandler::useReceiveLowWatermark, returns true on error
+     */
+    bool useReceiveLowWatermark(bool enabled);
+
+    /**
+     * sets SO_RCVLOWAT to bytes if the low watermark is used and it changed
+     */
+    void expectBytes(size_t bytes) {
+        if (_useLowWatermark && static_cast<int>(std::min<size_t>(bytes, INT_MAX)) != _lowWatermark) setLowWatermark(bytes);
+    }
+
+    /**
+     * returns true on error
+     */
+    bool setLowWatermark(size_t bytes);
+
+    /**
+     * sets SO_BUSY_POLL, returns true on error
+     */
+    bool setBusyPoll(unsigned microseconds);
+
+    /**
+     * returns true if io_uring can't be used, see BasicNetworkInputHandler::useIoUring
+     */
+    bool useIoUring(size_t bufferSize, size_t buffersCount);
+
+    bool usesIoUring() const { return _ioUring != nullptr; }
+
+    int id() const { return _socket; }
+
+    ssize_t receive(char *buffer, size_t length);
+
+    // io_uring only receives into its own buffers
+    bool receivesVectors() const { return _ioUring == nullptr; }
+
+    ssize_t receive(const iovec *vectors, int count) {
+        _syscalls++;
+        return readv(_socket, vectors, count);
+    }
+
+    int wait(int timeout);
+
+    size_t pendingBytes();
+
+    size_t syscalls() const { return _syscalls + (_ioUring ? _ioUring->syscalls() : 0); }
+};
+
+/**
+ * any readable file descriptor (pipe, file, character device...), read with read
+ */
+class FileTransport {
+    int _fd;
+    size_t _syscalls = 0;
+
+public:
+    explicit FileTransport(int fd) : _fd{fd} {}
+
+    int id() const { return _fd; }
+
+    ssize_t receive(char *buffer, size_t length) {
+        _syscalls++;
+        return ::read(_fd, buffer, length);
+    }
+
+    bool receivesVectors() const { return true; }
+
+    ssize_t receive(const iovec *vectors, int count) {
+        _syscalls++;
+        return readv(_fd, vectors, count);
+    }
+
+    int wait(int timeout);
+
+    size_t pendingBytes();
+
+    size_t syscalls() const { return _syscalls; }
+};
+
+/**
+ * bytes already in memory (like a recorded capture), received as if they came from a socket closed after them.
+ * the bytes are not owned and must outlive the transport
+ */
+class MemoryTransport {
+    std::string_view _bytes;
+    size_t _position = 0;
+
+public:
+    explicit MemoryTransport(std::string_view bytes) : _bytes{bytes} {}
+
+    int id() const { return -1; }
+
+    ssize_t receive(char *buffer, size_t length) {
+        length = std::min(length, _bytes.size() - _position);
+        if (length > 0) std::memcpy(buffer, _bytes.data() + _position, length);
+        _position += length;
+        return length;
+    }
+
+    bool receivesVectors() const { return true; }
+
+    ssize_t receive(const iovec *vectors, int count) {
+        ssize_t received = 0;
+        for (int i = 0; i < count && _position < _bytes.size(); i++) {
+            received += receive(static_cast<char *>(vectors[i].iov_base), vectors[i].iov_len);
+        }
+        return received;
+    }
+
+    // the end of the bytes is seen as a closed socket, so they are always ready
+    int wait(int) { return 1; }
+
+    size_t pendingBytes() { return _bytes.size() - _position; }
+
+    size_t syscalls() const { return 0; }
+};
+
+#endif // NETWORK_TRANSPORT_HPP
@@ -0,0 +1,232 @@
+#include "shared_memory_ring.hpp"
+#include <algorithm>
+#include <cerrno>
+#include <cstring>
+#include <new>
+#include <poll.h>
+#include <sys/eventfd.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+namespace {
+    const uint64_t MAGIC = 0x474e495259524d53; // "SMRYRING"
+
+    void closeAll(int memoryFd, int dataEventFd, int spaceEventFd) {
+        if (memoryFd != -1) close(memoryFd);
+        if (dataEventFd != -1) close(dataEventFd);
+        if (spaceEventFd != -1) close(spaceEventFd);
+    }
+} // namespace
+
+SharedMemoryRing::SharedMemoryRing(size_t capacity) : _capacity{capacity} {
+    if (capacity == 0 || (capacity & (capacity - 1)) != 0) throw std::invalid_argument("capacity should be a power of two");
+    _memoryFd = memfd_create("shared_memory_ring", MFD_CLOEXEC);
+    _dataEventFd = eventfd(0, EFD_NONBLOCK | EFD_CLOEXEC);
+    _spaceEventFd = eventfd(0, EFD_NONBLOCK | EFD_CLOEXEC);
+    if (_memoryFd == -1 || _dataEventFd == -1 || _spaceEventFd == -1 || ftruncate(_memoryFd, sizeof(Header) + capacity) == -1) {
+        closeAll(_memoryFd, _dataEventFd, _spaceEventFd);
+        throw std::runtime_error("can't create shared memory ring");
+    }
+    map();
+    // the new memory is zeroed, the atomics start at 0
+    new (_header) Header{MAGIC, capacity, {0}, {0}, {0}, {0}, {0}, {0}};
+}
+
+SharedMemoryRing::SharedMemoryRing(int memoryFd, int dataEventFd, int spaceEventFd)
+    : _memoryFd{memoryFd}, _dataEventFd{dataEventFd}, _spaceEventFd{spaceEventFd} {
+    map();
+    _capacity = _header->capacity;
+    if (_header->magic != MAGIC || _capacity == 0 || (_capacity & (_capacity - 1)) != 0 || _mappedSize != sizeof(Header) + _capacity) {
+        munmap(_header, _mappedSize);
+        closeAll(_memoryFd, _dataEventFd, _spaceEventFd);
+        throw std::runtime_error("file descriptors are not a shared memory ring");
+    }
+}
+
+void SharedMemoryRing::map() {
+    struct stat status;
+    void *memory = MAP_FAILED;
+    if (fstat(_memoryFd, &status) == 0 && static_cast<size_t>(status.st_size) >= sizeof(Header)) {
+        _mappedSize = status.st_size;
+        memory = mmap(nullptr, _mappedSize, PROT_READ | PROT_WRITE, MAP_SHARED, _memoryFd, 0);
+    }
+    if (memory == MAP_FAILED) {
+        closeAll(_memoryFd, _dataEventFd, _spaceEventFd);
+        throw std::runtime_error("can't map shared memory ring");
+    }
+    _header = static_cast<Header *>(memory);
+    _data = static_cast<char *>(memory) + sizeof(Header);
+}
+
+SharedMemoryRing::~SharedMemoryRing() {
+    munmap(_header, _mappedSize);
+    closeAll(_memoryFd, _dataEventFd, _spaceEventFd);
+}
+
+bool SharedMemoryRing::signal(int eventFd) {
+    uint64_t value = 1;
+    // EAGAIN only if the counter is full, the other side is woken up anyway
+    return write(eventFd, &value, sizeof(value)) == -1 && errno != EAGAIN;
+}
+
+int SharedMemoryRing::waitSignal(int eventFd, int timeout) {
+    pollfd pollEvent = {eventFd, POLLIN, 0};
+    int ready = poll(&pollEvent, 1, timeout);
+    if (ready > 0) {
+        uint64_t value;
+        // resets the counter, the state of the ring is checked again anyway
+        if (read(eventFd, &value, sizeof(value)) == -1 && errno != EAGAIN) return -1;
+    }
+    return ready;
+}
+
+bool SharedMemoryWriter::usedBytes(size_t &used) {
+    SharedMemoryRing::Header &header = _ring.header();
+    used = header.head.load(std::memory_order_relaxed) - header.tail.load(std::memory_order_acquire);
+    if (used <= _ring.capacity()) return false;
+    errno = EPROTO;
+    return true;
+}
+
+size_t SharedMemoryWriter::copyIn(std::string_view message, size_t freeSpace) {
+    SharedMemoryRing::Header &header = _ring.header();
+    uint64_t head = header.head.load(std::memory_order_relaxed);
+    size_t capacity = _ring.capacity();
+    size_t length = std::min(message.size(), freeSpace);
+    size_t index = head & (capacity - 1);
+    size_t first = std::min(length, capacity - index);
+    std::memcpy(_ring.data() + index, message.data(), first);
+    std::memcpy(_ring.data(), message.data() + first, length - first);
+    // seq_cst orders the store before the load of readerWaiting, the reader does the opposite
+    header.head.store(head + length, std::memory_order_seq_cst);
+    if (length > 0 && header.readerWaiting.load(std::memory_order_seq_cst)) {
+        _syscalls++;
+        SharedMemoryRing::signal(_ring.dataEventFd());
+    }
+    return length;
+}
+
+int SharedMemoryWriter::waitForSpace(int timeout, std::chrono::steady_clock::time_point deadline) {
+    SharedMemoryRing::Header &header = _ring.header();
+    while (true) {
+        int remaining = -1;
+        if (timeout >= 0) {
+            remaining = std::chrono::ceil<std::chrono::milliseconds>(deadline - std::chrono::steady_clock::now()).count();
+            if (remaining <= 0) return 3;
+        }
+        header.writerWaiting.store(1, std::memory_order_seq_cst);
+        size_t used;
+        if (usedBytes(used)) {
+            header.writerWaiting.store(0, std::memory_order_relaxed);
+            return 1;
+        }
+        bool full = used == _ring.capacity();
+        if (header.readerClosed.load(std::memory_order_acquire)) {
+            header.writerWaiting.store(0, std::memory_order_relaxed);
+            return 2;
+        }
+        int ready = 1;
+        if (full) {
+            _syscalls++;
+            ready = SharedMemoryRing::waitSignal(_ring.spaceEventFd(), remaining);
+        }
+        header.writerWaiting.store(0, std::memory_order_relaxed);
+        if (ready == -1 && errno != EINTR) return 1;
+        if (usedBytes(used)) return 1;
+        if (used < _ring.capacity()) return 0;
+    }
+}
+
+int SharedMemoryWriter::write(std::string_view message, bool retryIfFull, int timeout) {
+    SharedMemoryRing::Header &header = _ring.header();
+    if (header.readerClosed.load(std::memory_order_acquire)) return 2;
+    size_t used;
+    if (!retryIfFull) {
+        if (usedBytes(used)) return 1;
+        if (_ring.capacity() - used < message.size()) {
+            errno = EAGAIN;
+            return 1;
+        }
+        copyIn(message, _ring.capacity() - used);
+        return 0;
+    }
+
+    std::chrono::steady_clock::time_point deadline = std::chrono::steady_clock::now() + std::chrono::milliseconds(timeout);
+    while (true) {
+        if (usedBytes(used)) return 1;
+        message.remove_prefix(copyIn(message, _ring.capacity() - used));
+        if (message.empty()) return 0;
+        int errorCode = waitForSpace(timeout, deadline);
+        if (errorCode) return errorCode;
+    }
+}
+
+void SharedMemoryWriter::close() {
+    SharedMemoryRing::Header &header = _ring.header();
+    if (header.writerClosed.exchange(1, std::memory_order_seq_cst)) return;
+    if (header.readerWaiting.load(std::memory_order_seq_cst)) {
+        _syscalls++;
+        SharedMemoryRing::signal(_ring.dataEventFd());
+    }
+}
+
+SharedMemoryTransport::~SharedMemoryTransport() {
+    if (!_ring) return;
+    SharedMemoryRing::Header &header = _ring->header();
+    header.readerClosed.store(1, std::memory_order_seq_cst);
+    if (header.writerWaiting.load(std::memory_order_seq_cst)) SharedMemoryRing::signal(_ring->spaceEventFd());
+}
+
+void SharedMemoryTransport::release(size_t length) {
+    SharedMemoryRing::Header &header = _ring->header();
+    // seq_cst orders the store before the load of writerWaiting, the writer does the opposite
+    header.tail.store(header.tail.load(std::memory_order_relaxed) + length, std::memory_order_seq_cst);
+    if (header.writerWaiting.load(std::memory_order_seq_cst)) {
+        _syscalls++;
+        SharedMemoryRing::signal(_ring->spaceEventFd());
+    }
+}
+
+ssize_t SharedMemoryTransport::receive(const iovec *vectors, int count) {
+    SharedMemoryRing::Header &header = _ring->header();
+    uint64_t tail = header.tail.load(std::memory_order_relaxed);
+    uint64_t head = header.head.load(std::memory_order_acquire);
+    if (head == tail) {
+        // the writer closes after its last write, so nothing can be left once it is closed
+        if (header.writerClosed.load(std::memory_order_acquire) && header.head.load(std::memory_order_acquire) == tail) return 0;
+        errno = EAGAIN;
+        return -1;
+    }
+    size_t capacity = _ring->capacity();
+    if (head - tail > capacity) {
+        // the writer can't be ahead by more than the ring, the positions were corrupted
+        errno = EPROTO;
+        return -1;
+    }
+    size_t received = 0;
+    for (int i = 0; i < count && tail + received < head; i++) {
+        char *out = static_cast<char *>(vectors[i].iov_base);
+        size_t length = std::min<size_t>(vectors[i].iov_len, head - tail - received);
+        size_t index = (tail + received) & (capacity - 1);
+        size_t first = std::min(length, capacity - index);
+        std::memcpy(out, _ring->data() + index, first);
+        std::memcpy(out + first, _ring->data(), length - first);
+        received += length;
+    }
+    release(received);
+    return received;
+}
+
+int SharedMemoryTransport::wait(int timeout) {
+    SharedMemoryRing::Header &header = _ring->header();
+    header.readerWaiting.store(1, std::memory_order_seq_cst);
+    int ready = 1;
+    if (header.head.load(std::memory_order_seq_cst) == header.tail.load(std::memory_order_relaxed)
+        && !header.writerClosed.load(std::memory_order_seq_cst)) {
+        _syscalls++;
+        ready = SharedMemoryRing::waitSignal(_ring->dataEventFd(), timeout);
+    }
+    header.readerWaiting.store(0, std::memory_order_relaxed);
+    return ready;
+}
@@ -0,0 +1,193 @@
+#ifndef SHARED_MEMORY_RING_HPP
+#define SHARED_MEMORY_RING_HPP
+
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <stdexcept>
+#include <string_view>
+#include <sys/types.h>
+#include <sys/uio.h>
+
+/**
+ * single producer, single consumer byte ring in shared memory (memfd), for a client and a server on the same host.
+ * the producer writes with SharedMemoryWriter, the consumer reads with a SharedMemoryInputHandler (SharedMemoryTransport).
+ * a side only makes a syscall to wake up the other one when it sleeps (eventfd), the bytes themselves never go through the kernel.
+ * the ring is given to another process with its 3 file descriptors (fork or SCM_RIGHTS), and mapped again there
+ */
+class SharedMemoryRing {
+public:
+    /**
+     * beginning of the shared memory, the bytes of the ring follow it
+     */
+    struct Header {
+        uint64_t magic;
+        uint64_t capacity;
+        // positions since the creation, never wrapped: head - tail bytes are readable
+        alignas(64) std::atomic<uint64_t> head;
+        alignas(64) std::atomic<uint64_t> tail;
+        // a side who is about to sleep sets its flag, the other side then signals its eventfd
+        alignas(64) std::atomic<uint32_t> readerWaiting;
+        std::atomic<uint32_t> writerWaiting;
+        std::atomic<uint32_t> writerClosed;
+        std::atomic<uint32_t> readerClosed;
+    };
+
+private:
+    int _memoryFd;
+    // signaled when bytes are written, and when space is freed
+    int _dataEventFd;
+    int _spaceEventFd;
+    Header *_header;
+    char *_data;
+    size_t _mappedSize;
+    // read once when mapped, the header can be written by the other process
+    size_t _capacity;
+
+    void map();
+
+public:
+    /**
+     * creates a ring of capacity bytes.
+     * throws std::invalid_argument if capacity is not a power of two, std::runtime_error if the shared memory can't be created
+     */
+    explicit SharedMemoryRing(size_t capacity);
+
+    /**
+     * maps a ring created by another process from its file descriptors, owned by the ring from now on.
+     * throws std::runtime_error if they are not a ring, or if its capacity is not a power of two matching the size of the memory
+     */
+    SharedMemoryRing(int memoryFd, int dataEventFd, int spaceEventFd);
+
+    ~SharedMemoryRing();
+
+    SharedMemoryRing(const SharedMemoryRing &) = delete;
+    SharedMemoryRing &operator=(const SharedMemoryRing &) = delete;
+
+    int memoryFd() const { return _memoryFd; }
+
+    int dataEventFd() const { return _dataEventFd; }
+
+    int spaceEventFd() const { return _spaceEventFd; }
+
+    size_t capacity() const { return _capacity; }
+
+    Header &header() { return *_header; }
+
+    char *data() { return _data; }
+
+    /**
+     * wakes up the side waiting on eventFd, returns true on error
+     */
+    static bool signal(int eventFd);
+
+    /**
+     * waits until eventFd is signaled, like poll: 1 if signaled, 0 on timeout, -1 on error
+     */
+    static int waitSignal(int eventFd, int timeout);
+};
+
+/**
+ * producer side of a ring, not thread safe
+ */
+class SharedMemoryWriter {
+    SharedMemoryRing &_ring;
+    size_t _syscalls = 0;
+
+    /**
+     * bytes written and not read yet.
+     * returns true (errno is EPROTO) if the positions of the header are more than the capacity apart, only possible if it was corrupted
+     */
+    bool usedBytes(size_t &used);
+
+    /**
+     * copies at most message.size() bytes into the free space, returns the number of bytes copied
+     */
+    size_t copyIn(std::string_view message, size_t freeSpace);
+
+    /**
+     * blocks until the reader frees some space or until the deadline.
+     * returns:
+     *  - 0 if some space is free
+     *  - 1 on error
+     *  - 2 if the reader is closed
+     *  - 3 on timeout
+     */
+    int waitForSpace(int timeout, std::chrono::steady_clock::time_point deadline);
+
+public:
+    explicit SharedMemoryWriter(SharedMemoryRing &ring) : _ring{ring} {}
+
+    /**
+     * closes the writer, see close
+     */
+    ~SharedMemoryWriter() { close(); }
+
+    /**
+     * copies message into the ring, entirely or not at all if retryIfFull is false.
+     * if retryIfFull is true, waits (without spinning) for the reader to free space, the message can be bigger than the ring.
+     * timeout is the maximum time to wait in milliseconds, negative means no timeout.
+     * returns:
+     *  - 0 if no errors
+     *  - 1 if the ring doesn't have enough free space (errno is EAGAIN), or on error (errno is EPROTO if the header was corrupted)
+     *  - 2 if the reader is closed
+     *  - 3 on timeout, part of the message can be written
+     */
+    int write(std::string_view message, bool retryIfFull = false, int timeout = -1);
+
+    /**
+     * the reader receives the end of the stream (like a closed socket) once it has read everything
+     */
+    void close();
+
+    size_t syscalls() const { return _syscalls; }
+};
+
+/**
+ * consumer side of a ring, a transport (see network_transport.hpp): the end of the stream is a closed writer.
+ * receive fails with EPROTO if the positions of the header are more than the capacity apart, nothing is copied then
+ */
+class SharedMemoryTransport {
+    SharedMemoryRing *_ring;
+    size_t _syscalls = 0;
+
+    /**
+     * frees length bytes read and wakes up the writer if it waits for space
+     */
+    void release(size_t length);
+
+public:
+    explicit SharedMemoryTransport(SharedMemoryRing &ring) : _ring{&ring} {}
+
+    SharedMemoryTransport(SharedMemoryTransport &&other) : _ring{other._ring}, _syscalls{other._syscalls} { other._ring = nullptr; }
+
+    SharedMemoryTransport &operator=(SharedMemoryTransport &&) = delete;
+
+    /**
+     * closes the reader side, the writer gets 2 from then on
+     */
+    ~SharedMemoryTransport();
+
+    int id() const { return _ring->memoryFd(); }
+
+    ssize_t receive(char *buffer, size_t length) {
+        iovec vector = {buffer, length};
+        return receive(&vector, 1);
+    }
+
+    bool receivesVectors() const { return true; }
+
+    ssize_t receive(const iovec *vectors, int count);
+
+    int wait(int timeout);
+
+    size_t pendingBytes() {
+        SharedMemoryRing::Header &header = _ring->header();
+        size_t pending = header.head.load(std::memory_order_acquire) - header.tail.load(std::memory_order_relaxed);
+        return pending <= _ring->capacity() ? pending : 0;
+    }
+
+    size_t syscalls() const { return _syscalls; }
+};
+
+#endif // SHARED_MEMORY_RING_HPP
@@ -0,0 +1,151 @@
+#include "slab_pool.hpp"
+#include <unordered_set>
+
+namespace {
+    // free slabs a thread keeps for each pool
+    const size_t MAX_LOCAL_SLABS = 8;
+
+    std::atomic<uint64_t> nextPoolId = 1;
+    // pools alive, the slabs a thread kept for a destroyed pool are freed instead of given back
+    std::mutex livePoolsMutex;
+    std::unordered_set<uint64_t> livePools;
+
+    void freeSlabs(std::vector<char *> &slabs) {
+        for (char *slab : slabs) {
+            delete[] slab;
+        }
+        slabs.clear();
+    }
+} // namespace
+
+SlabPool::SlabPool(size_t slabSize, size_t maxFreeSlabs)
+    : _id{nextPoolId++}, _slabSize{slabSize}, _maxFreeSlabs{maxFreeSlabs}, _maxLocalSlabs{std::min(maxFreeSlabs, MAX_LOCAL_SLABS)} {
+    if (_slabSize <= 0) throw std::invalid_argument("slab size should be greater than 0");
+    std::lock_guard<std::mutex> lock(livePoolsMutex);
+    livePools.insert(_id);
+}
+
+SlabPool::~SlabPool() {
+    {
+        std::lock_guard<std::mutex> lock(livePoolsMutex);
+        livePools.erase(_id);
+    }
+    std::vector<LocalSlabs> *threadLocalSlabs = threadSlabs();
+    if (threadLocalSlabs) {
+        std::erase_if(*threadLocalSlabs, [this](LocalSlabs &local) {
+            if (local.poolId != _id) return false;
+            freeSlabs(local.slabs);
+            return true;
+        });
+    }
+    freeSlabs(_freeSlabs);
+}
+
+SlabPool &SlabPool::global() {
+    static SlabPool pool(16 * 1024);
+    return pool;
+}
+
+std::vector<SlabPool::LocalSlabs> *SlabPool::threadSlabs() {
+    // trivially destructible, still readable by the pools destroyed after the slabs of the thread (static ones)
+    thread_local bool exiting = false;
+    struct ThreadSlabs {
+        std::vector<LocalSlabs> pools;
+
+        ~ThreadSlabs() {
+            exiting = true;
+            std::lock_guard<std::mutex> lock(livePoolsMutex);
+            for (LocalSlabs &local : pools) {
+                if (livePools.count(local.poolId)) local.pool->spill(local, local.slabs.size());
+                else freeSlabs(local.slabs);
+            }
+        }
+    };
+    if (exiting) return nullptr;
+    thread_local ThreadSlabs threadLocalSlabs;
+    return &threadLocalSlabs.pools;
+}
+
+SlabPool::LocalSlabs *SlabPool::localSlabs() {
+    std::vector<LocalSlabs> *threadLocalSlabs = threadSlabs();
+    if (!threadLocalSlabs) return nullptr;
+    for (LocalSlabs &local : *threadLocalSlabs) {
+        if (local.poolId == _id) return &local;
+    }
+    // first use of the pool by this thread, the slabs of the pools destroyed since are freed
+    std::lock_guard<std::mutex> lock(livePoolsMutex);
+    std::erase_if(*threadLocalSlabs, [](LocalSlabs &local) {
+        if (livePools.count(local.poolId)) return false;
+        freeSlabs(local.slabs);
+        return true;
+    });
+    return &threadLocalSlabs->emplace_back(LocalSlabs{_id, this, {}});
+}
+
+void SlabPool::refill(LocalSlabs &local, size_t count) {
+    std::lock_guard<std::mutex> lock(_mutex);
+    _sharedBorrows++;
+    count = std::min(count, _freeSlabs.size());
+    if (count == 0) {
+        _allocations++;
+        _allocatedSlabs++;
+        local.slabs.push_back(new char[_slabSize]);
+        return;
+    }
+    local.slabs.insert(local.slabs.end(), _freeSlabs.end() - count, _freeSlabs.end());
+    _freeSlabs.resize(_freeSlabs.size() - count);
+}
+
+void SlabPool::spill(LocalSlabs &local, size_t count) {
+    std::lock_guard<std::mutex> lock(_mutex);
+    for (size_t i = 0; i < count; i++) {
+        char *slab = local.slabs.back();
+        local.slabs.pop_back();
+        if (_freeSlabs.size() < _maxFreeSlabs) {
+            _freeSlabs.push_back(slab);
+            continue;
+        }
+        _allocatedSlabs--;
+        delete[] slab;
+    }
+}
+
+char *SlabPool::borrow() {
+    _borrows.fetch_add(1, std::memory_order_relaxed);
+    size_t borrowed = _borrowedSlabs.fetch_add(1, std::memory_order_relaxed) + 1;
+    size_t peak = _peakBorrowedSlabs.load(std::memory_order_relaxed);
+    while (borrowed > peak && !_peakBorrowedSlabs.compare_exchange_weak(peak, borrowed, std::memory_order_relaxed)) {
+    }
+    LocalSlabs *local = localSlabs();
+    if (!local) {
+        LocalSlabs exiting{_id, this, {}};
+        refill(exiting, 1);
+        return exiting.slabs.back();
+    }
+    // half of the local capacity, the other half is left for the slabs given back
+    if (local->slabs.empty()) refill(*local, std::max<size_t>(1, _maxLocalSlabs / 2));
+    char *slab = local->slabs.back();
+    local->slabs.pop_back();
+    return slab;
+}
+
+void SlabPool::giveBack(char *slab) {
+    _borrowedSlabs.fetch_sub(1, std::memory_order_relaxed);
+    LocalSlabs *local = localSlabs();
+    if (!local) {
+        LocalSlabs exiting{_id, this, {slab}};
+        spill(exiting, 1);
+        return;
+    }
+    local->slabs.push_back(slab);
+    // keeps half, so a thread alternating borrows and gives back doesn't take the mutex every time
+    if (local->slabs.size() > _maxLocalSlabs) spill(*local, local->slabs.size() - _maxLocalSlabs / 2);
+}
+
+SlabPool::Statistics SlabPool::statistics() const {
+    std::lock_guard<std::mutex> lock(_mutex);
+    size_t borrowedSlabs = _borrowedSlabs.load();
+    // the slabs kept by the threads are not in the shared list, but they are not borrowed
+    size_t freeSlabs = _allocatedSlabs > borrowedSlabs ? _allocatedSlabs - borrowedSlabs : 0;
+    return {_slabSize, _allocatedSlabs, borrowedSlabs, freeSlabs, _peakBorrowedSlabs.load(), _borrows.load(), _sharedBorrows, _allocations};
+}
@@ -0,0 +1,113 @@
+#ifndef SLAB_POOL_HPP
+#define SLAB_POOL_HPP
+
+#include <algorithm>
+#include <atomic>
+#include <cstdint>
+#include <mutex>
+#include <stdexcept>
+#include <vector>
+
+/**
+ * receive buffers of a fixed size shared between connections (and threads).
+ * a connection only borrows a slab while it has bytes to keep, so idle connections take no buffer.
+ * each thread keeps a few free slabs of its own, so borrowing and giving back don't take the mutex of the shared list every time.
+ */
+class SlabPool {
+public:
+    struct Statistics {
+        size_t slabSize;
+        // slabs allocated by the pool, borrowed or free
+        size_t allocatedSlabs;
+        size_t borrowedSlabs;
+        // in the shared list or kept by a thread
+        size_t freeSlabs;
+        // highest number of slabs borrowed at the same time, the size the pool needs
+        size_t peakBorrowedSlabs;
+        size_t borrows;
+        // borrows who didn't find a slab kept by their thread and took the mutex
+        size_t sharedBorrows;
+        // borrows who needed a new slab
+        size_t allocations;
+    };
+
+private:
+    /**
+     * free slabs kept by a thread for one pool
+     */
+    struct LocalSlabs {
+        uint64_t poolId;
+        SlabPool *pool;
+        std::vector<char *> slabs;
+    };
+
+    // identifies the pool in the thread caches, its address can be reused by another pool
+    uint64_t _id;
+    size_t _slabSize;
+    size_t _maxFreeSlabs;
+    size_t _maxLocalSlabs;
+    // guards the shared list and the counters who are not atomic
+    mutable std::mutex _mutex;
+    std::vector<char *> _freeSlabs;
+    size_t _allocatedSlabs = 0;
+    size_t _sharedBorrows = 0;
+    size_t _allocations = 0;
+    std::atomic<size_t> _borrowedSlabs = 0;
+    std::atomic<size_t> _peakBorrowedSlabs = 0;
+    std::atomic<size_t> _borrows = 0;
+
+    /**
+     * slabs kept by the calling thread for every pool, nullptr once the thread is exiting
+     */
+    static std::vector<LocalSlabs> *threadSlabs();
+
+    /**
+     * slabs kept by the calling thread for this pool, created if needed. nullptr once the thread is exiting
+     */
+    LocalSlabs *localSlabs();
+
+    /**
+     * moves at most count slabs from the shared list to local, or a new one if the list is empty
+     */
+    void refill(LocalSlabs &local, size_t count);
+
+    /**
+     * moves count slabs of local to the shared list, the ones above maxFreeSlabs are freed
+     */
+    void spill(LocalSlabs &local, size_t count);
+
+public:
+    /**
+     * at most maxFreeSlabs slabs are kept in the shared list when given back, the others are freed.
+     * each thread keeps at most min(maxFreeSlabs, 8) more.
+     * throws std::invalid_argument if slabSize is 0
+     */
+    SlabPool(size_t slabSize, size_t maxFreeSlabs = SIZE_MAX);
+
+    /**
+     * every slab must have been given back.
+     * the slabs kept by other threads are freed when they exit, or when they use another new pool
+     */
+    ~SlabPool();
+
+    SlabPool(const SlabPool &) = delete;
+    SlabPool &operator=(const SlabPool &) = delete;
+
+    /**
+     * pool used by default, with slabs of 16 KiB
+     */
+    static SlabPool &global();
+
+    size_t slabSize() const { return _slabSize; }
+
+    /**
+     * returns an uninitialized slab of slabSize bytes
+     */
+    char *borrow();
+
+    void giveBack(char *slab);
+
+    Statistics statistics() const;
+};
+
+#endif // SLAB_POOL_HPP
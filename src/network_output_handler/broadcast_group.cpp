@@ -0,0 +1,31 @@
+#include "broadcast_group.hpp"
+
+bool BroadcastGroup::subscribe(NetworkOutputHandler &output) {
+    if (std::find(_subscribers.begin(), _subscribers.end(), &output) != _subscribers.end()) return true;
+    _subscribers.push_back(&output);
+    return false;
+}
+
+bool BroadcastGroup::unsubscribe(NetworkOutputHandler &output) {
+    auto it = std::find(_subscribers.begin(), _subscribers.end(), &output);
+    if (it == _subscribers.end()) return true;
+    _subscribers.erase(it);
+    return false;
+}
+
+void BroadcastGroup::broadcast(NetworkOutputHandler::SharedBuffer frame, const ErrorCallback &onError) {
+    // copy of the list, onError can unsubscribe
+    std::vector<NetworkOutputHandler *> subscribers = onError ? _subscribers : std::vector<NetworkOutputHandler *>();
+    const std::vector<NetworkOutputHandler *> &outputs = onError ? subscribers : _subscribers;
+    for (NetworkOutputHandler *output : outputs) {
+        int errorCode = output->write(frame);
+        // a full socket is not an error, the frame stays queued
+        if (errorCode && !(errorCode == 1 && (errno == EAGAIN || errno == EWOULDBLOCK)) && onError) onError(*output, errorCode);
+    }
+}
+
+NetworkOutputHandler::SharedBuffer BroadcastGroup::broadcast(std::string &&frame, const ErrorCallback &onError) {
+    NetworkOutputHandler::SharedBuffer buffer = std::make_shared<const std::string>(std::move(frame));
+    broadcast(buffer, onError);
+    return buffer;
+}
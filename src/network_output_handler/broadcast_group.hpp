@@ -0,0 +1,49 @@
+#ifndef BROADCAST_GROUP_HPP
+#define BROADCAST_GROUP_HPP
+
+#include "network_output_handler.hpp"
+#include <algorithm>
+#include <functional>
+#include <vector>
+
+/**
+ * sends the same frame to many output handlers: the frame is stored once in a shared buffer,
+ * and each handler queues a reference to it.
+ * the handlers are not owned and must be unsubscribed before being destroyed
+ */
+class BroadcastGroup {
+public:
+    /**
+     * called when the write of a subscriber returns an error code
+     */
+    using ErrorCallback = std::function<void(NetworkOutputHandler &output, int errorCode)>;
+
+private:
+    std::vector<NetworkOutputHandler *> _subscribers;
+
+public:
+    /**
+     * returns true if output is already subscribed
+     */
+    bool subscribe(NetworkOutputHandler &output);
+
+    /**
+     * returns true if output is not subscribed
+     */
+    bool unsubscribe(NetworkOutputHandler &output);
+
+    size_t subscribersCount() const { return _subscribers.size(); }
+
+    /**
+     * queues frame on every subscriber, which flushes it if its flush threshold is reached.
+     * a subscriber can be unsubscribed from onError
+     */
+    void broadcast(NetworkOutputHandler::SharedBuffer frame, const ErrorCallback &onError = nullptr);
+
+    /**
+     * same as above, frame is moved into a shared buffer
+     */
+    NetworkOutputHandler::SharedBuffer broadcast(std::string &&frame, const ErrorCallback &onError = nullptr);
+};
+
+#endif // BROADCAST_GROUP_HPP
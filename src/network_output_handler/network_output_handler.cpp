@@ -0,0 +1,182 @@
+#include "network_output_handler.hpp"
+
+namespace {
+    // messages given to a single sendmsg
+    const size_t MAX_VECTORS = IOV_MAX < 1024 ? IOV_MAX : 1024;
+    // maximum time the destructor waits for the zero copy completions, in milliseconds
+    const int ZERO_COPY_DRAIN_TIMEOUT = 1000;
+} // namespace
+
+NetworkOutputHandler::NetworkOutputHandler(int socket, size_t flushThreshold) : _socket{socket}, _flushThreshold{flushThreshold} {
+    if (_flushThreshold <= 0) throw std::invalid_argument("flush threshold should be greater than 0");
+}
+
+NetworkOutputHandler::~NetworkOutputHandler() {
+    if (_zeroCopyPending.empty() || waitZeroCopyBuffers(ZERO_COPY_DRAIN_TIMEOUT) == 0) return;
+    // the kernel can still read these pages, a leak is better than sending memory reused by something else
+    for (std::pair<uint32_t, SharedBuffer> &pending : _zeroCopyPending) {
+        new SharedBuffer(std::move(pending.second));
+    }
+}
+
+void NetworkOutputHandler::consume(size_t length) {
+    _queuedBytes -= length;
+    while (length > 0) {
+        size_t remaining = _queue.front()->size() - _offset;
+        if (length < remaining) {
+            _offset += length;
+            return;
+        }
+        length -= remaining;
+        _queue.pop_front();
+        _offset = 0;
+    }
+}
+
+ssize_t NetworkOutputHandler::send() {
+    iovec vectors[MAX_VECTORS];
+    size_t count = 0;
+    bool zeroCopy = isZeroCopied(_queue.front(), _offset);
+    for (auto it = _queue.begin(); it != _queue.end() && count < MAX_VECTORS; it++, count++) {
+        size_t offset = count == 0 ? _offset : 0;
+        // a zero copy message is sent alone, so the buffer to keep is known
+        if (count > 0 && (zeroCopy || isZeroCopied(*it, 0))) break;
+        vectors[count] = {const_cast<char *>((*it)->data()) + offset, (*it)->size() - offset};
+    }
+    msghdr message = {};
+    message.msg_iov = vectors;
+    message.msg_iovlen = count;
+    _syscalls++;
+    // MSG_NOSIGNAL: a closed socket is reported by the return value instead of SIGPIPE
+    ssize_t bytesSent = sendmsg(_socket, &message, MSG_NOSIGNAL | (zeroCopy ? MSG_ZEROCOPY : 0));
+    if (zeroCopy && bytesSent == -1 && errno == ENOBUFS) {
+        NETWORK_TRACE_EVENT(ZERO_COPY_FALLBACK, _socket, 0);
+        _syscalls++;
+        return sendmsg(_socket, &message, MSG_NOSIGNAL);
+    }
+    if (zeroCopy && bytesSent > 0) _zeroCopyPending.emplace_back(_zeroCopyNextId++, _queue.front());
+    return bytesSent;
+}
+
+bool NetworkOutputHandler::enableZeroCopy(size_t minSize) {
+    int enable = 1;
+    if (minSize <= 0 || setsockopt(_socket, SOL_SOCKET, SO_ZEROCOPY, &enable, sizeof(enable)) == -1) {
+        NETWORK_TRACE_EVENT(ZERO_COPY_UNSUPPORTED, _socket, minSize <= 0 ? EINVAL : errno);
+        return true;
+    }
+    _zeroCopyMinSize = minSize;
+    return false;
+}
+
+void NetworkOutputHandler::releaseZeroCopyBuffers() {
+    while (!_zeroCopyPending.empty()) {
+        char control[128];
+        msghdr message = {};
+        message.msg_control = control;
+        message.msg_controllen = sizeof(control);
+        _syscalls++;
+        // the completions are in the error queue of the socket, each one is a range of sendmsg ids
+        if (recvmsg(_socket, &message, MSG_ERRQUEUE | MSG_DONTWAIT) == -1) return;
+
+        for (cmsghdr *header = CMSG_FIRSTHDR(&message); header != nullptr; header = CMSG_NXTHDR(&message, header)) {
+            if (!(header->cmsg_level == SOL_IP && header->cmsg_type == IP_RECVERR) && !(header->cmsg_level == SOL_IPV6 && header->cmsg_type == IPV6_RECVERR))
+                continue;
+            const sock_extended_err *error = reinterpret_cast<const sock_extended_err *>(CMSG_DATA(header));
+            if (error->ee_errno != 0 || error->ee_origin != SO_EE_ORIGIN_ZEROCOPY) continue;
+            if (error->ee_code & SO_EE_CODE_ZEROCOPY_COPIED) NETWORK_TRACE_EVENT(ZERO_COPY_COPIED, _socket, error->ee_data - error->ee_info + 1);
+            else NETWORK_TRACE_EVENT(ZERO_COPY_DONE, _socket, error->ee_data - error->ee_info + 1);
+            // ids wrap around, compared as a signed difference
+            while (!_zeroCopyPending.empty() && static_cast<int32_t>(error->ee_data - _zeroCopyPending.front().first) >= 0) {
+                _zeroCopyPending.pop_front();
+            }
+        }
+    }
+}
+
+int NetworkOutputHandler::waitZeroCopyBuffers(int timeout) {
+    std::chrono::steady_clock::time_point deadline = std::chrono::steady_clock::now() + std::chrono::milliseconds(timeout);
+    // POLLERR is always reported, it tells the error queue has completions
+    pollfd pollSocket = {_socket, 0, 0};
+    int ready = 0;
+    while (true) {
+        size_t pending = _zeroCopyPending.size();
+        releaseZeroCopyBuffers();
+        if (_zeroCopyPending.empty()) return 0;
+        if (ready > 0 && _zeroCopyPending.size() == pending) {
+            // woken up without completion: closed socket, or an error who would wake up poll forever
+            int error = 0;
+            socklen_t errorLength = sizeof(error);
+            // fails with EBADF if the socket has been closed
+            if (getsockopt(_socket, SOL_SOCKET, SO_ERROR, &error, &errorLength) == -1) return 1;
+            if (error != 0 || pollSocket.revents & POLLHUP) {
+                errno = error != 0 ? error : EPIPE;
+                return 1;
+            }
+        }
+        int remaining = -1;
+        if (timeout >= 0) {
+            remaining = std::chrono::ceil<std::chrono::milliseconds>(deadline - std::chrono::steady_clock::now()).count();
+            if (remaining <= 0) return 3;
+        }
+        _syscalls++;
+        ready = poll(&pollSocket, 1, remaining);
+        if (ready == 0) return 3;
+        if (ready == -1 && errno != EINTR) return 1;
+    }
+}
+
+int NetworkOutputHandler::waitForSpace(int timeout, std::chrono::steady_clock::time_point deadline) {
+    pollfd pollSocket = {_socket, POLLOUT, 0};
+    while (true) {
+        int remaining = -1;
+        if (timeout >= 0) {
+            remaining = std::chrono::ceil<std::chrono::milliseconds>(deadline - std::chrono::steady_clock::now()).count();
+            if (remaining <= 0) return 3;
+        }
+        NETWORK_TRACE_EVENT(WAIT, _socket, remaining);
+        _syscalls++;
+        int ready = poll(&pollSocket, 1, remaining);
+        if (ready > 0) return 0; // writable, closed or in error, sendmsg will tell
+        if (ready == 0) return 3;
+        if (errno != EINTR) return 1;
+    }
+}
+
+int NetworkOutputHandler::write(std::string_view message) { return write(std::string(message)); }
+
+int NetworkOutputHandler::write(std::string &&message) {
+    if (message.empty()) return 0;
+    return write(std::make_shared<const std::string>(std::move(message)));
+}
+
+int NetworkOutputHandler::write(SharedBuffer buffer) {
+    if (!buffer || buffer->empty()) return 0;
+    _queuedBytes += buffer->size();
+    _queue.push_back(std::move(buffer));
+    if (_queuedBytes < _flushThreshold) return 0;
+    NETWORK_TRACE_EVENT(FLUSH, _socket, _queuedBytes);
+    return flush();
+}
+
+int NetworkOutputHandler::flush(bool retryIfFull, int timeout) {
+    std::chrono::steady_clock::time_point deadline = std::chrono::steady_clock::now() + std::chrono::milliseconds(timeout);
+    releaseZeroCopyBuffers();
+
+    while (_queuedBytes > 0) {
+        ssize_t bytesSent = send();
+        if (bytesSent == -1) {
+            NETWORK_TRACE_EVENT(SEND_ERROR, _socket, errno);
+            if (errno == EINTR) continue;
+            if (errno == EPIPE || errno == ECONNRESET) return 2;
+            if (retryIfFull && (errno == EAGAIN || errno == EWOULDBLOCK)) {
+                int errorCode = waitForSpace(timeout, deadline);
+                if (errorCode) return errorCode;
+                continue;
+            }
+            return 1;
+        }
+        NETWORK_TRACE_EVENT(SEND, _socket, bytesSent);
+        consume(bytesSent);
+    }
+    return 0;
+}
@@ -0,0 +1,152 @@
+#ifndef NETWORK_OUTPUT_HANDLER_HPP
+#define NETWORK_OUTPUT_HANDLER_HPP
+
+#include "../network_trace/network_trace.hpp"
+#include <cerrno>
+#include <chrono>
+#include <climits>
+#include <cstdint>
+#include <deque>
+#include <linux/errqueue.h>
+#include <memory>
+#include <netinet/in.h>
+#include <poll.h>
+#include <stdexcept>
+#include <string>
+#include <string_view>
+#include <sys/socket.h>
+#include <sys/uio.h>
+#include <utility>
+
+/**
+ * queues messages and sends them together, with one sendmsg for many messages.
+ * the queue is flushed by flush (once per tick for example) or when it reaches flushThreshold bytes.
+ */
+class NetworkOutputHandler {
+public:
+    /**
+     * immutable message queued by reference, the same buffer can be queued on many handlers without copy
+     */
+    using SharedBuffer = std::shared_ptr<const std::string>;
+
+private:
+    int _socket;
+    size_t _flushThreshold;
+    std::deque<SharedBuffer> _queue;
+    // bytes of the first message of the queue already sent
+    size_t _offset = 0;
+    size_t _queuedBytes = 0;
+    size_t _syscalls = 0;
+    // messages of at least this size are sent with MSG_ZEROCOPY, 0 if disabled
+    size_t _zeroCopyMinSize = 0;
+    uint32_t _zeroCopyNextId = 0;
+    // buffers the kernel can still read, with the id of the sendmsg who sent them
+    std::deque<std::pair<uint32_t, SharedBuffer>> _zeroCopyPending;
+
+    bool isZeroCopied(const SharedBuffer &buffer, size_t offset) const { return _zeroCopyMinSize > 0 && buffer->size() - offset >= _zeroCopyMinSize; }
+
+    /**
+     * removes length sent bytes from the front of the queue
+     */
+    void consume(size_t length);
+
+    /**
+     * sends as many queued bytes as the socket takes.
+     * returns the value returned by sendmsg
+     */
+    ssize_t send();
+
+    /**
+     * blocks until the socket is writable or until the deadline (only checked if timeout is not negative).
+     * returns:
+     *  - 0 if the socket is writable
+     *  - 1 on error
+     *  - 3 on timeout
+     */
+    int waitForSpace(int timeout, std::chrono::steady_clock::time_point deadline);
+
+public:
+    /**
+     * throws std::invalid_argument if flushThreshold is 0
+     */
+    NetworkOutputHandler(int socket, size_t flushThreshold = 64 * 1024);
+
+    /**
+     * waits up to a second for the kernel to be done with the zero copy buffers, the socket should still be open.
+     * the buffers still pending after that are leaked rather than freed while the kernel can read them
+     */
+    ~NetworkOutputHandler();
+
+    NetworkOutputHandler(const NetworkOutputHandler &) = delete;
+    NetworkOutputHandler &operator=(const NetworkOutputHandler &) = delete;
+
+    /**
+     * queues message, and flushes the queue without waiting if it reaches flushThreshold bytes.
+     * returns the value returned by flush, or 0 if the queue has not been flushed
+     */
+    int write(std::string_view message);
+
+    int write(std::string &&message);
+
+    int write(const char *message) { return write(std::string_view(message)); }
+
+    /**
+     * queues buffer by reference, it is kept alive until sent
+     */
+    int write(SharedBuffer buffer);
+
+    /**
+     * sends the messages of at least minSize bytes with MSG_ZEROCOPY: the kernel reads them from the shared buffer instead of copying them.
+     * the buffers are kept until the kernel tells they have been sent, which is checked by flush, releaseZeroCopyBuffers and waitZeroCopyBuffers.
+     * only tcp and udp sockets support it.
+     * returns true if the socket doesn't support zero copy, messages are copied in this case
+     */
+    bool enableZeroCopy(size_t minSize = 64 * 1024);
+
+    /**
+     * releases the buffers the kernel is done with, without waiting
+     */
+    void releaseZeroCopyBuffers();
+
+    /**
+     * waits (without spinning) until the kernel is done with every zero copy buffer, to reuse or close the socket.
+     * timeout is the maximum time to wait in milliseconds, negative means no timeout.
+     * returns:
+     *  - 0 if no buffer is pending anymore
+     *  - 1 on error
+     *  - 3 on timeout
+     */
+    int waitZeroCopyBuffers(int timeout = -1);
+
+    /**
+     * buffers sent with MSG_ZEROCOPY and still used by the kernel
+     */
+    size_t zeroCopyPending() const { return _zeroCopyPending.size(); }
+
+    /**
+     * sends the queued messages, partial writes are continued by the next call.
+     * if retryIfFull is true, waits (without spinning) until the socket takes every byte.
+     * timeout is the maximum time to wait in milliseconds for the whole call, negative means no timeout.
+     * returns:
+     *  - 0 if every queued byte has been sent
+     *  - 1 on error, or if the socket is non-blocking and full (errno is EAGAIN)
+     *  - 2 on socket closed
+     *  - 3 on timeout
+     * the bytes not sent stay queued
+     */
+    int flush(bool retryIfFull = false, int timeout = -1);
+
+    /**
+     * bytes written and not sent yet, to slow down or drop a client who doesn't read fast enough
+     */
+    size_t queuedBytes() const { return _queuedBytes; }
+
+    size_t queuedMessages() const { return _queue.size(); }
+
+    /**
+     * number of syscalls done to send or wait since the creation of the handler
+     */
+    size_t syscalls() const { return _syscalls; }
+};
+
+#endif // NETWORK_OUTPUT_HANDLER_HPP
@@ -0,0 +1,169 @@
+#include "network_reactor.hpp"
+
+NetworkReactor::NetworkReactor(size_t bufferSize, size_t maxEvents)
+    : _epoll{epoll_create1(EPOLL_CLOEXEC)}, _wakeup{eventfd(0, EFD_NONBLOCK | EFD_CLOEXEC)}, _bufferSize{bufferSize}, _maxEvents{maxEvents} {
+    if (_bufferSize <= 0) throw std::invalid_argument("buffer size should be greater than 0");
+    if (_maxEvents <= 0) throw std::invalid_argument("max events should be greater than 0");
+    if (_epoll == -1 || _wakeup == -1) {
+        if (_epoll != -1) close(_epoll);
+        if (_wakeup != -1) close(_wakeup);
+        throw std::runtime_error("can't create epoll instance");
+    }
+    epoll_event event = {};
+    event.events = EPOLLIN;
+    event.data.fd = _wakeup;
+    if (epoll_ctl(_epoll, EPOLL_CTL_ADD, _wakeup, &event) == -1) {
+        close(_epoll);
+        close(_wakeup);
+        throw std::runtime_error("can't register wakeup event");
+    }
+    _events.resize(_maxEvents);
+}
+
+NetworkReactor::~NetworkReactor() {
+    for (const auto &connection : _connections) {
+        close(connection.first);
+    }
+    close(_wakeup);
+    close(_epoll);
+}
+
+bool NetworkReactor::add(std::unique_ptr<Connection> connection) {
+    int socket = connection->socket;
+    if (_connections.contains(socket)) return true;
+
+    int flags = fcntl(socket, F_GETFL, 0);
+    if (flags == -1 || fcntl(socket, F_SETFL, flags | O_NONBLOCK) == -1) return true;
+
+    epoll_event event = {};
+    event.events = EPOLLIN | EPOLLRDHUP | EPOLLET;
+    event.data.fd = socket;
+    if (epoll_ctl(_epoll, EPOLL_CTL_ADD, socket, &event) == -1) return true;
+
+    Connection *added = connection.get();
+    _connections.emplace(socket, std::move(connection));
+    // bytes received before the registration don't trigger an edge
+    dispatch(added, 0);
+    return false;
+}
+
+bool NetworkReactor::addFixedLength(int socket, size_t length, MessageCallback callback) {
+    std::unique_ptr<Connection> connection(new Connection{socket, NetworkInputHandler(socket, _bufferSize), std::move(callback), length, "", false});
+    if (_receiveLowWatermark && connection->inputHandler.useReceiveLowWatermark()) return true;
+    return add(std::move(connection));
+}
+
+bool NetworkReactor::addDelimited(int socket, std::string_view delimiter, MessageCallback callback, bool includeDelimiter) {
+    if (delimiter.empty()) return true;
+    return add(std::unique_ptr<Connection>(
+        new Connection{socket, NetworkInputHandler(socket, _bufferSize), std::move(callback), 0, std::string(delimiter), includeDelimiter}));
+}
+
+bool NetworkReactor::addListener(int socket, AcceptCallback callback) {
+    std::unique_ptr<Connection> connection(new Connection{socket, NetworkInputHandler(socket, 1), nullptr, 0, "", false});
+    connection->acceptCallback = std::move(callback);
+    return add(std::move(connection));
+}
+
+bool NetworkReactor::remove(int socket) {
+    std::unordered_map<int, std::unique_ptr<Connection>>::iterator it = _connections.find(socket);
+    if (it == _connections.end()) return true;
+    epoll_ctl(_epoll, EPOLL_CTL_DEL, socket, nullptr);
+    close(socket);
+    it->second->removed = true;
+    _removedConnections.push_back(std::move(it->second));
+    _connections.erase(it);
+    return false;
+}
+
+void NetworkReactor::setCloseCallback(CloseCallback callback) { _closeCallback = std::move(callback); }
+
+void NetworkReactor::closeConnection(Connection *connection) {
+    if (_closeCallback) _closeCallback(connection->socket);
+    if (!connection->removed) remove(connection->socket);
+}
+
+void NetworkReactor::acceptConnections(Connection *listener) {
+    while (true) {
+        int socket = accept4(listener->socket, nullptr, nullptr, SOCK_NONBLOCK | SOCK_CLOEXEC);
+        if (socket == -1) {
+            if (errno == ECONNABORTED || errno == EINTR) continue;
+            if (errno != EAGAIN && errno != EWOULDBLOCK) NETWORK_TRACE_EVENT(ACCEPT_ERROR, listener->socket, errno);
+            return;
+        }
+        listener->acceptCallback(socket);
+        if (listener->removed) return;
+    }
+}
+
+void NetworkReactor::dispatch(Connection *connection, uint32_t events) {
+    if (connection->acceptCallback) {
+        acceptConnections(connection);
+        return;
+    }
+    std::string_view message;
+    int errorCode;
+    NetworkInputHandler::BatchCallback batchCallback = [connection](std::string_view message) {
+        connection->callback(connection->socket, message);
+        return !connection->removed;
+    };
+
+    while (true) {
+        // a short recv doesn't set errno, so 0 after an error means that every received byte has been read
+        errno = 0;
+        if (connection->delimiter.empty()) {
+            errorCode = connection->inputHandler.readView(connection->length, message);
+            if (errorCode == 0) connection->callback(connection->socket, message);
+        }
+        else {
+            // every pipelined message already received is given without going back through recv
+            errorCode = connection->inputHandler.readAllUntilDelimiter(connection->delimiter, batchCallback, connection->includeDelimiter);
+        }
+
+        if (errorCode == 0) {
+            if (connection->removed) return;
+            continue;
+        }
+        if (errorCode == 1 && (errno == 0 || errno == EAGAIN || errno == EWOULDBLOCK) && !(events & EPOLLERR)) {
+            // no complete message left, wait for the next edge
+            return;
+        }
+        NETWORK_TRACE_EVENT(CONNECTION_ENDED, connection->socket, errorCode);
+        closeConnection(connection);
+        return;
+    }
+}
+
+int NetworkReactor::runOnce(int timeout) {
+    int eventsCount = epoll_wait(_epoll, _events.data(), _maxEvents, timeout);
+    if (eventsCount == -1) return errno == EINTR ? 0 : -1;
+
+    for (int i = 0; i < eventsCount; i++) {
+        int socket = _events[i].data.fd;
+        if (socket == _wakeup) {
+            eventfd_t value;
+            eventfd_read(_wakeup, &value);
+            _stopped = true;
+            continue;
+        }
+        std::unordered_map<int, std::unique_ptr<Connection>>::iterator it = _connections.find(socket);
+        // removed by a callback of a previous event
+        if (it == _connections.end()) continue;
+        dispatch(it->second.get(), _events[i].events);
+    }
+    _removedConnections.clear();
+    return eventsCount;
+}
+
+int NetworkReactor::run() {
+    while (!_stopped) {
+        if (runOnce() == -1) return 1;
+    }
+    _stopped = false;
+    return 0;
+}
+
+void NetworkReactor::stop() {
+    // _stopped is set by the reactor thread when it receives the wakeup, so it doesn't need to be atomic
+    eventfd_write(_wakeup, 1);
+}
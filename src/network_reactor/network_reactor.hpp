@@ -0,0 +1,145 @@
+#ifndef NETWORK_REACTOR_HPP
+#define NETWORK_REACTOR_HPP
+
+#include "../network_input_handler/network_input_handler.hpp"
+#include <fcntl.h>
+#include <functional>
+#include <memory>
+#include <stdexcept>
+#include <string>
+#include <string_view>
+#include <sys/epoll.h>
+#include <sys/eventfd.h>
+#include <unistd.h>
+#include <unordered_map>
+#include <vector>
+
+/**
+ * drives many sockets from one thread with edge-triggered epoll.
+ * each socket gets its own NetworkInputHandler and a callback called for each complete message.
+ * the reactor owns the registered sockets: they are closed when removed or when the connection ends.
+ */
+class NetworkReactor {
+public:
+    /**
+     * message is only valid during the call
+     */
+    using MessageCallback = std::function<void(int socket, std::string_view message)>;
+    using CloseCallback = std::function<void(int socket)>;
+    using AcceptCallback = std::function<void(int socket)>;
+
+private:
+    struct Connection {
+        int socket;
+        NetworkInputHandler inputHandler;
+        MessageCallback callback;
+        // messages are either of a fixed length, or ends with the delimiter if it is not empty
+        size_t length;
+        std::string delimiter;
+        bool includeDelimiter;
+        bool removed = false;
+        // set for listening sockets, called for each accepted connection
+        AcceptCallback acceptCallback = nullptr;
+    };
+
+    int _epoll;
+    int _wakeup;
+    size_t _bufferSize;
+    size_t _maxEvents;
+    bool _stopped = false;
+    bool _receiveLowWatermark = false;
+    std::vector<epoll_event> _events;
+    std::unordered_map<int, std::unique_ptr<Connection>> _connections;
+    // connections removed while their messages are dispatched, destroyed at the end of the dispatch
+    std::vector<std::unique_ptr<Connection>> _removedConnections;
+    CloseCallback _closeCallback = nullptr;
+
+    /**
+     * returns true in case of error
+     */
+    bool add(std::unique_ptr<Connection> connection);
+
+    /**
+     * reads every complete message available on the connection
+     */
+    void dispatch(Connection *connection, uint32_t events);
+
+    /**
+     * accepts every pending connection of a listening socket
+     */
+    void acceptConnections(Connection *listener);
+
+    void closeConnection(Connection *connection);
+
+public:
+    /**
+     * bufferSize is the buffer size of each NetworkInputHandler,
+     * maxEvents is the maximum number of sockets handled by one epoll_wait
+     * throws std::runtime_error if epoll can't be created
+     */
+    NetworkReactor(size_t bufferSize = 1024, size_t maxEvents = 256);
+    ~NetworkReactor();
+
+    NetworkReactor(const NetworkReactor &) = delete;
+    NetworkReactor &operator=(const NetworkReactor &) = delete;
+
+    /**
+     * fixed length connections added after this call set SO_RCVLOWAT to the bytes missing from their current message
+     * (see NetworkInputHandler::useReceiveLowWatermark): epoll only wakes the reactor once a whole message can be read
+     */
+    void setReceiveLowWatermark(bool enabled) { _receiveLowWatermark = enabled; }
+
+    /**
+     * calls callback for each message of length bytes received on socket.
+     * socket is set to non-blocking.
+     * returns true in case of error
+     */
+    bool addFixedLength(int socket, size_t length, MessageCallback callback);
+
+    /**
+     * calls callback for each message ending with delimiter received on socket.
+     * the delimiter is always removed from the stream, and only given to the callback if includeDelimiter is true.
+     * socket is set to non-blocking.
+     * returns true in case of error
+     */
+    bool addDelimited(int socket, std::string_view delimiter, MessageCallback callback, bool includeDelimiter = false);
+
+    /**
+     * calls callback with each connection accepted on the listening socket.
+     * accepted sockets are non-blocking and not registered, callback can add them to this reactor.
+     * returns true in case of error
+     */
+    bool addListener(int socket, AcceptCallback callback);
+
+    /**
+     * unregisters and closes the socket, can be called from a callback.
+     * returns true if the socket was not registered
+     */
+    bool remove(int socket);
+
+    /**
+     * called after a connection is closed by the peer or on error, before the socket is closed
+     */
+    void setCloseCallback(CloseCallback callback);
+
+    size_t connectionsCount() const { return _connections.size(); }
+
+    /**
+     * waits at most timeout milliseconds (negative means no timeout) for events and dispatches them.
+     * returns the number of events handled, or -1 on error
+     */
+    int runOnce(int timeout = -1);
+
+    /**
+     * dispatches events until stop is called.
+     * returns 0 if stopped, 1 on error
+     */
+    int run();
+
+    /**
+     * makes run return, can be called from any thread
+     */
+    void stop();
+};
+
+#endif // NETWORK_REACTOR_HPP
@@ -0,0 +1,135 @@
+#include "network_trace.hpp"
+#include <algorithm>
+#include <cstring>
+#include <fstream>
+#include <iomanip>
+#include <memory>
+#include <mutex>
+
+namespace networkTrace {
+    namespace {
+        const char MAGIC[4] = {'N', 'T', 'R', 'C'};
+        const uint32_t VERSION = 1;
+
+        struct FileHeader {
+            char magic[4];
+            uint32_t version;
+            uint64_t recordsCount;
+            double ticksPerMicrosecond;
+        };
+
+        struct Registry {
+            std::mutex mutex;
+            std::vector<std::unique_ptr<Ring>> rings;
+            uint64_t startTicks = 0;
+            std::chrono::steady_clock::time_point startTime;
+        };
+
+        Registry &registry() {
+            // never destroyed, threads can record until the end of the process
+            static Registry *registry = new Registry();
+            return *registry;
+        }
+
+        const char *EVENT_NAMES[] = {
+            "recv", "recv error", "socket closed", "incomplete", "delimiter found", "bytes carried over", "buffer reallocated",
+            "buffer size adapted", "wait", "batch left", "direct recv", "io_uring fallback", "oversize message", "flush", "send", "send error",
+            "zero copy fallback", "zero copy unsupported", "zero copy done", "zero copy copied", "accept error", "connection ended",
+            "io_uring setup error", "watch error",
+        };
+        static_assert(sizeof(EVENT_NAMES) / sizeof(EVENT_NAMES[0]) == static_cast<size_t>(Event::COUNT));
+    } // namespace
+
+    const char *eventName(Event event) { return event < Event::COUNT ? EVENT_NAMES[static_cast<size_t>(event)] : "unknown"; }
+
+    Ring *createThreadRing() {
+        Registry &rings = registry();
+        std::lock_guard<std::mutex> lock(rings.mutex);
+        if (rings.rings.empty()) {
+            rings.startTicks = ticks();
+            rings.startTime = std::chrono::steady_clock::now();
+        }
+        rings.rings.push_back(std::make_unique<Ring>());
+        threadRing = rings.rings.back().get();
+        threadRing->thread = static_cast<uint16_t>(rings.rings.size() - 1);
+        return threadRing;
+    }
+
+    std::vector<Record> snapshot() {
+        Registry &rings = registry();
+        std::lock_guard<std::mutex> lock(rings.mutex);
+        std::vector<Record> records;
+        for (const std::unique_ptr<Ring> &ring : rings.rings) {
+            uint64_t written = ring->written.load(std::memory_order_acquire);
+            uint64_t first = written > RING_CAPACITY ? written - RING_CAPACITY : 0;
+            for (uint64_t index = first; index < written; index++) {
+                records.push_back(ring->records[index & (RING_CAPACITY - 1)]);
+            }
+        }
+        std::stable_sort(records.begin(), records.end(), [](const Record &a, const Record &b) { return a.ticks < b.ticks; });
+        return records;
+    }
+
+    void clear() {
+        Registry &rings = registry();
+        std::lock_guard<std::mutex> lock(rings.mutex);
+        for (const std::unique_ptr<Ring> &ring : rings.rings) {
+            ring->written.store(0, std::memory_order_relaxed);
+        }
+    }
+
+    double ticksPerMicrosecond() {
+#if defined(__x86_64__) || defined(__i386__)
+        Registry &rings = registry();
+        std::lock_guard<std::mutex> lock(rings.mutex);
+        if (rings.rings.empty()) return 0;
+        double elapsed = std::chrono::duration<double, std::micro>(std::chrono::steady_clock::now() - rings.startTime).count();
+        return elapsed > 0 ? (ticks() - rings.startTicks) / elapsed : 0;
+#else
+        return 1000;
+#endif
+    }
+
+    bool writeBinary(const std::string &path) {
+        std::vector<Record> records = snapshot();
+        FileHeader header = {};
+        std::memcpy(header.magic, MAGIC, sizeof(MAGIC));
+        header.version = VERSION;
+        header.recordsCount = records.size();
+        header.ticksPerMicrosecond = ticksPerMicrosecond();
+
+        std::ofstream file(path, std::ios::binary);
+        if (!file) return true;
+        file.write(reinterpret_cast<const char *>(&header), sizeof(header));
+        file.write(reinterpret_cast<const char *>(records.data()), records.size() * sizeof(Record));
+        return !file;
+    }
+
+    bool readBinary(const std::string &path, std::vector<Record> &records, double &ticksPerMicrosecond) {
+        std::ifstream file(path, std::ios::binary);
+        FileHeader header;
+        if (!file.read(reinterpret_cast<char *>(&header), sizeof(header))) return true;
+        if (std::memcmp(header.magic, MAGIC, sizeof(MAGIC)) != 0 || header.version != VERSION) return true;
+        records.resize(header.recordsCount);
+        ticksPerMicrosecond = header.ticksPerMicrosecond;
+        return !file.read(reinterpret_cast<char *>(records.data()), records.size() * sizeof(Record));
+    }
+
+    void print(std::ostream &out, const std::vector<Record> &records, double ticksPerMicrosecond) {
+        if (records.empty()) return;
+        uint64_t firstTicks = records.front().ticks;
+        for (const Record &record : records) {
+            if (ticksPerMicrosecond > 0) {
+                out << std::fixed << std::setprecision(3) << std::setw(14) << (record.ticks - firstTicks) / ticksPerMicrosecond << " us";
+            }
+            else {
+                out << std::setw(14) << record.ticks - firstTicks << " ticks";
+            }
+            out << "  thread " << std::setw(3) << record.thread << "  socket " << std::setw(5) << record.socket << "  "
+                << std::left << std::setw(20) << eventName(static_cast<Event>(record.event)) << std::right;
+            if (static_cast<Event>(record.event) == Event::WAIT) out << static_cast<int64_t>(record.value);
+            else out << record.value;
+            out << "\n";
+        }
+    }
+} // namespace networkTrace
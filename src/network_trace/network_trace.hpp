@@ -0,0 +1,155 @@
+#ifndef NETWORK_TRACE_HPP
+#define NETWORK_TRACE_HPP
+
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <ostream>
+#include <string>
+#include <vector>
+#if defined(__x86_64__) || defined(__i386__)
+#include <x86intrin.h>
+#endif
+
+/**
+ * records fixed-size binary events in a ring per thread, without lock nor allocation once the ring of the thread exists.
+ * the library records its events with NETWORK_TRACE_EVENT, compiled out unless built with TRACE=1 (NETWORK_TRACE defined).
+ * a ring keeps the last RING_CAPACITY events of its thread, older ones are overwritten.
+ */
+namespace networkTrace {
+    enum class Event : uint16_t {
+        // value: bytes received
+        RECV,
+        // value: errno of the failed recv (EAGAIN when a non-blocking socket has nothing)
+        RECV_ERROR,
+        SOCKET_CLOSED,
+        // less bytes received than needed for the message, value: bytes kept for the next call
+        INCOMPLETE,
+        // value: length of the message before the delimiter
+        DELIMITER_FOUND,
+        // unread bytes moved to the front of the buffer, value: bytes moved
+        BYTES_CARRIED_OVER,
+        // value: new capacity of the buffer
+        BUFFER_REALLOCATED,
+        // value: new buffer size of the adaptive mode
+        BUFFER_SIZE_ADAPTED,
+        // value: timeout in milliseconds, -1 if none
+        WAIT,
+        // value: bytes left after a batch read
+        BATCH_LEFT,
+        // value: bytes received directly into the output string
+        DIRECT_RECV,
+        IO_URING_FALLBACK,
+        // message longer than the maximum message size, value: bytes of it already received
+        OVERSIZE_MESSAGE,
+        // value: bytes queued when a write reaches the flush threshold
+        FLUSH,
+        // value: bytes sent by one sendmsg
+        SEND,
+        // value: errno of the failed sendmsg (EAGAIN when a non-blocking socket is full)
+        SEND_ERROR,
+        // not enough memory to pin the pages of a zero copy send, sent with a copy
+        ZERO_COPY_FALLBACK,
+        // value: errno of setsockopt(SO_ZEROCOPY)
+        ZERO_COPY_UNSUPPORTED,
+        // value: zero copy sends completed
+        ZERO_COPY_DONE,
+        // zero copy sends completed after a copy by the kernel (loopback for example), value: sends completed
+        ZERO_COPY_COPIED,
+        // value: errno of the failed accept
+        ACCEPT_ERROR,
+        // value: code of the read who ended the connection
+        CONNECTION_ENDED,
+        // value: errno of the failed io_uring setup or buffer registration
+        IO_URING_SETUP_ERROR,
+        // the socket can't be added to epoll, value: errno
+        WATCH_ERROR,
+        COUNT
+    };
+
+    const char *eventName(Event event);
+
+    struct Record {
+        // cpu ticks on x86, steady clock nanoseconds elsewhere
+        uint64_t ticks;
+        uint64_t value;
+        int32_t socket;
+        uint16_t event;
+        // index of the ring, one per thread
+        uint16_t thread;
+    };
+
+    const size_t RING_CAPACITY = 1 << 14;
+
+    /**
+     * written by a single thread, read by snapshot
+     */
+    struct Ring {
+        Record records[RING_CAPACITY];
+        std::atomic<uint64_t> written = 0;
+        uint16_t thread;
+    };
+
+    inline uint64_t ticks() {
+#if defined(__x86_64__) || defined(__i386__)
+        return __rdtsc();
+#else
+        return std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now().time_since_epoch()).count();
+#endif
+    }
+
+    /**
+     * creates the ring of the calling thread, kept until the end of the process so it can be dumped after the thread ends
+     */
+    Ring *createThreadRing();
+
+    inline thread_local Ring *threadRing = nullptr;
+
+    inline void record(Event event, int socket, uint64_t value) {
+        Ring *ring = threadRing ? threadRing : createThreadRing();
+        uint64_t index = ring->written.load(std::memory_order_relaxed);
+        ring->records[index & (RING_CAPACITY - 1)] = {ticks(), value, socket, static_cast<uint16_t>(event), ring->thread};
+        // publishes the record to snapshot
+        ring->written.store(index + 1, std::memory_order_release);
+    }
+
+    /**
+     * events of every thread, oldest first.
+     * a ring written during the call can give records overwritten while being copied
+     */
+    std::vector<Record> snapshot();
+
+    /**
+     * forgets every recorded event, no thread must record during the call
+     */
+    void clear();
+
+    /**
+     * ticks per microsecond, measured between the creation of the first ring and now
+     */
+    double ticksPerMicrosecond();
+
+    /**
+     * writes the snapshot to path, to be decoded by the trace_dump tool.
+     * returns true in case of error
+     */
+    bool writeBinary(const std::string &path);
+
+    /**
+     * returns true in case of error
+     */
+    bool readBinary(const std::string &path, std::vector<Record> &records, double &ticksPerMicrosecond);
+
+    /**
+     * one line per record: time since the first record, thread, socket, event and value
+     */
+    void print(std::ostream &out, const std::vector<Record> &records, double ticksPerMicrosecond);
+} // namespace networkTrace
+
+#ifdef NETWORK_TRACE
+#define NETWORK_TRACE_EVENT(event, socket, value) networkTrace::record(networkTrace::Event::event, socket, static_cast<uint64_t>(value))
+#else
+#define NETWORK_TRACE_EVENT(event, socket, value) ((void)0)
+#endif
+
+#endif // NETWORK_TRACE_HPP
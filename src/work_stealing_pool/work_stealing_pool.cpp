@@ -0,0 +1,95 @@
+#include "work_stealing_pool.hpp"
+
+namespace {
+    // pool and worker index of the current thread, to queue the tasks it submits locally
+    thread_local const WorkStealingPool *currentPool = nullptr;
+    thread_local size_t currentWorker = 0;
+} // namespace
+
+WorkStealingPool::WorkStealingPool(size_t threadsCount) {
+    if (threadsCount <= 0) throw std::invalid_argument("threads count should be greater than 0");
+    for (size_t i = 0; i < threadsCount; i++) {
+        _workers.push_back(std::make_unique<Worker>());
+    }
+    for (size_t i = 0; i < threadsCount; i++) {
+        _threads.emplace_back(&WorkStealingPool::run, this, i);
+    }
+}
+
+WorkStealingPool::~WorkStealingPool() {
+    {
+        std::lock_guard<std::mutex> lock(_idleMutex);
+        _stopping = true;
+    }
+    _taskQueued.notify_all();
+    for (std::thread &thread : _threads) {
+        thread.join();
+    }
+}
+
+void WorkStealingPool::submit(Task task) {
+    size_t worker = currentPool == this ? currentWorker : _nextWorker.fetch_add(1, std::memory_order_relaxed) % _workers.size();
+    _pending.fetch_add(1);
+    {
+        std::lock_guard<std::mutex> lock(_workers[worker]->mutex);
+        _workers[worker]->tasks.push_back(std::move(task));
+        _queued.fetch_add(1);
+    }
+    {
+        // taken so that a thread checking _queued before sleeping can't miss the notification
+        std::lock_guard<std::mutex> lock(_idleMutex);
+    }
+    _taskQueued.notify_one();
+}
+
+bool WorkStealingPool::takeTask(size_t worker, Task &task) {
+    {
+        Worker &own = *_workers[worker];
+        std::lock_guard<std::mutex> lock(own.mutex);
+        if (!own.tasks.empty()) {
+            // newest task, its data is more likely to still be in cache
+            task = std::move(own.tasks.back());
+            own.tasks.pop_back();
+            _queued.fetch_sub(1);
+            return true;
+        }
+    }
+    for (size_t i = 1; i < _workers.size(); i++) {
+        Worker &victim = *_workers[(worker + i) % _workers.size()];
+        std::lock_guard<std::mutex> lock(victim.mutex);
+        if (!victim.tasks.empty()) {
+            task = std::move(victim.tasks.front());
+            victim.tasks.pop_front();
+            _queued.fetch_sub(1);
+            _stolen.fetch_add(1, std::memory_order_relaxed);
+            return true;
+        }
+    }
+    return false;
+}
+
+void WorkStealingPool::run(size_t worker) {
+    currentPool = this;
+    currentWorker = worker;
+    Task task;
+
+    while (true) {
+        if (takeTask(worker, task)) {
+            task();
+            task = nullptr;
+            if (_pending.fetch_sub(1) == 1) {
+                std::lock_guard<std::mutex> lock(_idleMutex);
+                _allDone.notify_all();
+            }
+            continue;
+        }
+        std::unique_lock<std::mutex> lock(_idleMutex);
+        _taskQueued.wait(lock, [this] { return _queued > 0 || _stopping; });
+        if (_queued == 0 && _stopping) return;
+    }
+}
+
+void WorkStealingPool::waitIdle() {
+    std::unique_lock<std::mutex> lock(_idleMutex);
+    _allDone.wait(lock, [this] { return _pending == 0; });
+}
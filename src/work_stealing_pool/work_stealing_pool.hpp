@@ -0,0 +1,84 @@
+#ifndef WORK_STEALING_POOL_HPP
+#define WORK_STEALING_POOL_HPP
+
+#include <atomic>
+#include <condition_variable>
+#include <deque>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <stdexcept>
+#include <thread>
+#include <vector>
+
+/**
+ * thread pool where each thread has its own queue of tasks.
+ * a thread runs the newest task of its queue, and takes the oldest task of another queue when its own is empty,
+ * so a burst of tasks submitted to one thread is shared by every thread.
+ */
+class WorkStealingPool {
+public:
+    using Task = std::function<void()>;
+
+private:
+    struct Worker {
+        std::mutex mutex;
+        std::deque<Task> tasks;
+    };
+
+    std::vector<std::unique_ptr<Worker>> _workers;
+    std::vector<std::thread> _threads;
+    std::mutex _idleMutex;
+    // signaled when a task is queued or the pool stops
+    std::condition_variable _taskQueued;
+    // signaled when the last pending task is done
+    std::condition_variable _allDone;
+    // tasks in the queues
+    std::atomic<size_t> _queued = 0;
+    // tasks submitted and not finished
+    std::atomic<size_t> _pending = 0;
+    std::atomic<size_t> _nextWorker = 0;
+    std::atomic<size_t> _stolen = 0;
+    bool _stopping = false;
+
+    void run(size_t worker);
+
+    /**
+     * returns false if there is no task in any queue
+     */
+    bool takeTask(size_t worker, Task &task);
+
+public:
+    /**
+     * throws std::invalid_argument if threadsCount is 0
+     */
+    WorkStealingPool(size_t threadsCount);
+
+    /**
+     * runs the remaining tasks before returning
+     */
+    ~WorkStealingPool();
+
+    WorkStealingPool(const WorkStealingPool &) = delete;
+    WorkStealingPool &operator=(const WorkStealingPool &) = delete;
+
+    /**
+     * can be called from any thread, including from a task.
+     * a task submitted from a pool thread is queued on this thread
+     */
+    void submit(Task task);
+
+    /**
+     * blocks until every submitted task is finished
+     */
+    void waitIdle();
+
+    size_t threadsCount() const { return _threads.size(); }
+
+    /**
+     * number of tasks run by another thread than the one they were queued on
+     */
+    size_t stolenTasks() const { return _stolen; }
+};
+
+#endif // WORK_STEALING_POOL_HPP
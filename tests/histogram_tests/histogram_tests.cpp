@@ -0,0 +1,82 @@
+#include "histogram_tests.hpp"
+
+namespace histogramTests {
+    test::Result testEmpty() {
+        Histogram histogram;
+
+        if (histogram.count() != 0 || histogram.min() != 0 || histogram.max() != 0 || histogram.mean() != 0 || histogram.percentile(50) != 0) {
+            return test::Result::FAILURE;
+        }
+        return test::Result::SUCCESS;
+    }
+
+    test::Result testBuckets() {
+        // every value is in a bucket containing it, at most 1/32 wide relatively to its lowest value
+        for (uint64_t value : {uint64_t(0), uint64_t(1), uint64_t(31), uint64_t(32), uint64_t(33), uint64_t(1000), uint64_t(123456789),
+                               (uint64_t(1) << 40) + 12345, UINT64_MAX}) {
+            size_t index = Histogram::bucketIndex(value);
+            uint64_t lowest = Histogram::bucketLowest(index);
+            uint64_t highest = Histogram::bucketHighest(index);
+            if (index >= Histogram::BUCKETS || value < lowest || value > highest || (highest - lowest) > lowest / 32) {
+                std::cerr << value << " in bucket " << index << " [" << lowest << ", " << highest << "]\n";
+                return test::Result::FAILURE;
+            }
+        }
+        if (Histogram::bucketLowest(Histogram::bucketIndex(100) + 1) != Histogram::bucketHighest(Histogram::bucketIndex(100)) + 1) {
+            return test::Result::FAILURE;
+        }
+        return test::Result::SUCCESS;
+    }
+
+    test::Result testPercentiles() {
+        Histogram histogram;
+        for (uint64_t value = 1; value <= 10000; value++) {
+            histogram.record(value);
+        }
+
+        uint64_t median = histogram.percentile(50);
+        uint64_t p99 = histogram.percentile(99);
+        if (histogram.count() != 10000 || histogram.min() != 1 || histogram.max() != 10000 || histogram.mean() != 5000.5 || median < 5000
+            || median > 5000 + 5000 / 32 || p99 < 9900 || p99 > 9900 + 9900 / 32 || histogram.percentile(100) != 10000 || histogram.percentile(0) != 1) {
+            std::cerr << "median " << median << ", p99 " << p99 << ", p100 " << histogram.percentile(100) << "\n";
+            return test::Result::FAILURE;
+        }
+        return test::Result::SUCCESS;
+    }
+
+    test::Result testMergeAcrossThreads() {
+        std::vector<Histogram> histograms(4);
+        std::vector<std::thread> threads;
+        for (size_t i = 0; i < histograms.size(); i++) {
+            threads.emplace_back([&histogram = histograms[i], i] {
+                for (uint64_t value = 0; value < 1000; value++) {
+                    histogram.record(i * 1000 + value);
+                }
+            });
+        }
+        for (std::thread &thread : threads) {
+            thread.join();
+        }
+        Histogram merged;
+        for (const Histogram &histogram : histograms) {
+            merged.merge(histogram);
+        }
+
+        if (merged.count() != 4000 || merged.min() != 0 || merged.max() != 3999 || merged.percentile(25) < 999 || merged.percentile(25) > 999 + 999 / 32) {
+            std::cerr << merged.count() << " values between " << merged.min() << " and " << merged.max() << ", p25 " << merged.percentile(25) << "\n";
+            return test::Result::FAILURE;
+        }
+        merged.reset();
+        if (merged.count() != 0 || merged.percentile(50) != 0) return test::Result::FAILURE;
+        return test::Result::SUCCESS;
+    }
+
+    void testHistogram(test::Tests *tests) {
+        tests->beginTestBlock("test histogram");
+        tests->addTest(testEmpty, "empty");
+        tests->addTest(testBuckets, "buckets");
+        tests->addTest(testPercentiles, "percentiles");
+        tests->addTest(testMergeAcrossThreads, "merge across threads");
+        tests->endTestBlock();
+    }
+} // namespace histogramTests
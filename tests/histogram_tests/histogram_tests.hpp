@@ -0,0 +1,13 @@
+#ifndef HISTOGRAM_TESTS_HPP
+#define HISTOGRAM_TESTS_HPP
+
+#include "../../cpp_tests/src/tests.hpp"
+#include "../../src/histogram/histogram.hpp"
+#include <thread>
+#include <vector>
+
+namespace histogramTests {
+    void testHistogram(test::Tests *tests);
+} // namespace histogramTests
+
+#endif // HISTOGRAM_TESTS_HPP
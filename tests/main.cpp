@@ -1,9 +1,25 @@
 #include "../cpp_tests/src/tests.hpp"
+#include "histogram_tests/histogram_tests.hpp"
+#include "network_coroutines_tests/network_coroutines_tests.hpp"
+#include "network_datagram_tests/network_datagram_tests.hpp"
+#include "network_front_end_tests/network_front_end_tests.hpp"
+#include "network_output_tests/network_output_tests.hpp"
+#include "network_reactor_tests/network_reactor_tests.hpp"
 #include "network_tests/network_tests.hpp"
+#include "network_trace_tests/network_trace_tests.hpp"
+#include "work_stealing_pool_tests/work_stealing_pool_tests.hpp"
 
 int main() {
     test::Tests tests = test::Tests();
     networkTests::testNetwork(&tests);
+    networkOutputTests::testNetworkOutput(&tests);
+    networkDatagramTests::testNetworkDatagram(&tests);
+    networkReactorTests::testNetworkReactor(&tests);
+    workStealingPoolTests::testWorkStealingPool(&tests);
+    networkFrontEndTests::testNetworkFrontEnd(&tests);
+    networkCoroutinesTests::testNetworkCoroutines(&tests);
+    networkTraceTests::testNetworkTrace(&tests);
+    histogramTests::testHistogram(&tests);
     tests.runTests();
     tests.displaySummary();
     return !tests.allTestsPassed();
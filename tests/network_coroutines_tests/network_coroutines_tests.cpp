@@ -0,0 +1,160 @@
+#include "network_coroutines_tests.hpp"
+
+namespace networkCoroutinesTests {
+    /**
+     * reads a header of 4 bytes then a line, and stores them in messages
+     */
+    CoroutineScheduler::Task readHeaderAndLine(AsyncInputHandler &input, std::vector<std::string> &messages, int &errorCode) {
+        auto [headerCode, header] = co_await input.read(4);
+        errorCode = headerCode;
+        if (errorCode) co_return;
+        messages.emplace_back(header);
+        auto [lineCode, line] = co_await input.readUntil('\n');
+        errorCode = lineCode;
+        if (errorCode) co_return;
+        messages.emplace_back(line);
+    }
+
+    test::Result testSessionSuspendedUntilMessageComplete() {
+        int fakeSocket[2];
+        if (networkTests::createSocket(fakeSocket)) return test::Result::ERROR;
+        CoroutineScheduler scheduler;
+        AsyncInputHandler input(scheduler, fakeSocket[0], 4);
+        std::vector<std::string> messages;
+        int errorCode = -1;
+        scheduler.spawn(readHeaderAndLine(input, messages, errorCode));
+
+        write(fakeSocket[1], "HEADhello ", 10);
+        scheduler.runOnce(0);
+        // the line is not complete, the session waits for more bytes
+        size_t sessionsBeforeEnd = scheduler.sessionsCount();
+        write(fakeSocket[1], "world\n", 6);
+        scheduler.run();
+        close(fakeSocket[0]);
+        close(fakeSocket[1]);
+
+        if (sessionsBeforeEnd != 1 || errorCode || messages != std::vector<std::string>{"HEAD", "hello world"} || scheduler.sessionsCount() != 0) {
+            std::cerr << "session ended with code " << errorCode << " and " << messages.size() << " messages\n";
+            return test::Result::FAILURE;
+        }
+        return test::Result::SUCCESS;
+    }
+
+    test::Result testManySessions() {
+        const int sessionsCount = 50;
+        int sockets[sessionsCount][2];
+        CoroutineScheduler scheduler;
+        std::vector<std::unique_ptr<AsyncInputHandler>> inputs;
+        std::vector<std::vector<std::string>> messages(sessionsCount);
+        std::vector<int> errorCodes(sessionsCount, -1);
+        for (int i = 0; i < sessionsCount; i++) {
+            if (networkTests::createSocket(sockets[i])) return test::Result::ERROR;
+            inputs.push_back(std::make_unique<AsyncInputHandler>(scheduler, sockets[i][0]));
+            scheduler.spawn(readHeaderAndLine(*inputs.back(), messages[i], errorCodes[i]));
+        }
+        scheduler.runOnce(0);
+
+        // the sessions are resumed in any order
+        for (int i = sessionsCount - 1; i >= 0; i--) {
+            std::string message = "HEAD" + std::to_string(i) + "\n";
+            write(sockets[i][1], message.data(), message.size());
+        }
+        scheduler.run();
+
+        test::Result result = test::Result::SUCCESS;
+        for (int i = 0; i < sessionsCount; i++) {
+            if (errorCodes[i] || messages[i] != std::vector<std::string>{"HEAD", std::to_string(i)}) {
+                std::cerr << "session " << i << " ended with code " << errorCodes[i] << "\n";
+                result = test::Result::FAILURE;
+            }
+            close(sockets[i][0]);
+            close(sockets[i][1]);
+        }
+        return result;
+    }
+
+    test::Result testSessionSocketClosed() {
+        int fakeSocket[2];
+        if (networkTests::createSocket(fakeSocket)) return test::Result::ERROR;
+        CoroutineScheduler scheduler;
+        AsyncInputHandler input(scheduler, fakeSocket[0]);
+        std::vector<std::string> messages;
+        int errorCode = -1;
+        scheduler.spawn(readHeaderAndLine(input, messages, errorCode));
+
+        scheduler.runOnce(0);
+        write(fakeSocket[1], "HE", 2);
+        close(fakeSocket[1]);
+        scheduler.run();
+        close(fakeSocket[0]);
+
+        if (errorCode != 2 || !messages.empty()) {
+            std::cerr << "session ended with code " << errorCode << "\n";
+            return test::Result::FAILURE;
+        }
+        return test::Result::SUCCESS;
+    }
+
+    test::Result testSchedulerDestroysWaitingSessions() {
+        int fakeSocket[2];
+        if (networkTests::createSocket(fakeSocket)) return test::Result::ERROR;
+        std::vector<std::string> messages;
+        int errorCode = -1;
+        size_t sessionsCount;
+        {
+            CoroutineScheduler scheduler;
+            AsyncInputHandler input(scheduler, fakeSocket[0]);
+            scheduler.spawn(readHeaderAndLine(input, messages, errorCode));
+            // nothing is written, the session stays suspended until the scheduler is destroyed
+            scheduler.runOnce(10);
+            sessionsCount = scheduler.sessionsCount();
+        }
+        close(fakeSocket[0]);
+        close(fakeSocket[1]);
+
+        if (sessionsCount != 1 || errorCode != -1) {
+            std::cerr << sessionsCount << " sessions, code " << errorCode << "\n";
+            return test::Result::FAILURE;
+        }
+        return test::Result::SUCCESS;
+    }
+
+    test::Result testStopBeforeRun() {
+        int fakeSocket[2];
+        if (networkTests::createSocket(fakeSocket)) return test::Result::ERROR;
+        CoroutineScheduler scheduler;
+        AsyncInputHandler input(scheduler, fakeSocket[0]);
+        std::vector<std::string> messages;
+        int errorCode = -1;
+        scheduler.spawn(readHeaderAndLine(input, messages, errorCode));
+
+        // if the stop was lost, run would wait for this message and end the session
+        std::thread writeThread([fakeSocket] {
+            std::this_thread::sleep_for(std::chrono::milliseconds(200));
+            write(fakeSocket[1], "HEADhello\n", 10);
+        });
+        scheduler.stop();
+        scheduler.run();
+        size_t sessionsAfterStop = scheduler.sessionsCount();
+        writeThread.join();
+        scheduler.run();
+        close(fakeSocket[0]);
+        close(fakeSocket[1]);
+
+        if (sessionsAfterStop != 1 || errorCode || messages != std::vector<std::string>{"HEAD", "hello"}) {
+            std::cerr << sessionsAfterStop << " sessions after stop, session ended with code " << errorCode << "\n";
+            return test::Result::FAILURE;
+        }
+        return test::Result::SUCCESS;
+    }
+
+    void testNetworkCoroutines(test::Tests *tests) {
+        tests->beginTestBlock("test network coroutines");
+        tests->addTest(testSessionSuspendedUntilMessageComplete, "session suspended until message complete");
+        tests->addTest(testManySessions, "many sessions");
+        tests->addTest(testSessionSocketClosed, "session socket closed");
+        tests->addTest(testSchedulerDestroysWaitingSessions, "scheduler destroys waiting sessions");
+        tests->addTest(testStopBeforeRun, "stop before run");
+        tests->endTestBlock();
+    }
+} // namespace networkCoroutinesTests
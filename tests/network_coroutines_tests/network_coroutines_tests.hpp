@@ -0,0 +1,13 @@
+#ifndef NETWORK_COROUTINES_TESTS_HPP
+#define NETWORK_COROUTINES_TESTS_HPP
+
+#include "../../cpp_tests/src/tests.hpp"
+#include "../../src/network_coroutines/async_input_handler.hpp"
+#include "../../src/network_coroutines/coroutine_scheduler.hpp"
+#include "../network_tests/network_tests.hpp"
+
+namespace networkCoroutinesTests {
+    void testNetworkCoroutines(test::Tests *tests);
+} // namespace networkCoroutinesTests
+
+#endif // NETWORK_COROUTINES_TESTS_HPP
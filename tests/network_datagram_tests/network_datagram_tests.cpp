@@ -0,0 +1,308 @@
+#include "network_datagram_tests.hpp"
+
+namespace networkDatagramTests {
+    /**
+     * UDP socket bound to a free port of localhost, connected to peer if not null.
+     * returns -1 on error
+     */
+    int createUdpSocket(sockaddr_in &address, const sockaddr_in *peer = nullptr) {
+        int udpSocket = socket(AF_INET, SOCK_DGRAM, 0);
+        if (udpSocket == -1) return -1;
+        address = {};
+        address.sin_family = AF_INET;
+        address.sin_addr.s_addr = htonl(INADDR_LOOPBACK);
+        socklen_t addressLength = sizeof(address);
+        if (bind(udpSocket, reinterpret_cast<sockaddr *>(&address), sizeof(address)) != 0
+            || getsockname(udpSocket, reinterpret_cast<sockaddr *>(&address), &addressLength) != 0
+            || (peer && connect(udpSocket, reinterpret_cast<const sockaddr *>(peer), sizeof(*peer)) != 0)) {
+            close(udpSocket);
+            return -1;
+        }
+        return udpSocket;
+    }
+
+    /**
+     * sender -> relay -> receiver, the test decides which datagrams the relay forwards, and in which order
+     */
+    struct Link {
+        int receiver = -1;
+        int relay = -1;
+        int sender = -1;
+        sockaddr_in receiverAddress;
+
+        /**
+         * returns true on error
+         */
+        bool open() {
+            sockaddr_in relayAddress;
+            sockaddr_in senderAddress;
+            receiver = createUdpSocket(receiverAddress);
+            relay = createUdpSocket(relayAddress);
+            sender = createUdpSocket(senderAddress, &relayAddress);
+            return receiver == -1 || relay == -1 || sender == -1;
+        }
+
+        /**
+         * datagrams waiting in the relay
+         */
+        std::vector<std::string> take() {
+            std::vector<std::string> datagrams;
+            char buffer[65536];
+            ssize_t size;
+            while ((size = recv(relay, buffer, sizeof(buffer), MSG_DONTWAIT)) >= 0) {
+                datagrams.emplace_back(buffer, size);
+            }
+            return datagrams;
+        }
+
+        void forward(const std::string &datagram) {
+            sendto(relay, datagram.data(), datagram.size(), 0, reinterpret_cast<const sockaddr *>(&receiverAddress), sizeof(receiverAddress));
+        }
+
+        ~Link() {
+            if (receiver != -1) close(receiver);
+            if (relay != -1) close(relay);
+            if (sender != -1) close(sender);
+        }
+    };
+
+    std::string makeFrame(size_t size, uint64_t seed) {
+        std::string frame(size, '\0');
+        for (size_t i = 0; i < size; i++) {
+            frame[i] = static_cast<char>((i * 31 + seed * 7) % 251);
+        }
+        return frame;
+    }
+
+    test::Result testSmallFrame() {
+        Link link;
+        if (link.open()) return test::Result::ERROR;
+        DatagramSender sender(link.sender);
+        DatagramReceiver receiver(link.receiver, 1024);
+
+        int sendCode = sender.send("generation 1");
+        for (const std::string &datagram : link.take()) link.forward(datagram);
+        std::string_view frame;
+        int receiveCode = receiver.receive(frame, true, 1000);
+        int emptyCode = receiver.receive(frame);
+        int emptyErrno = errno;
+
+        if (sendCode != 0 || receiveCode != 0 || frame != "generation 1" || receiver.lastSequence() != 1 || emptyCode != 1 || emptyErrno != EAGAIN
+            || sender.datagramsSent() != 1) {
+            std::cerr << sendCode << " " << receiveCode << " " << frame << " then " << emptyCode << "\n";
+            return test::Result::FAILURE;
+        }
+        return test::Result::SUCCESS;
+    }
+
+    test::Result testFragmentedFrame() {
+        Link link;
+        if (link.open()) return test::Result::ERROR;
+        DatagramSender sender(link.sender);
+        DatagramReceiver receiver(link.receiver, 1 << 20);
+
+        std::string sent = makeFrame(100000, 1);
+        int sendCode = sender.send(sent);
+        std::vector<std::string> datagrams = link.take();
+        // out of order
+        std::reverse(datagrams.begin(), datagrams.end());
+        for (const std::string &datagram : datagrams) link.forward(datagram);
+        std::string_view frame;
+        int receiveCode = receiver.receive(frame, true, 1000);
+
+        // 100000 bytes in datagrams of 1472 - 16 bytes, sent with 2 sendmmsg of 64 datagrams at most
+        if (sendCode != 0 || receiveCode != 0 || frame != sent || datagrams.size() != 69 || sender.syscalls() != 2) {
+            std::cerr << sendCode << " " << receiveCode << " " << frame.size() << " bytes from " << datagrams.size() << " datagrams sent with "
+                      << sender.syscalls() << " syscalls\n";
+            return test::Result::FAILURE;
+        }
+        return test::Result::SUCCESS;
+    }
+
+    test::Result testDropStaleFrames() {
+        Link link;
+        if (link.open()) return test::Result::ERROR;
+        DatagramSender sender(link.sender, 1000);
+        DatagramReceiver receiver(link.receiver, 1 << 20, 1000);
+
+        sender.send(makeFrame(3000, 1));
+        std::vector<std::string> first = link.take();
+        sender.send(makeFrame(3000, 2));
+        sender.send(makeFrame(3000, 3));
+        // frames 2 and 3 arrive before the first one, only 3 is given
+        for (const std::string &datagram : link.take()) link.forward(datagram);
+        std::string_view frame;
+        int newestCode = receiver.receive(frame, true, 1000);
+        bool newest = frame == makeFrame(3000, 3);
+        for (const std::string &datagram : first) link.forward(datagram);
+        int staleCode = receiver.receive(frame, true, 50);
+        const DatagramStatistics &statistics = receiver.statistics();
+
+        if (newestCode != 0 || !newest || receiver.lastSequence() != 3 || staleCode != 3 || statistics.framesReceived != 1
+            || statistics.staleDatagrams != first.size()) {
+            std::cerr << newestCode << " " << newest << " " << receiver.lastSequence() << " then " << staleCode << ", " << statistics.staleDatagrams
+                      << " stale datagrams\n";
+            return test::Result::FAILURE;
+        }
+        return test::Result::SUCCESS;
+    }
+
+    test::Result testSimulatedLoss() {
+        Link link;
+        if (link.open()) return test::Result::ERROR;
+        DatagramSender sender(link.sender, 1000);
+        DatagramReceiver receiver(link.receiver, 1 << 20, 1000);
+        std::mt19937 random(42);
+        std::bernoulli_distribution lost(0.1);
+
+        // frames of 5 datagrams, each datagram lost with a probability of 10%
+        std::set<uint64_t> complete;
+        std::set<uint64_t> received;
+        bool corrupted = false;
+        for (uint64_t sequence = 1; sequence <= 200; sequence++) {
+            sender.send(makeFrame(4500, sequence));
+            bool allForwarded = true;
+            for (const std::string &datagram : link.take()) {
+                if (lost(random)) allForwarded = false;
+                else link.forward(datagram);
+            }
+            if (allForwarded) complete.insert(sequence);
+
+            std::string_view frame;
+            if (receiver.receive(frame, allForwarded, 1000) == 0) {
+                received.insert(receiver.lastSequence());
+                if (frame != makeFrame(4500, receiver.lastSequence())) corrupted = true;
+            }
+        }
+        const DatagramStatistics &statistics = receiver.statistics();
+
+        // a lost datagram only loses its frame, the next complete one is given right away
+        if (corrupted || received != complete || complete.size() == 200 || complete.empty()
+            || statistics.framesDropped != *received.rbegin() - *received.begin() + 1 - received.size()) {
+            std::cerr << (corrupted ? "corrupted frame, " : "") << received.size() << " frames received, " << complete.size() << " complete, "
+                      << statistics.framesDropped << " dropped\n";
+            return test::Result::FAILURE;
+        }
+        return test::Result::SUCCESS;
+    }
+
+    test::Result testSenderRestart() {
+        Link link;
+        if (link.open()) return test::Result::ERROR;
+        DatagramReceiver receiver(link.receiver, 1024);
+        std::string_view frame;
+        int beforeCode;
+        {
+            DatagramSender sender(link.sender);
+            for (uint64_t sequence = 1; sequence <= 100; sequence++) {
+                sender.send("generation " + std::to_string(sequence));
+            }
+            for (const std::string &datagram : link.take()) link.forward(datagram);
+            beforeCode = receiver.receive(frame, true, 1000);
+        }
+        // the new sender starts again from 1, far behind the last frame given
+        DatagramSender restarted(link.sender);
+        restarted.send("restarted 1");
+        restarted.send("restarted 2");
+        for (const std::string &datagram : link.take()) link.forward(datagram);
+        int afterCode = receiver.receive(frame, true, 1000);
+
+        if (beforeCode != 0 || afterCode != 0 || frame != "restarted 2" || receiver.lastSequence() != 2 || receiver.statistics().resyncs != 1) {
+            std::cerr << beforeCode << " " << afterCode << " " << frame << " " << receiver.lastSequence() << ", " << receiver.statistics().resyncs
+                      << " resyncs\n";
+            return test::Result::FAILURE;
+        }
+        return test::Result::SUCCESS;
+    }
+
+    test::Result testForgedSequence() {
+        Link link;
+        if (link.open()) return test::Result::ERROR;
+        DatagramSender sender(link.sender);
+        DatagramReceiver receiver(link.receiver, 1024);
+
+        sender.send("generation 1");
+        for (const std::string &datagram : link.take()) link.forward(datagram);
+        // a datagram with a sequence far in the future
+        std::string forged(networkDatagram::HEADER_SIZE, '\0');
+        networkDatagram::Header{UINT64_MAX, 0, 1, 6}.encode(forged.data());
+        link.forward(forged + "forged");
+        std::string_view frame;
+        int forgedCode = receiver.receive(frame, true, 1000);
+        std::string forgedFrame(frame);
+        sender.send("generation 2");
+        for (const std::string &datagram : link.take()) link.forward(datagram);
+        int realCode = receiver.receive(frame, true, 1000);
+
+        // the forged frame is given, but doesn't hide the real ones after it
+        if (forgedCode != 0 || forgedFrame != "forged" || realCode != 0 || frame != "generation 2" || receiver.lastSequence() != 2) {
+            std::cerr << forgedCode << " " << forgedFrame << " " << realCode << " " << frame << " " << receiver.lastSequence() << "\n";
+            return test::Result::FAILURE;
+        }
+        return test::Result::SUCCESS;
+    }
+
+    test::Result testInvalidDatagrams() {
+        Link link;
+        if (link.open()) return test::Result::ERROR;
+        DatagramSender sender(link.sender, 1000);
+        DatagramReceiver receiver(link.receiver, 2000, 1000);
+
+        // frame bigger than the maximum frame size (4 datagrams), then datagrams who are not frames
+        sender.send(makeFrame(3000, 1));
+        for (const std::string &datagram : link.take()) link.forward(datagram);
+        link.forward("short");
+        link.forward(std::string(100, '\xff'));
+        sender.send("valid");
+        for (const std::string &datagram : link.take()) link.forward(datagram);
+        std::string_view frame;
+        int receiveCode = receiver.receive(frame, true, 1000);
+
+        if (receiveCode != 0 || frame != "valid" || receiver.statistics().invalidDatagrams != 6) {
+            std::cerr << receiveCode << " " << frame << ", " << receiver.statistics().invalidDatagrams << " invalid datagrams\n";
+            return test::Result::FAILURE;
+        }
+        return test::Result::SUCCESS;
+    }
+
+    test::Result testFrameTooLarge() {
+        Link link;
+        if (link.open()) return test::Result::ERROR;
+        DatagramSender sender(link.sender, networkDatagram::HEADER_SIZE + 1);
+
+        int tooLargeCode = sender.send(std::string(networkDatagram::MAX_FRAGMENTS + 1, 'x'));
+
+        if (tooLargeCode != 4 || sender.datagramsSent() != 0 || sender.syscalls() != 0) {
+            std::cerr << tooLargeCode << ", " << sender.datagramsSent() << " datagrams sent\n";
+            return test::Result::FAILURE;
+        }
+        return test::Result::SUCCESS;
+    }
+
+    test::Result testDatagramSizeTooSmall() {
+        bool catched = false;
+        try {
+            DatagramSender sender(-1, networkDatagram::HEADER_SIZE);
+        }
+        catch (const std::invalid_argument &e) {
+            std::cerr << e.what() << "\n";
+            catched = true;
+        }
+        if (!catched) return test::Result::FAILURE;
+        return test::Result::SUCCESS;
+    }
+
+    void testNetworkDatagram(test::Tests *tests) {
+        tests->beginTestBlock("test network datagram");
+        tests->addTest(testSmallFrame, "small frame");
+        tests->addTest(testFragmentedFrame, "fragmented frame");
+        tests->addTest(testDropStaleFrames, "drop stale frames");
+        tests->addTest(testSimulatedLoss, "simulated loss");
+        tests->addTest(testSenderRestart, "sender restart");
+        tests->addTest(testForgedSequence, "forged sequence");
+        tests->addTest(testInvalidDatagrams, "invalid datagrams");
+        tests->addTest(testFrameTooLarge, "frame too large");
+        tests->addTest(testDatagramSizeTooSmall, "datagram size too small");
+        tests->endTestBlock();
+    }
+} // namespace networkDatagramTests
@@ -0,0 +1,17 @@
+#ifndef NETWORK_DATAGRAM_TESTS_HPP
+#define NETWORK_DATAGRAM_TESTS_HPP
+
+#include "../../cpp_tests/src/tests.hpp"
+#include "../../src/network_datagram/network_datagram.hpp"
+#include <algorithm>
+#include <arpa/inet.h>
+#include <netinet/in.h>
+#include <random>
+#include <set>
+#include <unistd.h>
+
+namespace networkDatagramTests {
+    void testNetworkDatagram(test::Tests *tests);
+} // namespace networkDatagramTests
+
+#endif // NETWORK_DATAGRAM_TESTS_HPP
@@ -0,0 +1,113 @@
+#include "network_front_end_tests.hpp"
+
+namespace networkFrontEndTests {
+    int connectToLoopback(uint16_t port) {
+        sockaddr_in address = {};
+        address.sin_family = AF_INET;
+        address.sin_port = htons(port);
+        address.sin_addr.s_addr = htonl(INADDR_LOOPBACK);
+
+        int client = socket(AF_INET, SOCK_STREAM, 0);
+        if (client == -1) return -1;
+        if (connect(client, reinterpret_cast<sockaddr *>(&address), sizeof(address)) == -1) {
+            close(client);
+            return -1;
+        }
+        return client;
+    }
+
+    test::Result testFrontEndDelimitedMessages() {
+        const int clientsCount = 3;
+        const int messagesCount = 200;
+        WorkStealingPool pool = WorkStealingPool(4);
+        std::mutex messagesMutex;
+        // messages of each connection, in the order they were handled
+        std::map<int, std::vector<std::string>> messages;
+        size_t received = 0;
+        std::map<int, int> running;
+        bool overlapped = false;
+
+        NetworkFrontEnd frontEnd = NetworkFrontEnd("127.0.0.1", 0, 2, pool);
+        frontEnd.setDelimitedMessages("\n", [&](int socket, const std::string &message) {
+            {
+                std::lock_guard<std::mutex> lock(messagesMutex);
+                if (++running[socket] > 1) overlapped = true;
+            }
+            std::this_thread::yield();
+            std::lock_guard<std::mutex> lock(messagesMutex);
+            messages[socket].push_back(message);
+            received++;
+            running[socket]--;
+        });
+        if (frontEnd.start()) return test::Result::ERROR;
+
+        std::vector<int> clients;
+        for (int i = 0; i < clientsCount; i++) {
+            int client = connectToLoopback(frontEnd.port());
+            if (client == -1) {
+                std::cerr << "can't connect to port " << frontEnd.port() << "\n";
+                for (int socket : clients) {
+                    close(socket);
+                }
+                return test::Result::ERROR;
+            }
+            clients.push_back(client);
+        }
+        // the messages of a client arrive in several reads and are interleaved with the other clients
+        for (int j = 0; j < messagesCount; j++) {
+            for (int i = 0; i < clientsCount; i++) {
+                std::string message = "client" + std::to_string(i) + " " + std::to_string(j) + "\n";
+                write(clients[i], message.c_str(), message.size());
+            }
+        }
+
+        std::chrono::steady_clock::time_point deadline = std::chrono::steady_clock::now() + std::chrono::seconds(5);
+        while (std::chrono::steady_clock::now() < deadline) {
+            pool.waitIdle();
+            std::lock_guard<std::mutex> lock(messagesMutex);
+            if (received >= clientsCount * messagesCount) break;
+            std::this_thread::sleep_for(std::chrono::milliseconds(10));
+        }
+        frontEnd.stop();
+        pool.waitIdle();
+        for (int socket : clients) {
+            close(socket);
+        }
+
+        // each connection gives the messages of one client, in the order it sent them
+        bool ordered = messages.size() == clientsCount;
+        for (const auto &[socket, connectionMessages] : messages) {
+            std::string client = connectionMessages.empty() ? "" : connectionMessages[0].substr(0, connectionMessages[0].find(' '));
+            ordered = ordered && connectionMessages.size() == messagesCount;
+            for (int j = 0; ordered && j < messagesCount; j++) {
+                ordered = connectionMessages[j] == client + " " + std::to_string(j);
+            }
+        }
+        if (ordered && !overlapped) return test::Result::SUCCESS;
+        std::cerr << received << " messages received from " << messages.size() << " connections, " << (overlapped ? "overlapped" : "not overlapped")
+                  << ":\n";
+        for (const auto &[socket, connectionMessages] : messages) {
+            for (const std::string &message : connectionMessages) {
+                std::cerr << "'" << message << "' ";
+            }
+            std::cerr << "\n";
+        }
+        return test::Result::FAILURE;
+    }
+
+    test::Result testFrontEndStartWithoutHandler() {
+        WorkStealingPool pool = WorkStealingPool(1);
+        NetworkFrontEnd frontEnd = NetworkFrontEnd("127.0.0.1", 0, 1, pool);
+
+        if (frontEnd.start()) return test::Result::SUCCESS;
+        std::cerr << "start didn't failed\n";
+        return test::Result::FAILURE;
+    }
+
+    void testNetworkFrontEnd(test::Tests *tests) {
+        tests->beginTestBlock("test network front end");
+        tests->addTest(testFrontEndDelimitedMessages, "delimited messages");
+        tests->addTest(testFrontEndStartWithoutHandler, "start without handler");
+        tests->endTestBlock();
+    }
+} // namespace networkFrontEndTests
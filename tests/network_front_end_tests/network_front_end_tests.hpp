@@ -0,0 +1,17 @@
+#ifndef NETWORK_FRONT_END_TESTS_HPP
+#define NETWORK_FRONT_END_TESTS_HPP
+
+#include "../../cpp_tests/src/tests.hpp"
+#include "../../src/network_front_end/network_front_end.hpp"
+#include <map>
+
+namespace networkFrontEndTests {
+    /**
+     * returns the connected socket, or -1 in case of error
+     */
+    int connectToLoopback(uint16_t port);
+
+    void testNetworkFrontEnd(test::Tests *tests);
+} // namespace networkFrontEndTests
+
+#endif // NETWORK_FRONT_END_TESTS_HPP
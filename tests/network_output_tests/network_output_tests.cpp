@@ -0,0 +1,414 @@
+#include "network_output_tests.hpp"
+
+namespace networkOutputTests {
+    /**
+     * reads everything available on socket without blocking
+     */
+    std::string readAvailable(int socket) {
+        std::string received;
+        char buffer[4096];
+        ssize_t bytesRead;
+        while ((bytesRead = recv(socket, buffer, sizeof(buffer), MSG_DONTWAIT)) > 0) {
+            received.append(buffer, bytesRead);
+        }
+        return received;
+    }
+
+    test::Result testFlushThresholdOfZero() {
+        int fakeSocket[2];
+        if (networkTests::createSocket(fakeSocket)) return test::Result::ERROR;
+        bool catched = false;
+
+        try {
+            NetworkOutputHandler(fakeSocket[0], 0);
+        }
+        catch (const std::invalid_argument &e) {
+            std::cerr << e.what() << '\n';
+            catched = true;
+        }
+
+        close(fakeSocket[0]);
+        close(fakeSocket[1]);
+        return catched ? test::Result::SUCCESS : test::Result::FAILURE;
+    }
+
+    test::Result testWriteQueuesUntilFlush() {
+        int fakeSocket[2];
+        if (networkTests::createSocket(fakeSocket)) return test::Result::ERROR;
+        NetworkOutputHandler outputHandler(fakeSocket[0]);
+
+        int firstCode = outputHandler.write("Hello");
+        int secondCode = outputHandler.write(std::string(" world"));
+        std::string beforeFlush = readAvailable(fakeSocket[1]);
+        size_t queuedBytes = outputHandler.queuedBytes();
+        int flushCode = outputHandler.flush();
+        std::string afterFlush = readAvailable(fakeSocket[1]);
+        close(fakeSocket[0]);
+        close(fakeSocket[1]);
+
+        // both messages are sent with a single sendmsg
+        if (firstCode || secondCode || flushCode || !beforeFlush.empty() || queuedBytes != 11 || afterFlush != "Hello world"
+            || outputHandler.queuedBytes() != 0 || outputHandler.syscalls() != 1) {
+            std::cerr << "flush returned code " << flushCode << " after " << outputHandler.syscalls() << " syscalls, received '" << beforeFlush
+                      << "' then '" << afterFlush << "'\n";
+            return test::Result::FAILURE;
+        }
+        return test::Result::SUCCESS;
+    }
+
+    test::Result testWriteFlushesAtThreshold() {
+        int fakeSocket[2];
+        if (networkTests::createSocket(fakeSocket)) return test::Result::ERROR;
+        NetworkOutputHandler outputHandler(fakeSocket[0], 8);
+
+        int firstCode = outputHandler.write("abcd");
+        std::string beforeThreshold = readAvailable(fakeSocket[1]);
+        int secondCode = outputHandler.write("efgh");
+        std::string afterThreshold = readAvailable(fakeSocket[1]);
+        close(fakeSocket[0]);
+        close(fakeSocket[1]);
+
+        if (firstCode || secondCode || !beforeThreshold.empty() || afterThreshold != "abcdefgh") {
+            std::cerr << "write returned codes " << firstCode << " and " << secondCode << ", received '" << beforeThreshold << "' then '"
+                      << afterThreshold << "'\n";
+            return test::Result::FAILURE;
+        }
+        return test::Result::SUCCESS;
+    }
+
+    test::Result testFlushPartialWrite() {
+        int fakeSocket[2];
+        if (networkTests::createSocket(fakeSocket)) return test::Result::ERROR;
+        int sendBufferSize = 4096;
+        setsockopt(fakeSocket[0], SOL_SOCKET, SO_SNDBUF, &sendBufferSize, sizeof(sendBufferSize));
+        NetworkOutputHandler outputHandler(fakeSocket[0], SIZE_MAX);
+
+        std::string expected;
+        for (int i = 0; i < 1000; i++) {
+            std::string message = std::to_string(i) + std::string(1000, 'a' + i % 26);
+            expected += message;
+            outputHandler.write(message);
+        }
+
+        std::string received;
+        int errorCode = outputHandler.flush();
+        bool partial = errorCode == 1 && outputHandler.queuedBytes() > 0;
+        // the socket is full, the rest is sent as the other side reads
+        while (errorCode == 1 && errno == EAGAIN) {
+            received += readAvailable(fakeSocket[1]);
+            errorCode = outputHandler.flush();
+        }
+        received += readAvailable(fakeSocket[1]);
+        close(fakeSocket[0]);
+        close(fakeSocket[1]);
+
+        if (!partial || errorCode || received != expected || outputHandler.queuedMessages() != 0) {
+            std::cerr << "flush returned code " << errorCode << ", partial: " << partial << ", received " << received.size() << " of "
+                      << expected.size() << " bytes\n";
+            return test::Result::FAILURE;
+        }
+        return test::Result::SUCCESS;
+    }
+
+    test::Result testFlushRetryIfFull() {
+        int fakeSocket[2];
+        if (networkTests::createSocket(fakeSocket)) return test::Result::ERROR;
+        int sendBufferSize = 4096;
+        setsockopt(fakeSocket[0], SOL_SOCKET, SO_SNDBUF, &sendBufferSize, sizeof(sendBufferSize));
+        NetworkOutputHandler outputHandler(fakeSocket[0], SIZE_MAX);
+        std::string message(1 << 20, 'x');
+        outputHandler.write(message);
+
+        std::string received;
+        std::thread readThread([&received, &fakeSocket, &message] {
+            char buffer[4096];
+            while (received.size() < message.size()) {
+                ssize_t bytesRead = recv(fakeSocket[1], buffer, sizeof(buffer), 0);
+                if (bytesRead <= 0) return;
+                received.append(buffer, bytesRead);
+            }
+        });
+        int errorCode = outputHandler.flush(true, 5000);
+        readThread.join();
+        close(fakeSocket[0]);
+        close(fakeSocket[1]);
+
+        if (errorCode || received != message) {
+            std::cerr << "flush returned code " << errorCode << ", received " << received.size() << " bytes\n";
+            return test::Result::FAILURE;
+        }
+        return test::Result::SUCCESS;
+    }
+
+    test::Result testFlushRetryIfFullWithTimeout() {
+        int fakeSocket[2];
+        if (networkTests::createSocket(fakeSocket)) return test::Result::ERROR;
+        int sendBufferSize = 4096;
+        setsockopt(fakeSocket[0], SOL_SOCKET, SO_SNDBUF, &sendBufferSize, sizeof(sendBufferSize));
+        NetworkOutputHandler outputHandler(fakeSocket[0], SIZE_MAX);
+        outputHandler.write(std::string(1 << 20, 'x'));
+
+        // nothing reads the other side
+        int errorCode = outputHandler.flush(true, 50);
+        close(fakeSocket[0]);
+        close(fakeSocket[1]);
+
+        if (errorCode != 3 || outputHandler.queuedBytes() == 0) {
+            std::cerr << "flush returned code " << errorCode << " with " << outputHandler.queuedBytes() << " bytes queued\n";
+            return test::Result::FAILURE;
+        }
+        return test::Result::SUCCESS;
+    }
+
+    test::Result testFlushCloseSocket() {
+        int fakeSocket[2];
+        if (networkTests::createSocket(fakeSocket)) return test::Result::ERROR;
+        NetworkOutputHandler outputHandler(fakeSocket[0]);
+        close(fakeSocket[1]);
+
+        outputHandler.write("Hello");
+        int errorCode = outputHandler.flush();
+        close(fakeSocket[0]);
+
+        if (errorCode != 2 || outputHandler.queuedBytes() != 5) {
+            std::cerr << "flush returned code " << errorCode << "\n";
+            return test::Result::FAILURE;
+        }
+        return test::Result::SUCCESS;
+    }
+
+    test::Result testWriteSharedBufferWithoutCopy() {
+        int firstSocket[2];
+        int secondSocket[2];
+        if (networkTests::createSocket(firstSocket)) return test::Result::ERROR;
+        if (networkTests::createSocket(secondSocket)) {
+            close(firstSocket[0]);
+            close(firstSocket[1]);
+            return test::Result::ERROR;
+        }
+        NetworkOutputHandler firstOutput(firstSocket[0]);
+        NetworkOutputHandler secondOutput(secondSocket[0]);
+        NetworkOutputHandler::SharedBuffer frame = std::make_shared<const std::string>("generation 42");
+
+        firstOutput.write(frame);
+        secondOutput.write(frame);
+        long queuedReferences = frame.use_count();
+        int firstCode = firstOutput.flush();
+        int secondCode = secondOutput.flush();
+        std::string firstReceived = readAvailable(firstSocket[1]);
+        std::string secondReceived = readAvailable(secondSocket[1]);
+        close(firstSocket[0]);
+        close(firstSocket[1]);
+        close(secondSocket[0]);
+        close(secondSocket[1]);
+
+        // the handlers keep a reference to the buffer until it is sent
+        if (firstCode || secondCode || queuedReferences != 3 || frame.use_count() != 1 || firstReceived != *frame || secondReceived != *frame) {
+            std::cerr << "flush returned codes " << firstCode << " and " << secondCode << " with " << queuedReferences << " references while queued\n";
+            return test::Result::FAILURE;
+        }
+        return test::Result::SUCCESS;
+    }
+
+    test::Result testBroadcastGroup() {
+        const int subscribersCount = 3;
+        int sockets[subscribersCount][2];
+        std::vector<std::unique_ptr<NetworkOutputHandler>> outputs;
+        BroadcastGroup group;
+        for (int i = 0; i < subscribersCount; i++) {
+            if (networkTests::createSocket(sockets[i])) return test::Result::ERROR;
+            outputs.push_back(std::make_unique<NetworkOutputHandler>(sockets[i][0], 1));
+            group.subscribe(*outputs.back());
+        }
+        bool subscribedTwice = !group.subscribe(*outputs[0]);
+        group.unsubscribe(*outputs[1]);
+
+        // the flush threshold of 1 byte sends the frame right away
+        group.broadcast(std::string("frame"));
+        std::string received[subscribersCount];
+        for (int i = 0; i < subscribersCount; i++) {
+            received[i] = readAvailable(sockets[i][1]);
+            close(sockets[i][0]);
+            close(sockets[i][1]);
+        }
+
+        if (subscribedTwice || group.subscribersCount() != 2 || received[0] != "frame" || !received[1].empty() || received[2] != "frame") {
+            std::cerr << "received '" << received[0] << "', '" << received[1] << "' and '" << received[2] << "'\n";
+            return test::Result::FAILURE;
+        }
+        return test::Result::SUCCESS;
+    }
+
+    test::Result testBroadcastGroupErrorCallback() {
+        int fakeSocket[2];
+        if (networkTests::createSocket(fakeSocket)) return test::Result::ERROR;
+        NetworkOutputHandler output(fakeSocket[0], 1);
+        BroadcastGroup group;
+        group.subscribe(output);
+        close(fakeSocket[1]);
+
+        int errorCode = 0;
+        group.broadcast(std::string("frame"), [&group, &errorCode](NetworkOutputHandler &output, int code) {
+            errorCode = code;
+            group.unsubscribe(output);
+        });
+        close(fakeSocket[0]);
+
+        if (errorCode != 2 || group.subscribersCount() != 0) {
+            std::cerr << "error callback got code " << errorCode << "\n";
+            return test::Result::FAILURE;
+        }
+        return test::Result::SUCCESS;
+    }
+
+    test::Result testZeroCopyNotSupportedByUnixSocket() {
+        int fakeSocket[2];
+        if (networkTests::createSocket(fakeSocket)) return test::Result::ERROR;
+        NetworkOutputHandler output(fakeSocket[0]);
+        bool notSupported = output.enableZeroCopy();
+
+        // the message is still sent, with a copy
+        output.write(std::string(100000, 'x'));
+        int errorCode = output.flush();
+        std::string received = readAvailable(fakeSocket[1]);
+        close(fakeSocket[0]);
+        close(fakeSocket[1]);
+
+        if (!notSupported || errorCode || received.size() != 100000) {
+            std::cerr << "flush returned code " << errorCode << ", received " << received.size() << " bytes\n";
+            return test::Result::FAILURE;
+        }
+        return test::Result::SUCCESS;
+    }
+
+    /**
+     * connected loopback tcp sockets, the only ones who support zero copy.
+     * returns true on error
+     */
+    bool createTcpSockets(int &server, int &client) {
+        int listener = socket(AF_INET, SOCK_STREAM, 0);
+        sockaddr_in address = {};
+        address.sin_family = AF_INET;
+        address.sin_addr.s_addr = htonl(INADDR_LOOPBACK);
+        socklen_t addressLength = sizeof(address);
+        if (listener == -1 || bind(listener, reinterpret_cast<sockaddr *>(&address), sizeof(address)) == -1 || listen(listener, 1) == -1
+            || getsockname(listener, reinterpret_cast<sockaddr *>(&address), &addressLength) == -1) {
+            close(listener);
+            return true;
+        }
+        client = socket(AF_INET, SOCK_STREAM, 0);
+        if (client == -1 || connect(client, reinterpret_cast<sockaddr *>(&address), sizeof(address)) == -1) {
+            close(listener);
+            close(client);
+            return true;
+        }
+        server = accept(listener, nullptr, nullptr);
+        close(listener);
+        if (server == -1) {
+            close(client);
+            return true;
+        }
+        return false;
+    }
+
+    test::Result testZeroCopyOverTcp() {
+        int server;
+        int client;
+        if (createTcpSockets(server, client)) return test::Result::ERROR;
+
+        NetworkOutputHandler output(server);
+        if (output.enableZeroCopy(1024)) {
+            std::cerr << "zero copy not supported\n";
+            close(server);
+            close(client);
+            return test::Result::ERROR;
+        }
+        NetworkOutputHandler::SharedBuffer frame = std::make_shared<const std::string>(std::string(100000, 'z'));
+        output.write("small");
+        output.write(frame);
+        int errorCode = output.flush(true, 1000);
+
+        std::string received;
+        char buffer[4096];
+        while (received.size() < 5 + frame->size()) {
+            ssize_t bytesRead = recv(client, buffer, sizeof(buffer), 0);
+            if (bytesRead <= 0) break;
+            received.append(buffer, bytesRead);
+        }
+        // the completion arrives once the bytes are acknowledged
+        for (int i = 0; i < 100 && output.zeroCopyPending() > 0; i++) {
+            std::this_thread::sleep_for(std::chrono::milliseconds(1));
+            output.releaseZeroCopyBuffers();
+        }
+        close(server);
+        close(client);
+
+        if (errorCode || received != "small" + *frame || output.zeroCopyPending() != 0 || frame.use_count() != 1) {
+            std::cerr << "flush returned code " << errorCode << ", received " << received.size() << " bytes, " << output.zeroCopyPending()
+                      << " buffers pending\n";
+            return test::Result::FAILURE;
+        }
+        return test::Result::SUCCESS;
+    }
+
+    test::Result testZeroCopyBuffersKeptUntilDestruction() {
+        int server;
+        int client;
+        if (createTcpSockets(server, client)) return test::Result::ERROR;
+        NetworkOutputHandler::SharedBuffer frame = std::make_shared<const std::string>(std::string(100000, 'z'));
+        int errorCode;
+        {
+            NetworkOutputHandler output(server);
+            if (output.enableZeroCopy(1024)) {
+                std::cerr << "zero copy not supported\n";
+                close(server);
+                close(client);
+                return test::Result::ERROR;
+            }
+            output.write(frame);
+            errorCode = output.flush(true, 1000);
+            // the owner drops its reference, the handler has to keep the buffer while the kernel can read it
+        }
+        long useCount = frame.use_count();
+        std::string received;
+        char buffer[4096];
+        while (received.size() < frame->size()) {
+            ssize_t bytesRead = recv(client, buffer, sizeof(buffer), 0);
+            if (bytesRead <= 0) break;
+            received.append(buffer, bytesRead);
+        }
+        // the destructor read the completion before giving the buffer back, no completion can arrive after it
+        pollfd pollSocket = {server, 0, 0};
+        bool completionLeft = poll(&pollSocket, 1, 100) != 0;
+        close(server);
+        close(client);
+
+        if (errorCode || useCount != 1 || completionLeft || received != *frame) {
+            std::cerr << "flush returned code " << errorCode << ", " << useCount << " references after destruction, completion "
+                      << (completionLeft ? "left" : "read") << ", received " << received.size() << " bytes\n";
+            return test::Result::FAILURE;
+        }
+        return test::Result::SUCCESS;
+    }
+
+    void testNetworkOutput(test::Tests *tests) {
+        tests->beginTestBlock("test network output handler");
+        tests->addTest(testFlushThresholdOfZero, "flush threshold of zero");
+        tests->addTest(testWriteQueuesUntilFlush, "write queues until flush");
+        tests->addTest(testWriteFlushesAtThreshold, "write flushes at threshold");
+        tests->addTest(testFlushPartialWrite, "flush partial write");
+        tests->addTest(testFlushRetryIfFull, "flush retry if full");
+        tests->addTest(testFlushRetryIfFullWithTimeout, "flush retry if full with timeout");
+        tests->addTest(testFlushCloseSocket, "flush close socket");
+        tests->endTestBlock();
+
+        tests->beginTestBlock("test broadcast");
+        tests->addTest(testWriteSharedBufferWithoutCopy, "write shared buffer without copy");
+        tests->addTest(testBroadcastGroup, "broadcast group");
+        tests->addTest(testBroadcastGroupErrorCallback, "broadcast group error callback");
+        tests->addTest(testZeroCopyNotSupportedByUnixSocket, "zero copy not supported by unix socket");
+        tests->addTest(testZeroCopyOverTcp, "zero copy over tcp");
+        tests->addTest(testZeroCopyBuffersKeptUntilDestruction, "zero copy buffers kept until destruction");
+        tests->endTestBlock();
+    }
+} // namespace networkOutputTests
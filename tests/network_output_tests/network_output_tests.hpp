@@ -0,0 +1,15 @@
+#ifndef NETWORK_OUTPUT_TESTS_HPP
+#define NETWORK_OUTPUT_TESTS_HPP
+
+#include "../../cpp_tests/src/tests.hpp"
+#include "../../src/network_output_handler/broadcast_group.hpp"
+#include "../../src/network_output_handler/network_output_handler.hpp"
+#include <arpa/inet.h>
+#include "../network_tests/network_tests.hpp"
+#include <thread>
+
+namespace networkOutputTests {
+    void testNetworkOutput(test::Tests *tests);
+} // namespace networkOutputTests
+
+#endif // NETWORK_OUTPUT_TESTS_HPP
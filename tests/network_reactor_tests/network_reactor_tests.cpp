@@ -0,0 +1,192 @@
+#include "network_reactor_tests.hpp"
+
+namespace networkReactorTests {
+    test::Result checkMessages(const std::vector<std::string> &messages, const std::vector<std::string> &expected) {
+        if (messages == expected) return test::Result::SUCCESS;
+        std::cerr << "Expected " << expected.size() << " messages, received " << messages.size() << ":\n";
+        for (const std::string &message : messages) {
+            std::cerr << "'" << message << "'\n";
+        }
+        return test::Result::FAILURE;
+    }
+
+    test::Result testReactorFixedLengthMessages() {
+        int fakeSocket[2];
+        if (networkTests::createSocket(fakeSocket, false)) return test::Result::ERROR;
+
+        NetworkReactor reactor = NetworkReactor(4);
+        std::vector<std::string> messages;
+
+        if (reactor.addFixedLength(fakeSocket[0], 5, [&messages](int, std::string_view message) { messages.emplace_back(message); })) {
+            close(fakeSocket[0]);
+            close(fakeSocket[1]);
+            return test::Result::ERROR;
+        }
+
+        const char *message = "HelloworldHello";
+        write(fakeSocket[1], message, strlen(message));
+        reactor.runOnce(1000);
+
+        close(fakeSocket[1]);
+        return checkMessages(messages, {"Hello", "world", "Hello"});
+    }
+
+    test::Result testReactorReceiveLowWatermark() {
+        int fakeSocket[2];
+        if (networkTests::createSocket(fakeSocket, false)) return test::Result::ERROR;
+
+        NetworkReactor reactor = NetworkReactor(64);
+        reactor.setReceiveLowWatermark(true);
+        std::vector<std::string> messages;
+
+        if (reactor.addFixedLength(fakeSocket[0], 10, [&messages](int, std::string_view message) { messages.emplace_back(message); })) {
+            close(fakeSocket[0]);
+            close(fakeSocket[1]);
+            return test::Result::ERROR;
+        }
+
+        write(fakeSocket[1], "Hell", 4);
+        reactor.runOnce(1000);
+        // the reactor is only woken up again once the 6 missing bytes are there
+        int watermark = -1;
+        socklen_t length = sizeof(watermark);
+        getsockopt(fakeSocket[0], SOL_SOCKET, SO_RCVLOWAT, &watermark, &length);
+        write(fakeSocket[1], "oworld", 6);
+        reactor.runOnce(1000);
+
+        close(fakeSocket[1]);
+        if (watermark != 6) {
+            std::cerr << "watermark " << watermark << "\n";
+            return test::Result::FAILURE;
+        }
+        return checkMessages(messages, {"Helloworld"});
+    }
+
+    test::Result testReactorDelimitedMessagesSplitBetweenWrites() {
+        int fakeSocket[2];
+        if (networkTests::createSocket(fakeSocket, false)) return test::Result::ERROR;
+
+        NetworkReactor reactor = NetworkReactor();
+        std::vector<std::string> messages;
+
+        if (reactor.addDelimited(fakeSocket[0], "\r\n", [&messages](int, std::string_view message) { messages.emplace_back(message); })) {
+            close(fakeSocket[0]);
+            close(fakeSocket[1]);
+            return test::Result::ERROR;
+        }
+
+        const char *first = "ab\r\ncd\r";
+        const char *second = "\nef\r\n";
+        write(fakeSocket[1], first, strlen(first));
+        reactor.runOnce(1000);
+        write(fakeSocket[1], second, strlen(second));
+        reactor.runOnce(1000);
+
+        close(fakeSocket[1]);
+        return checkMessages(messages, {"ab", "cd", "ef"});
+    }
+
+    test::Result testReactorBytesReceivedBeforeRegistration() {
+        int fakeSocket[2];
+        if (networkTests::createSocket(fakeSocket, false)) return test::Result::ERROR;
+
+        NetworkReactor reactor = NetworkReactor();
+        std::vector<std::string> messages;
+
+        const char *message = "Hello\n";
+        write(fakeSocket[1], message, strlen(message));
+
+        if (reactor.addDelimited(fakeSocket[0], "\n", [&messages](int, std::string_view message) { messages.emplace_back(message); })) {
+            close(fakeSocket[0]);
+            close(fakeSocket[1]);
+            return test::Result::ERROR;
+        }
+
+        close(fakeSocket[1]);
+        return checkMessages(messages, {"Hello"});
+    }
+
+    test::Result testReactorPeerClosed() {
+        int fakeSocket[2];
+        if (networkTests::createSocket(fakeSocket, false)) return test::Result::ERROR;
+
+        NetworkReactor reactor = NetworkReactor();
+        int closedSocket = -1;
+        reactor.setCloseCallback([&closedSocket](int socket) { closedSocket = socket; });
+
+        if (reactor.addDelimited(fakeSocket[0], "\n", [](int, std::string_view) {})) {
+            close(fakeSocket[0]);
+            close(fakeSocket[1]);
+            return test::Result::ERROR;
+        }
+
+        close(fakeSocket[1]);
+        reactor.runOnce(1000);
+
+        if (closedSocket != fakeSocket[0]) {
+            std::cerr << "close callback not called\n";
+            return test::Result::FAILURE;
+        }
+        if (reactor.connectionsCount() != 0) {
+            std::cerr << "connection not removed\n";
+            return test::Result::FAILURE;
+        }
+        return test::Result::SUCCESS;
+    }
+
+    test::Result testReactorRemoveFromCallback() {
+        int fakeSocket[2];
+        if (networkTests::createSocket(fakeSocket, false)) return test::Result::ERROR;
+
+        NetworkReactor reactor = NetworkReactor();
+        std::vector<std::string> messages;
+
+        if (reactor.addDelimited(fakeSocket[0], "\n", [&messages, &reactor](int socket, std::string_view message) {
+                messages.emplace_back(message);
+                reactor.remove(socket);
+            })) {
+            close(fakeSocket[0]);
+            close(fakeSocket[1]);
+            return test::Result::ERROR;
+        }
+
+        const char *message = "a\nb\n";
+        write(fakeSocket[1], message, strlen(message));
+        reactor.runOnce(1000);
+
+        close(fakeSocket[1]);
+        if (reactor.connectionsCount() != 0) {
+            std::cerr << "connection not removed\n";
+            return test::Result::FAILURE;
+        }
+        return checkMessages(messages, {"a"});
+    }
+
+    test::Result testReactorStop() {
+        NetworkReactor reactor = NetworkReactor();
+        int errorCode = -1;
+
+        std::thread runThread([&reactor, &errorCode] { errorCode = reactor.run(); });
+        std::this_thread::sleep_for(std::chrono::milliseconds(50));
+        reactor.stop();
+        runThread.join();
+
+        if (errorCode != 0) {
+            std::cerr << "run returned code " << errorCode << "\n";
+            return test::Result::FAILURE;
+        }
+        return test::Result::SUCCESS;
+    }
+
+    void testNetworkReactor(test::Tests *tests) {
+        tests->beginTestBlock("test network reactor");
+        tests->addTest(testReactorFixedLengthMessages, "fixed length messages");
+        tests->addTest(testReactorReceiveLowWatermark, "receive low watermark");
+        tests->addTest(testReactorDelimitedMessagesSplitBetweenWrites, "delimited messages split between writes");
+        tests->addTest(testReactorBytesReceivedBeforeRegistration, "bytes received before registration");
+        tests->addTest(testReactorPeerClosed, "peer closed");
+        tests->addTest(testReactorRemoveFromCallback, "remove from callback");
+        tests->addTest(testReactorStop, "stop");
+        tests->endTestBlock();
+    }
+} // namespace networkReactorTests
@@ -0,0 +1,13 @@
+#ifndef NETWORK_REACTOR_TESTS_HPP
+#define NETWORK_REACTOR_TESTS_HPP
+
+#include "../../cpp_tests/src/tests.hpp"
+#include "../../src/network_reactor/network_reactor.hpp"
+#include "../network_tests/network_tests.hpp"
+#include <thread>
+
+namespace networkReactorTests {
+    void testNetworkReactor(test::Tests *tests);
+} // namespace networkReactorTests
+
+#endif // NETWORK_REACTOR_TESTS_HPP
@@ -1302,6 +1302,1611 @@ namespace networkTests {
     }
 
 
+    test::Result testReadKeepsBytesAfterError() {
+        int fakeSocket[2];
+        if (createSocket(fakeSocket)) return test::Result::ERROR;
+
+        NetworkInputHandler inputHandler = NetworkInputHandler(fakeSocket[0]);
+
+        const char *hello = "Hello";
+        const char *world = "world";
+        write(fakeSocket[1], hello, strlen(hello));
+
+        std::string output;
+        int errorCode;
+
+        errorCode = inputHandler.read(10, output);
+
+        if (errorCode != 1) {
+            std::cerr << "read didn't failed and returned message \"" << output << "\"\n";
+            close(fakeSocket[0]);
+            close(fakeSocket[1]);
+            return test::Result::FAILURE;
+        }
+
+        write(fakeSocket[1], world, strlen(world));
+        errorCode = inputHandler.read(10, output);
+        close(fakeSocket[0]);
+        close(fakeSocket[1]);
+
+        if (errorCode) {
+            std::cerr << "read returned code " << errorCode << "\n";
+            std::cerr << "errno: " << errno << "\n";
+            return test::Result::FAILURE;
+        }
+
+        if (output == "Helloworld") return test::Result::SUCCESS;
+        std::cerr << "Expected 'Helloworld', received: '" << output << "'\n";
+        return test::Result::FAILURE;
+    }
+
+    test::Result testReadUntilDelimiterManyMessages() {
+        int fakeSocket[2];
+        if (createSocket(fakeSocket)) return test::Result::ERROR;
+
+        NetworkInputHandler inputHandler = NetworkInputHandler(fakeSocket[0], 8);
+
+        std::string messages;
+        for (int i = 0; i < 50; i++) {
+            messages += "msg" + std::to_string(10 + i) + "\n";
+        }
+        write(fakeSocket[1], messages.c_str(), messages.size());
+
+        std::string output;
+        int errorCode;
+
+        for (int i = 0; i < 50; i++) {
+            std::string expected = "msg" + std::to_string(10 + i);
+            errorCode = inputHandler.readUntilDelimiter('\n', output, false, true);
+            if (errorCode) {
+                std::cerr << "read returned code " << errorCode << " for message " << i << "\n";
+                std::cerr << "errno: " << errno << "\n";
+                close(fakeSocket[0]);
+                close(fakeSocket[1]);
+                return test::Result::FAILURE;
+            }
+            if (output != expected) {
+                std::cerr << "Expected '" << expected << "', received: '" << output << "'\n";
+                close(fakeSocket[0]);
+                close(fakeSocket[1]);
+                return test::Result::FAILURE;
+            }
+        }
+
+        close(fakeSocket[0]);
+        close(fakeSocket[1]);
+        return test::Result::SUCCESS;
+    }
+
+
+    test::Result testReadView() {
+        int fakeSocket[2];
+        if (createSocket(fakeSocket)) return test::Result::ERROR;
+
+        NetworkInputHandler inputHandler = NetworkInputHandler(fakeSocket[0], 3);
+
+        const char *message = "Helloworld";
+        write(fakeSocket[1], message, strlen(message));
+
+        std::string_view output;
+
+        int errorCode = inputHandler.readView(10, output);
+
+        close(fakeSocket[0]);
+        close(fakeSocket[1]);
+
+        if (errorCode) {
+            std::cerr << "read returned code " << errorCode << "\n";
+            std::cerr << "errno: " << errno << "\n";
+            return test::Result::FAILURE;
+        }
+
+        if (output == message) return test::Result::SUCCESS;
+        std::cerr << "Expected '" << message << "', received: '" << output << "'\n";
+        return test::Result::FAILURE;
+    }
+
+    test::Result testReadUntilDelimiterView() {
+        int fakeSocket[2];
+        if (createSocket(fakeSocket)) return test::Result::ERROR;
+
+        NetworkInputHandler inputHandler = NetworkInputHandler(fakeSocket[0], 3);
+
+        const char *message = "Hello\nworld\n";
+        write(fakeSocket[1], message, strlen(message));
+
+        std::string_view output;
+        int errorCode;
+
+        errorCode = inputHandler.readUntilDelimiterView('\n', output, false, true);
+
+        if (errorCode) {
+            std::cerr << "read returned code " << errorCode << "\n";
+            std::cerr << "errno: " << errno << "\n";
+            close(fakeSocket[0]);
+            close(fakeSocket[1]);
+            return test::Result::FAILURE;
+        }
+
+        if (output != "Hello") {
+            std::cerr << "Expected 'Hello', received: '" << output << "'\n";
+            close(fakeSocket[0]);
+            close(fakeSocket[1]);
+            return test::Result::FAILURE;
+        }
+
+        errorCode = inputHandler.readUntilDelimiterView('\n', output, true);
+        close(fakeSocket[0]);
+        close(fakeSocket[1]);
+
+        if (errorCode) {
+            std::cerr << "read returned code " << errorCode << "\n";
+            std::cerr << "errno: " << errno << "\n";
+            return test::Result::FAILURE;
+        }
+
+        if (output == "world\n") return test::Result::SUCCESS;
+        std::cerr << "Expected 'world\\n', received: '" << output << "'\n";
+        return test::Result::FAILURE;
+    }
+
+
+    test::Result testReadUntilMultiByteDelimiterSplitBetweenTwoRecv() {
+        int fakeSocket[2];
+        if (createSocket(fakeSocket)) return test::Result::ERROR;
+
+        NetworkInputHandler inputHandler = NetworkInputHandler(fakeSocket[0], 4);
+
+        // first recv gets "abc\r", the second one "\ndef"
+        const char *message = "abc\r\ndef\r\n";
+        write(fakeSocket[1], message, strlen(message));
+
+        std::string output;
+        int errorCode;
+
+        errorCode = inputHandler.readUntilDelimiter("\r\n", output, false, true);
+
+        if (errorCode) {
+            std::cerr << "read returned code " << errorCode << "\n";
+            std::cerr << "errno: " << errno << "\n";
+            close(fakeSocket[0]);
+            close(fakeSocket[1]);
+            return test::Result::FAILURE;
+        }
+
+        if (output != "abc") {
+            std::cerr << "Expected 'abc', received: '" << output << "'\n";
+            close(fakeSocket[0]);
+            close(fakeSocket[1]);
+            return test::Result::FAILURE;
+        }
+
+        errorCode = inputHandler.readUntilDelimiter("\r\n", output, true);
+        close(fakeSocket[0]);
+        close(fakeSocket[1]);
+
+        if (errorCode) {
+            std::cerr << "read returned code " << errorCode << "\n";
+            std::cerr << "errno: " << errno << "\n";
+            return test::Result::FAILURE;
+        }
+
+        if (output == "def\r\n") return test::Result::SUCCESS;
+        std::cerr << "Expected 'def\\r\\n', received: '" << output << "'\n";
+        return test::Result::FAILURE;
+    }
+
+    test::Result testReadUntilEmptyDelimiter() {
+        int fakeSocket[2];
+        if (createSocket(fakeSocket)) return test::Result::ERROR;
+
+        NetworkInputHandler inputHandler = NetworkInputHandler(fakeSocket[0]);
+        std::string output;
+        bool catched = false;
+
+        try {
+            inputHandler.readUntilDelimiter("", output);
+        }
+        catch (const std::invalid_argument &e) {
+            std::cerr << e.what() << '\n';
+            catched = true;
+        }
+
+        close(fakeSocket[0]);
+        close(fakeSocket[1]);
+
+        return catched ? test::Result::SUCCESS : test::Result::FAILURE;
+    }
+
+    test::Result testFindByteImplementations() {
+        std::string data(1000, 'a');
+        // every position, including the unaligned tails handled by the scalar loop
+        for (size_t position = 0; position <= data.size(); position++) {
+            if (position < data.size()) data[position] = '\n';
+            const char *begin = data.data();
+            const char *end = data.data() + data.size();
+            const char *expected = delimiterSearch::findByteScalar(begin, end, '\n');
+            const char *results[] = {
+                delimiterSearch::findByteSse2(begin, end, '\n'),
+                delimiterSearch::findByte(begin, end, '\n'),
+            };
+            for (const char *result : results) {
+                if (result != expected) {
+                    std::cerr << "delimiter at " << position << " found at " << result - begin << "\n";
+                    return test::Result::FAILURE;
+                }
+            }
+            if (position < data.size()) data[position] = 'a';
+        }
+        return test::Result::SUCCESS;
+    }
+
+    test::Result testFindMultiByteDelimiter() {
+        std::string data = "ab\r\r\n\r";
+        const char *begin = data.data();
+        const char *end = data.data() + data.size();
+
+        const char *result = delimiterSearch::find(begin, end, "\r\n");
+        if (result != begin + 3) {
+            std::cerr << "Expected delimiter at 3, found at " << result - begin << "\n";
+            return test::Result::FAILURE;
+        }
+
+        // incomplete delimiter at the end
+        result = delimiterSearch::find(begin + 4, end, "\r\n");
+        if (result != end) {
+            std::cerr << "Expected no delimiter, found at " << result - begin << "\n";
+            return test::Result::FAILURE;
+        }
+        return test::Result::SUCCESS;
+    }
+
+
+    test::Result testReadRetryIfNoByteReceivedTimeout() {
+        int fakeSocket[2];
+        if (createSocket(fakeSocket)) return test::Result::ERROR;
+
+        NetworkInputHandler inputHandler = NetworkInputHandler(fakeSocket[0]);
+
+        std::string output;
+
+        std::chrono::steady_clock::time_point start = std::chrono::steady_clock::now();
+        int errorCode = inputHandler.read(5, output, true, 100);
+        std::chrono::steady_clock::duration elapsed = std::chrono::steady_clock::now() - start;
+
+        close(fakeSocket[0]);
+        close(fakeSocket[1]);
+
+        if (errorCode != 3) {
+            std::cerr << "read returned code " << errorCode << " instead of " << 3 << "\n";
+            return test::Result::FAILURE;
+        }
+        if (elapsed < std::chrono::milliseconds(100)) {
+            std::cerr << "read returned before the timeout\n";
+            return test::Result::FAILURE;
+        }
+        return test::Result::SUCCESS;
+    }
+
+    test::Result testReadUntilDelimiterRetryIfNoByteReceivedWithTimeout() {
+        int fakeSocket[2];
+        if (createSocket(fakeSocket)) return test::Result::ERROR;
+
+        NetworkInputHandler inputHandler = NetworkInputHandler(fakeSocket[0]);
+
+        std::string output;
+
+        int errorCode;
+
+        std::thread readThread([&errorCode, &inputHandler, &output] { errorCode = inputHandler.readUntilDelimiter('\n', output, false, true, true, 5000); });
+
+        const char *message = "Hello\n";
+
+        std::thread writeThread([fakeSocket, message] {
+            std::this_thread::sleep_until(std::chrono::steady_clock::now() + std::chrono::milliseconds(100));
+            write(fakeSocket[1], message, strlen(message));
+        });
+
+        readThread.join();
+        writeThread.join();
+
+        close(fakeSocket[0]);
+        close(fakeSocket[1]);
+
+        if (errorCode) {
+            std::cerr << "read returned code " << errorCode << "\n";
+            std::cerr << "errno: " << errno << "\n";
+            return test::Result::FAILURE;
+        }
+
+        if (output == "Hello") return test::Result::SUCCESS;
+        std::cerr << "Expected 'Hello', received: '" << output << "'\n";
+        return test::Result::FAILURE;
+    }
+
+    test::Result testReadWithIoUring() {
+        int fakeSocket[2];
+        if (createSocket(fakeSocket)) return test::Result::ERROR;
+
+        NetworkInputHandler inputHandler = NetworkInputHandler(fakeSocket[0], 4);
+        if (inputHandler.useIoUring(4)) {
+            bool fallback = !inputHandler.usesIoUring();
+            close(fakeSocket[0]);
+            close(fakeSocket[1]);
+            if (!fallback) return test::Result::FAILURE;
+            std::cerr << "io_uring not available (needs IO_URING=1 and linux 5.19+), skipped\n";
+            return test::Result::SUCCESS;
+        }
+
+        const char *message = "Hello\nworld\n";
+        write(fakeSocket[1], message, strlen(message));
+
+        std::string output;
+        int errorCode;
+
+        errorCode = inputHandler.readUntilDelimiter('\n', output, false, true, true, 1000);
+
+        if (errorCode || output != "Hello") {
+            std::cerr << "read returned code " << errorCode << " and message '" << output << "'\n";
+            close(fakeSocket[0]);
+            close(fakeSocket[1]);
+            return test::Result::FAILURE;
+        }
+
+        errorCode = inputHandler.read(6, output);
+
+        if (errorCode || output != "world\n") {
+            std::cerr << "read returned code " << errorCode << " and message '" << output << "'\n";
+            close(fakeSocket[0]);
+            close(fakeSocket[1]);
+            return test::Result::FAILURE;
+        }
+
+        std::thread writeThread([fakeSocket] {
+            std::this_thread::sleep_until(std::chrono::steady_clock::now() + std::chrono::milliseconds(100));
+            write(fakeSocket[1], "!!", 2);
+        });
+
+        errorCode = inputHandler.read(2, output, true, 1000);
+        writeThread.join();
+        close(fakeSocket[1]);
+
+        if (errorCode || output != "!!") {
+            std::cerr << "read returned code " << errorCode << " and message '" << output << "'\n";
+            close(fakeSocket[0]);
+            return test::Result::FAILURE;
+        }
+
+        errorCode = inputHandler.read(1, output, true, 1000);
+        close(fakeSocket[0]);
+
+        // the receiver falls back to recv if the kernel rejects the multishot recv, the bytes must have come from io_uring
+        if (errorCode != 2 || !inputHandler.usesIoUring()) {
+            std::cerr << "read returned code " << errorCode << " instead of " << 2 << (inputHandler.usesIoUring() ? "" : ", fell back to recv") << "\n";
+            return test::Result::FAILURE;
+        }
+        return test::Result::SUCCESS;
+    }
+
+    test::Result testDestroyIoUringReceiver() {
+        int fakeSocket[2];
+        if (createSocket(fakeSocket)) return test::Result::ERROR;
+
+        {
+            NetworkInputHandler inputHandler = NetworkInputHandler(fakeSocket[0], 4);
+            if (inputHandler.useIoUring(4)) {
+                close(fakeSocket[0]);
+                close(fakeSocket[1]);
+                std::cerr << "io_uring not available (needs IO_URING=1 and linux 5.19+), skipped\n";
+                return test::Result::SUCCESS;
+            }
+
+            write(fakeSocket[1], "Hello", 5);
+            std::string output;
+            int errorCode = inputHandler.read(5, output, true, 1000);
+            if (errorCode || output != "Hello") {
+                std::cerr << "read returned code " << errorCode << " and message '" << output << "'\n";
+                close(fakeSocket[0]);
+                close(fakeSocket[1]);
+                return test::Result::FAILURE;
+            }
+        }
+
+        // the multishot recv is cancelled with the handler, the next bytes stay in the socket
+        write(fakeSocket[1], "world", 5);
+        char buffer[8] = {};
+        pollfd pollSocket = {fakeSocket[0], POLLIN, 0};
+        ssize_t received = poll(&pollSocket, 1, 1000) == 1 ? recv(fakeSocket[0], buffer, sizeof(buffer), MSG_DONTWAIT) : -1;
+        close(fakeSocket[0]);
+        close(fakeSocket[1]);
+
+        if (received != 5 || std::string_view(buffer, 5) != "world") {
+            std::cerr << "recv after destruction returned " << received << "\n";
+            return test::Result::FAILURE;
+        }
+        return test::Result::SUCCESS;
+    }
+
+    test::Result checkBatch(const std::vector<std::string_view> &messages, const std::vector<std::string_view> &expected) {
+        if (messages == expected) return test::Result::SUCCESS;
+        std::cerr << "Expected " << expected.size() << " messages, received " << messages.size() << ":\n";
+        for (std::string_view message : messages) {
+            std::cerr << "'" << message << "'\n";
+        }
+        return test::Result::FAILURE;
+    }
+
+    test::Result testReadAllUntilDelimiter() {
+        int fakeSocket[2];
+        if (createSocket(fakeSocket)) return test::Result::ERROR;
+
+        NetworkInputHandler inputHandler = NetworkInputHandler(fakeSocket[0], 64);
+
+        const char *first = "a\nbb\nccc\nd";
+        write(fakeSocket[1], first, strlen(first));
+
+        std::vector<std::string_view> messages;
+        int errorCode;
+
+        errorCode = inputHandler.readAllUntilDelimiter("\n", messages);
+
+        if (errorCode || checkBatch(messages, {"a", "bb", "ccc"}) != test::Result::SUCCESS) {
+            std::cerr << "read returned code " << errorCode << "\n";
+            close(fakeSocket[0]);
+            close(fakeSocket[1]);
+            return test::Result::FAILURE;
+        }
+
+        write(fakeSocket[1], "\n", 1);
+        errorCode = inputHandler.readAllUntilDelimiter("\n", messages, true);
+        close(fakeSocket[0]);
+        close(fakeSocket[1]);
+
+        if (errorCode) {
+            std::cerr << "read returned code " << errorCode << "\n";
+            return test::Result::FAILURE;
+        }
+        return checkBatch(messages, {"d\n"});
+    }
+
+    test::Result testReadAllUntilDelimiterStoppedByCallback() {
+        int fakeSocket[2];
+        if (createSocket(fakeSocket)) return test::Result::ERROR;
+
+        NetworkInputHandler inputHandler = NetworkInputHandler(fakeSocket[0], 64);
+
+        const char *message = "a\nb\nc\n";
+        write(fakeSocket[1], message, strlen(message));
+
+        std::vector<std::string_view> messages;
+        int errorCode;
+
+        errorCode = inputHandler.readAllUntilDelimiter("\n", [&messages](std::string_view message) {
+            messages.push_back(message);
+            return false;
+        });
+
+        if (errorCode || checkBatch(messages, {"a"}) != test::Result::SUCCESS) {
+            std::cerr << "read returned code " << errorCode << "\n";
+            close(fakeSocket[0]);
+            close(fakeSocket[1]);
+            return test::Result::FAILURE;
+        }
+
+        errorCode = inputHandler.readAllUntilDelimiter("\n", messages);
+        close(fakeSocket[0]);
+        close(fakeSocket[1]);
+
+        if (errorCode) {
+            std::cerr << "read returned code " << errorCode << "\n";
+            return test::Result::FAILURE;
+        }
+        return checkBatch(messages, {"b", "c"});
+    }
+
+    test::Result testReadAllLengthPrefixed() {
+        int fakeSocket[2];
+        if (createSocket(fakeSocket)) return test::Result::ERROR;
+
+        NetworkInputHandler inputHandler = NetworkInputHandler(fakeSocket[0], 64);
+
+        const char first[] = "\0\5hello\0\2hi\0\10par";
+        write(fakeSocket[1], first, sizeof(first) - 1);
+
+        std::vector<std::string_view> messages;
+        int errorCode;
+
+        errorCode = inputHandler.readAllLengthPrefixed(2, messages);
+
+        if (errorCode || checkBatch(messages, {"hello", "hi"}) != test::Result::SUCCESS) {
+            std::cerr << "read returned code " << errorCode << "\n";
+            close(fakeSocket[0]);
+            close(fakeSocket[1]);
+            return test::Result::FAILURE;
+        }
+
+        const char *second = "tial!";
+        write(fakeSocket[1], second, strlen(second));
+        errorCode = inputHandler.readAllLengthPrefixed(2, messages);
+        close(fakeSocket[0]);
+        close(fakeSocket[1]);
+
+        if (errorCode) {
+            std::cerr << "read returned code " << errorCode << "\n";
+            return test::Result::FAILURE;
+        }
+        return checkBatch(messages, {"partial!"});
+    }
+
+    test::Result testReadAllLengthPrefixedOverflowingLength() {
+        int fakeSocket[2];
+        if (createSocket(fakeSocket)) return test::Result::ERROR;
+        NetworkInputHandler inputHandler(fakeSocket[0], 64);
+        // a valid message, then a header announcing SIZE_MAX bytes: header size + length overflows
+        std::string bytes = std::string("\0\0\0\0\0\0\0\2hi", 10) + std::string(8, '\xff');
+        write(fakeSocket[1], bytes.data(), bytes.size());
+
+        std::vector<std::string_view> messages;
+        int firstCode = inputHandler.readAllLengthPrefixed(8, messages);
+        std::vector<std::string> first(messages.begin(), messages.end());
+        int overflowCode = inputHandler.readAllLengthPrefixed(8, messages);
+        close(fakeSocket[0]);
+        close(fakeSocket[1]);
+
+        if (firstCode != 0 || first != std::vector<std::string>{"hi"} || overflowCode != 4 || !messages.empty()) {
+            std::cerr << firstCode << " with " << first.size() << " messages, then " << overflowCode << " with " << messages.size() << " messages\n";
+            return test::Result::FAILURE;
+        }
+        return test::Result::SUCCESS;
+    }
+
+    test::Result testReadFrameFixedHeader() {
+        int fakeSocket[2];
+        if (createSocket(fakeSocket)) return test::Result::ERROR;
+        NetworkInputHandler inputHandler(fakeSocket[0], 4);
+        FrameReader frameReader(inputHandler, FrameReader::HeaderType::FIXED_16);
+        std::string message;
+        FrameReader::encodeHeader(FrameReader::HeaderType::FIXED_16, 11, message);
+        message += "hello world";
+        FrameReader::encodeHeader(FrameReader::HeaderType::FIXED_16, 0, message);
+        write(fakeSocket[1], message.data(), message.size());
+
+        std::string_view first;
+        std::string second = "not empty";
+        int firstCode = frameReader.readFrame(first);
+        std::string firstCopy(first);
+        int secondCode = frameReader.readFrame(second);
+        close(fakeSocket[0]);
+        close(fakeSocket[1]);
+
+        if (firstCode || firstCopy != "hello world" || secondCode || !second.empty()) {
+            std::cerr << "read returned codes " << firstCode << " and " << secondCode << " with \"" << firstCopy << "\" and \"" << second << "\"\n";
+            return test::Result::FAILURE;
+        }
+        return test::Result::SUCCESS;
+    }
+
+    test::Result testReadFrameFromMemory() {
+        std::string capture;
+        FrameReader::encodeHeader(FrameReader::HeaderType::VARINT, 300, capture);
+        capture += std::string(300, 'a');
+        FrameReader::encodeHeader(FrameReader::HeaderType::VARINT, 5, capture);
+        capture += "hello";
+        MemoryInputHandler inputHandler(MemoryTransport(capture), 16);
+        MemoryFrameReader frameReader(inputHandler, FrameReader::HeaderType::VARINT);
+
+        std::string first;
+        std::string_view second;
+        std::string_view end;
+        int firstCode = frameReader.readFrame(first);
+        int secondCode = frameReader.readFrame(second);
+        std::string secondCopy(second);
+        int endCode = frameReader.readFrame(end);
+
+        // the end of the capture is a closed socket
+        if (firstCode || first != std::string(300, 'a') || secondCode || secondCopy != "hello" || endCode != 2) {
+            std::cerr << "read returned codes " << firstCode << ", " << secondCode << " and " << endCode << " with " << first.size() << " and "
+                      << secondCopy.size() << " bytes\n";
+            return test::Result::FAILURE;
+        }
+        return test::Result::SUCCESS;
+    }
+
+    test::Result testReadFrameVarintHeaderSplitBetweenTwoRecv() {
+        int fakeSocket[2];
+        if (createSocket(fakeSocket)) return test::Result::ERROR;
+        NetworkInputHandler inputHandler(fakeSocket[0]);
+        FrameReader frameReader(inputHandler, FrameReader::HeaderType::VARINT);
+        std::string payload(300, 'a');
+        std::string message;
+        FrameReader::encodeHeader(FrameReader::HeaderType::VARINT, payload.size(), message);
+        message += payload;
+
+        // only the first byte of the two bytes header
+        write(fakeSocket[1], message.data(), 1);
+        std::string_view frame;
+        int errorCode = frameReader.readFrame(frame);
+        if (errorCode != 1) {
+            std::cerr << "read of incomplete header returned code " << errorCode << "\n";
+            close(fakeSocket[0]);
+            close(fakeSocket[1]);
+            return test::Result::FAILURE;
+        }
+
+        write(fakeSocket[1], message.data() + 1, message.size() - 1);
+        errorCode = frameReader.readFrame(frame, true);
+        close(fakeSocket[0]);
+        close(fakeSocket[1]);
+
+        if (errorCode || frame != payload) {
+            std::cerr << "read returned code " << errorCode << " with a frame of " << frame.size() << " bytes\n";
+            return test::Result::FAILURE;
+        }
+        return test::Result::SUCCESS;
+    }
+
+    test::Result testReadFrameSplitHeaderDoesNotWait() {
+        int fakeSocket[2];
+        if (createSocket(fakeSocket)) return test::Result::ERROR;
+        NetworkInputHandler inputHandler(fakeSocket[0]);
+        FrameReader frameReader(inputHandler, FrameReader::HeaderType::VARINT);
+        std::string message;
+        FrameReader::encodeHeader(FrameReader::HeaderType::VARINT, 300, message);
+
+        // the first byte is received, waiting stops there even if the header is not complete
+        write(fakeSocket[1], message.data(), 1);
+        auto start = std::chrono::steady_clock::now();
+        std::string_view frame;
+        int errorCode = frameReader.readFrame(frame, true, 1000);
+        int errorErrno = errno;
+        auto elapsed = std::chrono::steady_clock::now() - start;
+        close(fakeSocket[0]);
+        close(fakeSocket[1]);
+
+        if (errorCode != 1 || errorErrno != EAGAIN || elapsed >= std::chrono::milliseconds(500)) {
+            std::cerr << "read returned code " << errorCode << " (" << strerror(errorErrno) << ") after "
+                      << std::chrono::duration_cast<std::chrono::milliseconds>(elapsed).count() << " ms\n";
+            return test::Result::FAILURE;
+        }
+        return test::Result::SUCCESS;
+    }
+
+    test::Result testReadFrameBiggerThanMaxFrameSize() {
+        int fakeSocket[2];
+        if (createSocket(fakeSocket)) return test::Result::ERROR;
+        NetworkInputHandler inputHandler(fakeSocket[0]);
+        FrameReader frameReader(inputHandler, FrameReader::HeaderType::FIXED_32, 8);
+        std::string message;
+        FrameReader::encodeHeader(FrameReader::HeaderType::FIXED_32, 9, message);
+        message += "too long!";
+        write(fakeSocket[1], message.data(), message.size());
+
+        std::string_view frame;
+        int errorCode = frameReader.readFrame(frame);
+        close(fakeSocket[0]);
+        close(fakeSocket[1]);
+
+        if (errorCode != 4) {
+            std::cerr << "read returned code " << errorCode << "\n";
+            return test::Result::FAILURE;
+        }
+        return test::Result::SUCCESS;
+    }
+
+    test::Result testReadFrameWithoutMaxFrameSize() {
+        int fakeSocket[2];
+        if (createSocket(fakeSocket)) return test::Result::ERROR;
+        NetworkInputHandler inputHandler(fakeSocket[0]);
+        FrameReader frameReader(inputHandler, FrameReader::HeaderType::FIXED_64, SIZE_MAX);
+        // announces SIZE_MAX bytes, the size of the frame with its header overflows
+        write(fakeSocket[1], std::string(8, '\xff').data(), 8);
+
+        std::string_view frame;
+        int errorCode = frameReader.readFrame(frame);
+        close(fakeSocket[0]);
+        close(fakeSocket[1]);
+
+        if (errorCode != 4) {
+            std::cerr << "read returned code " << errorCode << "\n";
+            return test::Result::FAILURE;
+        }
+        return test::Result::SUCCESS;
+    }
+
+    test::Result testReadFrameInvalidVarint() {
+        int fakeSocket[2];
+        if (createSocket(fakeSocket)) return test::Result::ERROR;
+        NetworkInputHandler inputHandler(fakeSocket[0]);
+        FrameReader frameReader(inputHandler, FrameReader::HeaderType::VARINT, SIZE_MAX);
+        // more than 10 bytes with the continuation bit
+        std::string message(11, '\xff');
+        write(fakeSocket[1], message.data(), message.size());
+
+        std::string_view frame;
+        int errorCode = frameReader.readFrame(frame);
+        close(fakeSocket[0]);
+        close(fakeSocket[1]);
+
+        if (errorCode != 4) {
+            std::cerr << "read returned code " << errorCode << "\n";
+            return test::Result::FAILURE;
+        }
+        return test::Result::SUCCESS;
+    }
+
+    test::Result testAdaptiveBufferSizeGrowsForBigMessage() {
+        int fakeSocket[2];
+        if (createSocket(fakeSocket)) return test::Result::ERROR;
+        NetworkInputHandler inputHandler(fakeSocket[0], 16);
+        inputHandler.setAdaptiveBufferSize(16, 1 << 16);
+        std::string message(10000, 'a');
+        write(fakeSocket[1], message.data(), message.size());
+
+        std::string out;
+        int errorCode = inputHandler.read(message.size(), out);
+        close(fakeSocket[0]);
+        close(fakeSocket[1]);
+
+        // 625 recv of 16 bytes without adaptive buffer size
+        if (errorCode || out != message || inputHandler.syscalls() > 2) {
+            std::cerr << "read returned code " << errorCode << " after " << inputHandler.syscalls() << " syscalls\n";
+            return test::Result::FAILURE;
+        }
+        return test::Result::SUCCESS;
+    }
+
+    test::Result testAdaptiveBufferSizeShrinksForSmallMessages() {
+        int fakeSocket[2];
+        if (createSocket(fakeSocket)) return test::Result::ERROR;
+        NetworkInputHandler inputHandler(fakeSocket[0], 4096);
+        inputHandler.setAdaptiveBufferSize(64, 4096);
+        std::string out;
+        int errorCode = 0;
+
+        for (int i = 0; i < 64 && !errorCode; i++) {
+            write(fakeSocket[1], "hi\n", 3);
+            errorCode = inputHandler.readUntilDelimiter('\n', out, false, true);
+        }
+        close(fakeSocket[0]);
+        close(fakeSocket[1]);
+
+        if (errorCode || out != "hi" || inputHandler.bufferSize() != 64) {
+            std::cerr << "read returned code " << errorCode << " with a buffer size of " << inputHandler.bufferSize() << "\n";
+            return test::Result::FAILURE;
+        }
+        return test::Result::SUCCESS;
+    }
+
+    test::Result testAdaptiveBufferSizeInvalidBounds() {
+        int fakeSocket[2];
+        if (createSocket(fakeSocket)) return test::Result::ERROR;
+        NetworkInputHandler inputHandler(fakeSocket[0]);
+        int catched = 0;
+
+        try {
+            inputHandler.setAdaptiveBufferSize(0, 1024);
+        }
+        catch (const std::invalid_argument &e) {
+            catched++;
+        }
+        try {
+            inputHandler.setAdaptiveBufferSize(2048, 1024);
+        }
+        catch (const std::invalid_argument &e) {
+            catched++;
+        }
+
+        close(fakeSocket[0]);
+        close(fakeSocket[1]);
+        return catched == 2 ? test::Result::SUCCESS : test::Result::FAILURE;
+    }
+
+    test::Result testReadDirectlyIntoOutKeepsOvershoot() {
+        int fakeSocket[2];
+        if (createSocket(fakeSocket)) return test::Result::ERROR;
+        NetworkInputHandler inputHandler(fakeSocket[0], 8);
+        std::string message(1000, 'a');
+        std::string sent = message + "next";
+        write(fakeSocket[1], sent.data(), sent.size());
+
+        std::string first;
+        std::string second;
+        int firstCode = inputHandler.read(message.size(), first);
+        int secondCode = inputHandler.read(4, second);
+        close(fakeSocket[0]);
+        close(fakeSocket[1]);
+
+        // only the 4 bytes of the second message are copied
+        if (firstCode || first != message || secondCode || second != "next" || inputHandler.copiedBytes() != 4) {
+            std::cerr << "read returned codes " << firstCode << " and " << secondCode << " with \"" << second << "\" after copying "
+                      << inputHandler.copiedBytes() << " bytes\n";
+            return test::Result::FAILURE;
+        }
+        return test::Result::SUCCESS;
+    }
+
+    test::Result testReadDirectlyIntoOutKeepsBytesAfterError() {
+        int fakeSocket[2];
+        if (createSocket(fakeSocket)) return test::Result::ERROR;
+        NetworkInputHandler inputHandler(fakeSocket[0], 8);
+        std::string message(1000, 'a');
+        write(fakeSocket[1], message.data(), 600);
+
+        std::string out;
+        int firstCode = inputHandler.read(message.size(), out);
+        write(fakeSocket[1], message.data() + 600, message.size() - 600);
+        int secondCode = inputHandler.read(message.size(), out);
+        close(fakeSocket[0]);
+        close(fakeSocket[1]);
+
+        if (firstCode != 1 || secondCode || out != message) {
+            std::cerr << "read returned codes " << firstCode << " and " << secondCode << " with " << out.size() << " bytes\n";
+            return test::Result::FAILURE;
+        }
+        return test::Result::SUCCESS;
+    }
+
+    test::Result testReadBigMessageReceivedInParts() {
+        int fakeSocket[2];
+        if (createSocket(fakeSocket)) return test::Result::ERROR;
+        NetworkInputHandler inputHandler(fakeSocket[0], 1024);
+        std::string message;
+        for (size_t i = 0; i < 256 * 1024; i++) message += static_cast<char>('a' + i % 26);
+
+        // the message arrives in 64 parts, each read gets one part and returns incomplete until the last one
+        std::string out;
+        int errorCode = 1;
+        size_t incompleteReads = 0;
+        for (size_t offset = 0; offset < message.size(); offset += 4096) {
+            write(fakeSocket[1], message.data() + offset, 4096);
+            errorCode = inputHandler.read(message.size(), out);
+            if (errorCode == 1) incompleteReads++;
+        }
+        close(fakeSocket[0]);
+        close(fakeSocket[1]);
+
+        // the received bytes are not copied again by every read: one copy into out, and less for the growth of the buffer
+        if (errorCode || out != message || incompleteReads != 63 || inputHandler.copiedBytes() > 2 * message.size()) {
+            std::cerr << "read returned code " << errorCode << " with " << out.size() << " bytes after " << incompleteReads << " incomplete reads, "
+                      << inputHandler.copiedBytes() << " bytes copied\n";
+            return test::Result::FAILURE;
+        }
+        return test::Result::SUCCESS;
+    }
+
+    test::Result testSlabPoolSizeOfZero() {
+        bool catched = false;
+        try {
+            SlabPool pool(0);
+        }
+        catch (const std::invalid_argument &e) {
+            std::cerr << e.what() << '\n';
+            catched = true;
+        }
+        return catched ? test::Result::SUCCESS : test::Result::FAILURE;
+    }
+
+    test::Result testSlabPoolGivenBackWhenDrained() {
+        int fakeSocket[2];
+        if (createSocket(fakeSocket)) return test::Result::ERROR;
+        SlabPool pool(64);
+        NetworkInputHandler inputHandler(fakeSocket[0], 16);
+        inputHandler.useSlabPool(pool);
+        size_t borrowedWhenIdle = pool.statistics().borrowedSlabs;
+
+        // the second message is partial, its bytes are kept in the slab
+        write(fakeSocket[1], "Hello wor", 9);
+        std::string first;
+        std::string second;
+        int firstCode = inputHandler.read(5, first);
+        int partialCode = inputHandler.read(5, second);
+        size_t borrowedWithPartialMessage = pool.statistics().borrowedSlabs;
+        write(fakeSocket[1], "ld", 2);
+        int secondCode = inputHandler.read(5, second, true);
+        // "d" is still waiting for the rest of its message, the slab stays borrowed
+        std::string third;
+        int emptyCode = inputHandler.read(5, third);
+        SlabPool::Statistics statistics = pool.statistics();
+        close(fakeSocket[0]);
+        close(fakeSocket[1]);
+
+        if (borrowedWhenIdle != 0 || firstCode || first != "Hello" || partialCode != 1 || borrowedWithPartialMessage != 1 || secondCode
+            || second != " worl" || emptyCode != 1 || statistics.borrowedSlabs != 1 || statistics.allocations != 1) {
+            std::cerr << "read returned codes " << firstCode << ", " << partialCode << ", " << secondCode << " and " << emptyCode << " with "
+                      << statistics.borrowedSlabs << " slabs borrowed\n";
+            return test::Result::FAILURE;
+        }
+        return test::Result::SUCCESS;
+    }
+
+    test::Result testSlabPoolIdleConnectionTakesNoSlab() {
+        int fakeSocket[2];
+        if (createSocket(fakeSocket)) return test::Result::ERROR;
+        SlabPool pool(64);
+        NetworkInputHandler inputHandler(fakeSocket[0], 16);
+        inputHandler.useSlabPool(pool);
+
+        write(fakeSocket[1], "Hello\n", 6);
+        std::string message;
+        int messageCode = inputHandler.readUntilDelimiter('\n', message, false, true);
+        int idleCode = inputHandler.readUntilDelimiter('\n', message, false, true);
+        SlabPool::Statistics statistics = pool.statistics();
+        close(fakeSocket[0]);
+        close(fakeSocket[1]);
+
+        if (messageCode || message != "Hello" || idleCode != 1 || statistics.borrowedSlabs != 0 || statistics.freeSlabs != 1
+            || statistics.peakBorrowedSlabs != 1) {
+            std::cerr << "read returned codes " << messageCode << " and " << idleCode << " with " << statistics.borrowedSlabs
+                      << " slabs borrowed\n";
+            return test::Result::FAILURE;
+        }
+        return test::Result::SUCCESS;
+    }
+
+    test::Result testSlabPoolBlockingSocket() {
+        int fakeSocket[2];
+        if (createSocket(fakeSocket, false)) return test::Result::ERROR;
+        SlabPool pool(64);
+        NetworkInputHandler inputHandler(fakeSocket[0], 16);
+        inputHandler.useSlabPool(pool);
+
+        // every read takes exactly what is queued, no recv ever finds the socket empty
+        write(fakeSocket[1], "Hello\n", 6);
+        std::string message;
+        int messageCode = inputHandler.readUntilDelimiter('\n', message, false, true);
+        size_t borrowedAfterCopy = pool.statistics().borrowedSlabs;
+        write(fakeSocket[1], "view", 4);
+        std::string_view view;
+        int viewCode = inputHandler.readView(4, view);
+        // the view points into the slab, kept until the next call
+        size_t borrowedWithView = pool.statistics().borrowedSlabs;
+        std::string viewCopy(view);
+        write(fakeSocket[1], "last", 4);
+        std::string last;
+        int lastCode = inputHandler.read(4, last);
+        size_t borrowedAfterLast = pool.statistics().borrowedSlabs;
+        close(fakeSocket[0]);
+        close(fakeSocket[1]);
+
+        if (messageCode || message != "Hello" || viewCode || viewCopy != "view" || lastCode || last != "last" || borrowedAfterCopy != 0
+            || borrowedWithView != 1 || borrowedAfterLast != 0) {
+            std::cerr << "read returned codes " << messageCode << ", " << viewCode << " and " << lastCode << " with " << borrowedAfterCopy << ", "
+                      << borrowedWithView << " and " << borrowedAfterLast << " slabs borrowed\n";
+            return test::Result::FAILURE;
+        }
+        return test::Result::SUCCESS;
+    }
+
+    test::Result testSlabPoolMessageBiggerThanSlab() {
+        int fakeSocket[2];
+        if (createSocket(fakeSocket)) return test::Result::ERROR;
+        SlabPool pool(32);
+        NetworkInputHandler inputHandler(fakeSocket[0], 16);
+        inputHandler.useSlabPool(pool);
+        std::string message(100, 'a');
+        message += "\n";
+        write(fakeSocket[1], message.data(), message.size());
+
+        std::string out;
+        int errorCode = inputHandler.readUntilDelimiter('\n', out, false, true);
+        int idleCode = inputHandler.readUntilDelimiter('\n', out, false, true);
+        SlabPool::Statistics statistics = pool.statistics();
+        close(fakeSocket[0]);
+        close(fakeSocket[1]);
+
+        // the buffer grows out of the slab, then goes back to the pool when drained
+        if (errorCode || out.size() != 100 || idleCode != 1 || statistics.borrowedSlabs != 0) {
+            std::cerr << "read returned code " << errorCode << " with " << out.size() << " bytes\n";
+            return test::Result::FAILURE;
+        }
+        return test::Result::SUCCESS;
+    }
+
+    test::Result testSlabPoolThreads() {
+        SlabPool pool(64);
+        const size_t threadsCount = 4;
+        const size_t borrowsPerThread = 10000;
+        std::vector<std::thread> threads;
+        std::atomic<bool> corrupted = false;
+        for (size_t i = 0; i < threadsCount; i++) {
+            threads.emplace_back([&pool, &corrupted, i]() {
+                for (size_t j = 0; j < borrowsPerThread; j++) {
+                    // two slabs at a time, both written to catch a slab borrowed twice
+                    char *first = pool.borrow();
+                    char *second = pool.borrow();
+                    std::memset(first, static_cast<int>(i), 64);
+                    std::memset(second, static_cast<int>(i), 64);
+                    if (first == second || first[63] != static_cast<char>(i) || second[63] != static_cast<char>(i)) corrupted = true;
+                    pool.giveBack(first);
+                    pool.giveBack(second);
+                }
+            });
+        }
+        for (std::thread &thread : threads) {
+            thread.join();
+        }
+        SlabPool::Statistics statistics = pool.statistics();
+
+        // the threads take the mutex when their own slabs run out, not for every borrow
+        if (corrupted || statistics.borrows != 2 * threadsCount * borrowsPerThread || statistics.borrowedSlabs != 0
+            || statistics.sharedBorrows > 2 * threadsCount || statistics.freeSlabs != statistics.allocatedSlabs) {
+            std::cerr << (corrupted ? "slab borrowed twice, " : "") << statistics.borrows << " borrows, " << statistics.sharedBorrows
+                      << " with the mutex, " << statistics.borrowedSlabs << " still borrowed\n";
+            return test::Result::FAILURE;
+        }
+        return test::Result::SUCCESS;
+    }
+
+    test::Result testStatistics() {
+        int fakeSocket[2];
+        if (createSocket(fakeSocket)) return test::Result::ERROR;
+        NetworkInputHandler inputHandler(fakeSocket[0], 8);
+        write(fakeSocket[1], "Hello\nworld!\npart", 18);
+
+        std::string message;
+        inputHandler.readUntilDelimiter('\n', message, false, true);
+        inputHandler.readUntilDelimiter('\n', message, false, true);
+        // "part" is incomplete, then the socket has nothing more
+        int incompleteCode = inputHandler.readUntilDelimiter('\n', message, false, true);
+        int wouldBlockCode = inputHandler.readUntilDelimiter('\n', message, false, true);
+        NetworkInputStatistics statistics = inputHandler.statistics();
+        close(fakeSocket[0]);
+        close(fakeSocket[1]);
+
+        if (incompleteCode != 1 || wouldBlockCode != 1 || statistics.bytesReceived != 18 || statistics.messagesRead != 2 || statistics.largestMessage != 6
+            || statistics.incompleteReads != 1 || statistics.wouldBlock != 1 || statistics.recvCalls != statistics.syscalls
+            || statistics.bytesCopied != 11 + statistics.bytesCarriedOver) {
+            std::cerr << "received " << statistics.bytesReceived << " bytes in " << statistics.recvCalls << " recv, " << statistics.messagesRead
+                      << " messages of at most " << statistics.largestMessage << " bytes, " << statistics.incompleteReads << " incomplete reads, "
+                      << statistics.wouldBlock << " would block, " << statistics.bytesCopied << " bytes copied\n";
+            return test::Result::FAILURE;
+        }
+        return test::Result::SUCCESS;
+    }
+
+    test::Result testFileTransportPipe() {
+        int pipeFds[2];
+        if (pipe(pipeFds) != 0) return test::Result::ERROR;
+        FileInputHandler inputHandler(FileTransport(pipeFds[0]), 4);
+        write(pipeFds[1], "Hello\nworld\n", 12);
+        close(pipeFds[1]);
+
+        std::string first;
+        std::string second;
+        std::string end;
+        int firstCode = inputHandler.readUntilDelimiter('\n', first, false, true, true);
+        int secondCode = inputHandler.readUntilDelimiter('\n', second, false, true, true);
+        int endCode = inputHandler.readUntilDelimiter('\n', end, false, true, true);
+        close(pipeFds[0]);
+
+        if (firstCode != 0 || first != "Hello" || secondCode != 0 || second != "world" || endCode != 2 || inputHandler.syscalls() == 0) {
+            std::cerr << firstCode << " " << first << ", " << secondCode << " " << second << ", " << endCode << "\n";
+            return test::Result::FAILURE;
+        }
+        return test::Result::SUCCESS;
+    }
+
+    test::Result testMemoryTransport() {
+        std::string capture = std::string("\x00\x03" "abc" "\x00\x02" "de", 9) + std::string(100, 'x');
+        MemoryInputHandler inputHandler(MemoryTransport(capture), 16);
+
+        std::vector<std::string_view> messages;
+        int batchCode = inputHandler.readAllLengthPrefixed(2, messages);
+        std::vector<std::string> copies(messages.begin(), messages.end());
+        // bigger than the buffer, received directly into out
+        std::string big;
+        int bigCode = inputHandler.read(100, big);
+        int endCode = inputHandler.read(1, big);
+
+        if (batchCode != 0 || copies.size() != 2 || copies[0] != "abc" || copies[1] != "de" || bigCode != 0 || big != std::string(100, 'x')
+            || endCode != 2 || inputHandler.syscalls() != 0) {
+            std::cerr << batchCode << " " << copies.size() << " messages, " << bigCode << " " << big.size() << " bytes, " << endCode << "\n";
+            return test::Result::FAILURE;
+        }
+        return test::Result::SUCCESS;
+    }
+
+    test::Result testCaptureAndReplay() {
+        int fakeSocket[2];
+        if (createSocket(fakeSocket)) return test::Result::ERROR;
+        std::string path = "/tmp/network_capture_test_" + std::to_string(getpid());
+        size_t recordsCount;
+        {
+            CaptureWriter capture(path);
+            NetworkInputHandler inputHandler(fakeSocket[0], 64);
+            inputHandler.setCapture(&capture);
+            std::string message;
+            write(fakeSocket[1], "Hello\n", 6);
+            inputHandler.readUntilDelimiter('\n', message, false, true);
+            write(fakeSocket[1], "world\nagain\n", 12);
+            inputHandler.readUntilDelimiter('\n', message, false, true);
+            inputHandler.readUntilDelimiter('\n', message, false, true);
+            recordsCount = capture.recordsCount();
+        }
+        close(fakeSocket[0]);
+        close(fakeSocket[1]);
+
+        CaptureFile captureFile(path);
+        std::remove(path.c_str());
+        // each recv of the capture gives the same chunk, even with a bigger buffer
+        ReplayInputHandler replayHandler(ReplayTransport(captureFile), 1024);
+        std::vector<std::string> messages(3);
+        int firstCode = replayHandler.readUntilDelimiter('\n', messages[0], false, true);
+        int secondCode = replayHandler.readUntilDelimiter('\n', messages[1], false, true);
+        int thirdCode = replayHandler.readUntilDelimiter('\n', messages[2], false, true);
+        std::string end;
+        int endCode = replayHandler.readUntilDelimiter('\n', end, false, true);
+        NetworkInputStatistics statistics = replayHandler.statistics();
+
+        if (recordsCount != 2 || firstCode != 0 || secondCode != 0 || thirdCode != 0 || messages[0] != "Hello" || messages[1] != "world"
+            || messages[2] != "again" || endCode != 2 || statistics.recvCalls != 3) {
+            std::cerr << recordsCount << " records, replayed " << messages[0] << " " << messages[1] << " " << messages[2] << " then " << endCode
+                      << " in " << statistics.recvCalls << " recv\n";
+            return test::Result::FAILURE;
+        }
+        return test::Result::SUCCESS;
+    }
+
+    test::Result testPacedReplay() {
+        int fakeSocket[2];
+        if (createSocket(fakeSocket)) return test::Result::ERROR;
+        std::string path = "/tmp/network_paced_capture_test_" + std::to_string(getpid());
+        {
+            CaptureWriter capture(path);
+            NetworkInputHandler inputHandler(fakeSocket[0], 64);
+            inputHandler.setCapture(&capture);
+            std::string message;
+            write(fakeSocket[1], "a\n", 2);
+            inputHandler.readUntilDelimiter('\n', message, false, true);
+            std::this_thread::sleep_for(std::chrono::milliseconds(30));
+            write(fakeSocket[1], "b\n", 2);
+            inputHandler.readUntilDelimiter('\n', message, false, true);
+        }
+        close(fakeSocket[0]);
+        close(fakeSocket[1]);
+
+        CaptureFile captureFile(path);
+        std::remove(path.c_str());
+        ReplayInputHandler replayHandler(ReplayTransport(captureFile, true), 64);
+        std::string first;
+        std::string second;
+        auto start = std::chrono::steady_clock::now();
+        int firstCode = replayHandler.readUntilDelimiter('\n', first, false, true);
+        // the second chunk is not due yet
+        int notDueCode = replayHandler.readUntilDelimiter('\n', second, false, true);
+        int notDueErrno = errno;
+        int secondCode = replayHandler.readUntilDelimiter('\n', second, false, true, true);
+        auto elapsed = std::chrono::steady_clock::now() - start;
+
+        if (firstCode != 0 || first != "a" || notDueCode != 1 || notDueErrno != EAGAIN || secondCode != 0 || second != "b"
+            || elapsed < std::chrono::milliseconds(25)) {
+            std::cerr << firstCode << " " << notDueCode << " " << secondCode << " after "
+                      << std::chrono::duration_cast<std::chrono::milliseconds>(elapsed).count() << " ms\n";
+            return test::Result::FAILURE;
+        }
+        return test::Result::SUCCESS;
+    }
+
+    test::Result testCaptureFileInvalid() {
+        std::string path = "/tmp/network_invalid_capture_test_" + std::to_string(getpid());
+        int fd = open(path.c_str(), O_WRONLY | O_CREAT | O_TRUNC, 0644);
+        if (fd == -1) return test::Result::ERROR;
+        write(fd, "not a capture file", 18);
+        close(fd);
+        bool catched = false;
+
+        try {
+            CaptureFile captureFile(path);
+        }
+        catch (const std::runtime_error &e) {
+            std::cerr << e.what() << '\n';
+            catched = true;
+        }
+
+        std::remove(path.c_str());
+        return catched ? test::Result::SUCCESS : test::Result::FAILURE;
+    }
+
+    test::Result testMaxMessageSizeOfZero() {
+        int fakeSocket[2];
+        if (createSocket(fakeSocket)) return test::Result::ERROR;
+        NetworkInputHandler inputHandler(fakeSocket[0]);
+        bool catched = false;
+
+        try {
+            inputHandler.setMaxMessageSize(0);
+        }
+        catch (const std::invalid_argument &e) {
+            std::cerr << e.what() << '\n';
+            catched = true;
+        }
+
+        close(fakeSocket[0]);
+        close(fakeSocket[1]);
+
+        return catched ? test::Result::SUCCESS : test::Result::FAILURE;
+    }
+
+    test::Result testMaxMessageSizeKeepsRefusing() {
+        int fakeSocket[2];
+        if (createSocket(fakeSocket)) return test::Result::ERROR;
+        NetworkInputHandler inputHandler(fakeSocket[0], 64);
+        inputHandler.setMaxMessageSize(100);
+        std::string junk(1000, 'x');
+        write(fakeSocket[1], junk.c_str(), junk.size());
+
+        std::string message;
+        int errorCode = 1;
+        for (int i = 0; i < 100 && errorCode == 1; i++) {
+            errorCode = inputHandler.readUntilDelimiter('\n', message, false, true);
+        }
+        // the bytes are kept, the message is refused again
+        int againCode = inputHandler.readUntilDelimiter('\n', message, false, true);
+        size_t capacity = inputHandler.bufferCapacity();
+        size_t received = inputHandler.statistics().bytesReceived;
+        close(fakeSocket[0]);
+        close(fakeSocket[1]);
+
+        if (errorCode != 4 || againCode != 4 || capacity > 512 || received > 100 + 64) {
+            std::cerr << errorCode << " then " << againCode << ", capacity " << capacity << ", " << received << " bytes received\n";
+            return test::Result::FAILURE;
+        }
+        return test::Result::SUCCESS;
+    }
+
+    test::Result testMaxMessageSizeDiscardAdversarialInput() {
+        int fakeSocket[2];
+        if (createSocket(fakeSocket)) return test::Result::ERROR;
+        const size_t junkSize = 4 << 20;
+
+        // a client who never sends the delimiter, then a valid message
+        std::thread writeThread([&fakeSocket, junkSize] {
+            std::string junk(4096, 'x');
+            for (size_t sent = 0; sent < junkSize;) {
+                ssize_t written = write(fakeSocket[1], junk.c_str(), std::min(junk.size(), junkSize - sent));
+                if (written > 0) sent += written;
+                else std::this_thread::sleep_for(std::chrono::microseconds(100));
+            }
+            // the delimiter ends the refused message
+            while (write(fakeSocket[1], "\nok\n", 4) != 4) {
+                std::this_thread::sleep_for(std::chrono::microseconds(100));
+            }
+        });
+
+        NetworkInputHandler inputHandler(fakeSocket[0], 64);
+        inputHandler.setMaxMessageSize(256, true);
+        std::string message;
+        size_t refused = 0;
+        size_t maxCapacity = 0;
+        int errorCode = 1;
+        while (errorCode == 1 || errorCode == 4) {
+            errorCode = inputHandler.readUntilDelimiter('\n', message, false, true, true, 5000);
+            if (errorCode == 4) refused++;
+            maxCapacity = std::max(maxCapacity, inputHandler.bufferCapacity());
+        }
+        writeThread.join();
+        NetworkInputStatistics statistics = inputHandler.statistics();
+        close(fakeSocket[0]);
+        close(fakeSocket[1]);
+
+        if (errorCode != 0 || message != "ok" || refused != 1 || maxCapacity > 1024 || statistics.oversizeMessages != 1
+            || statistics.bytesDiscarded != junkSize + 1) {
+            std::cerr << errorCode << " " << message << ", " << refused << " refused, capacity up to " << maxCapacity << ", "
+                      << statistics.bytesDiscarded << " bytes discarded\n";
+            return test::Result::FAILURE;
+        }
+        return test::Result::SUCCESS;
+    }
+
+    test::Result testMaxMessageSizeDiscardCompleteMessage() {
+        int fakeSocket[2];
+        if (createSocket(fakeSocket)) return test::Result::ERROR;
+        NetworkInputHandler inputHandler(fakeSocket[0], 64);
+        inputHandler.setMaxMessageSize(5, true);
+        write(fakeSocket[1], "0123456789\r\nok\r\n", 16);
+
+        std::string message;
+        int refusedCode = inputHandler.readUntilDelimiter("\r\n", message, false, true);
+        int errorCode = inputHandler.readUntilDelimiter("\r\n", message, false, true);
+        int readCode = inputHandler.read(6, message);
+        close(fakeSocket[0]);
+        close(fakeSocket[1]);
+
+        if (refusedCode != 4 || errorCode != 0 || message != "ok" || readCode != 4) {
+            std::cerr << refusedCode << " " << errorCode << " " << message << " " << readCode << "\n";
+            return test::Result::FAILURE;
+        }
+        return test::Result::SUCCESS;
+    }
+
+    test::Result testMaxMessageSizeLengthPrefixed() {
+        int fakeSocket[2];
+        if (createSocket(fakeSocket)) return test::Result::ERROR;
+        NetworkInputHandler inputHandler(fakeSocket[0], 64);
+        inputHandler.setMaxMessageSize(1024);
+        // announces a message of 2 GB
+        write(fakeSocket[1], "\x7f\xff\xff\xff", 4);
+
+        std::vector<std::string_view> messages;
+        int errorCode = inputHandler.readAllLengthPrefixed(4, messages);
+        size_t capacity = inputHandler.bufferCapacity();
+        close(fakeSocket[0]);
+        close(fakeSocket[1]);
+
+        if (errorCode != 4 || !messages.empty() || capacity > 128) {
+            std::cerr << errorCode << ", capacity " << capacity << "\n";
+            return test::Result::FAILURE;
+        }
+        return test::Result::SUCCESS;
+    }
+
+    int receiveLowWatermark(int socket) {
+        int value = -1;
+        socklen_t length = sizeof(value);
+        getsockopt(socket, SOL_SOCKET, SO_RCVLOWAT, &value, &length);
+        return value;
+    }
+
+    test::Result testReceiveLowWatermark() {
+        int fakeSocket[2];
+        if (createSocket(fakeSocket)) return test::Result::ERROR;
+        NetworkInputHandler inputHandler(fakeSocket[0], 1024);
+        bool enableError = inputHandler.useReceiveLowWatermark();
+        std::string half(40, 'a');
+        write(fakeSocket[1], half.c_str(), half.size());
+
+        std::string message;
+        int incompleteCode = inputHandler.read(100, message);
+        // the socket is only readable again once the 60 missing bytes are there
+        int incompleteWatermark = receiveLowWatermark(fakeSocket[0]);
+        std::string rest(60, 'b');
+        write(fakeSocket[1], rest.c_str(), rest.size());
+        int errorCode = inputHandler.read(100, message);
+        int readWatermark = receiveLowWatermark(fakeSocket[0]);
+        bool disableError = inputHandler.useReceiveLowWatermark(false);
+        close(fakeSocket[0]);
+        close(fakeSocket[1]);
+
+        if (enableError || disableError || incompleteCode != 1 || incompleteWatermark != 60 || errorCode != 0 || message != half + rest
+            || readWatermark != 1) {
+            std::cerr << incompleteCode << " with watermark " << incompleteWatermark << ", " << errorCode << " with watermark " << readWatermark << "\n";
+            return test::Result::FAILURE;
+        }
+        return test::Result::SUCCESS;
+    }
+
+    test::Result testBusyPoll() {
+        int fakeSocket[2];
+        if (createSocket(fakeSocket)) return test::Result::ERROR;
+        NetworkInputHandler inputHandler(fakeSocket[0]);
+        bool error = inputHandler.setBusyPoll(50);
+        int setErrno = errno;
+        int value = -1;
+        socklen_t length = sizeof(value);
+        getsockopt(fakeSocket[0], SOL_SOCKET, SO_BUSY_POLL, &value, &length);
+        close(fakeSocket[0]);
+        close(fakeSocket[1]);
+
+        // only a privileged process can busy poll longer than net.core.busy_read
+        if (error ? setErrno != EPERM : value != 50) {
+            std::cerr << "busy poll error " << error << " (" << strerror(setErrno) << "), value " << value << "\n";
+            return test::Result::FAILURE;
+        }
+        return test::Result::SUCCESS;
+    }
+
+    test::Result testSharedMemoryRoundTrip() {
+        SharedMemoryRing ring(64);
+        // the reader maps the ring again from its file descriptors, as another process would
+        SharedMemoryRing readerRing(dup(ring.memoryFd()), dup(ring.dataEventFd()), dup(ring.spaceEventFd()));
+        SharedMemoryWriter writer(ring);
+        SharedMemoryInputHandler inputHandler(SharedMemoryTransport(readerRing), 16);
+
+        int writeCode = writer.write("Hello\nworld\n");
+        std::string first;
+        std::string second;
+        int firstCode = inputHandler.readUntilDelimiter('\n', first, false, true);
+        int secondCode = inputHandler.readUntilDelimiter('\n', second, false, true);
+        std::string empty;
+        int emptyCode = inputHandler.read(1, empty);
+        int emptyErrno = errno;
+        writer.close();
+        int endCode = inputHandler.read(1, empty);
+
+        if (writeCode != 0 || firstCode != 0 || first != "Hello" || secondCode != 0 || second != "world" || emptyCode != 1 || emptyErrno != EAGAIN
+            || endCode != 2 || writer.syscalls() != 0) {
+            std::cerr << writeCode << " " << firstCode << " " << first << " " << secondCode << " " << second << " then " << emptyCode << " "
+                      << endCode << ", " << writer.syscalls() << " writer syscalls\n";
+            return test::Result::FAILURE;
+        }
+        return test::Result::SUCCESS;
+    }
+
+    test::Result testSharedMemoryWrapAround() {
+        SharedMemoryRing ring(16);
+        SharedMemoryWriter writer(ring);
+        SharedMemoryInputHandler inputHandler(SharedMemoryTransport(ring), 8);
+
+        // 10 bytes of 16 so every other message is split at the end of the ring
+        for (int i = 0; i < 10; i++) {
+            std::string sent = "message " + std::to_string(i) + "\n";
+            std::string message;
+            int writeCode = writer.write(sent);
+            int readCode = inputHandler.read(10, message);
+            if (writeCode != 0 || readCode != 0 || message != sent) {
+                std::cerr << i << ": " << writeCode << " " << readCode << " " << message << "\n";
+                return test::Result::FAILURE;
+            }
+        }
+        return test::Result::SUCCESS;
+    }
+
+    test::Result testSharedMemoryFull() {
+        SharedMemoryRing ring(16);
+        SharedMemoryWriter writer(ring);
+        SharedMemoryInputHandler inputHandler(SharedMemoryTransport(ring), 16);
+
+        int firstCode = writer.write(std::string(10, 'a'));
+        // all or nothing when not retrying
+        int fullCode = writer.write(std::string(10, 'b'));
+        int fullErrno = errno;
+        std::string message;
+        int readCode = inputHandler.read(10, message);
+        int afterReadCode = writer.write(std::string(10, 'b'));
+
+        if (firstCode != 0 || fullCode != 1 || fullErrno != EAGAIN || readCode != 0 || message != std::string(10, 'a') || afterReadCode != 0) {
+            std::cerr << firstCode << " " << fullCode << " (" << strerror(fullErrno) << ") " << readCode << " " << afterReadCode << "\n";
+            return test::Result::FAILURE;
+        }
+        return test::Result::SUCCESS;
+    }
+
+    test::Result testSharedMemoryMessageBiggerThanRing() {
+        SharedMemoryRing ring(64);
+        std::string sent;
+        for (int i = 0; i < 1000; i++) sent += static_cast<char>('a' + i % 26);
+        std::string received;
+        int readCode;
+        std::thread reader([&ring, &received, &readCode]() {
+            SharedMemoryInputHandler inputHandler(SharedMemoryTransport(ring), 32);
+            // a read who gets part of the message returns EAGAIN and keeps it for the next one
+            do readCode = inputHandler.read(1000, received, true, 5000);
+            while (readCode == 1 && errno == EAGAIN);
+        });
+        SharedMemoryWriter writer(ring);
+        int writeCode = writer.write(sent, true, 5000);
+        reader.join();
+
+        if (writeCode != 0 || readCode != 0 || received != sent) {
+            std::cerr << writeCode << " " << readCode << " " << received.size() << " bytes received\n";
+            return test::Result::FAILURE;
+        }
+        return test::Result::SUCCESS;
+    }
+
+    test::Result testSharedMemoryWriteTimeout() {
+        SharedMemoryRing ring(16);
+        SharedMemoryWriter writer(ring);
+        SharedMemoryInputHandler inputHandler(SharedMemoryTransport(ring), 16);
+        writer.write(std::string(16, 'a'));
+        auto start = std::chrono::steady_clock::now();
+        int timeoutCode = writer.write("b", true, 20);
+        auto elapsed = std::chrono::steady_clock::now() - start;
+
+        if (timeoutCode != 3 || elapsed < std::chrono::milliseconds(20)) {
+            std::cerr << timeoutCode << " after " << std::chrono::duration_cast<std::chrono::milliseconds>(elapsed).count() << " ms\n";
+            return test::Result::FAILURE;
+        }
+        return test::Result::SUCCESS;
+    }
+
+    test::Result testSharedMemoryReaderClosed() {
+        SharedMemoryRing ring(16);
+        SharedMemoryWriter writer(ring);
+        int beforeCode;
+        {
+            SharedMemoryInputHandler inputHandler(SharedMemoryTransport(ring), 16);
+            beforeCode = writer.write("a");
+        }
+        int closedCode = writer.write("b");
+
+        if (beforeCode != 0 || closedCode != 2) {
+            std::cerr << beforeCode << " " << closedCode << "\n";
+            return test::Result::FAILURE;
+        }
+        return test::Result::SUCCESS;
+    }
+
+    test::Result testSharedMemoryCorruptedHead() {
+        SharedMemoryRing ring(64);
+        SharedMemoryWriter writer(ring);
+        SharedMemoryInputHandler inputHandler(SharedMemoryTransport(ring), 16);
+        writer.write("message\n");
+        // the other process can write anything in the header, the head is now far beyond the ring
+        ring.header().head.store(1000);
+        std::string message;
+        int readCode = inputHandler.read(8, message);
+        int readErrno = errno;
+        int writeCode = writer.write("b");
+        int writeErrno = errno;
+
+        if (readCode != 1 || readErrno != EPROTO || !message.empty() || writeCode != 1 || writeErrno != EPROTO) {
+            std::cerr << readCode << " (" << strerror(readErrno) << ") " << message.size() << " bytes read, ";
+            std::cerr << writeCode << " (" << strerror(writeErrno) << ")\n";
+            return test::Result::FAILURE;
+        }
+        return test::Result::SUCCESS;
+    }
+
+    test::Result testSharedMemoryInvalidCapacity() {
+        bool catched = false;
+        try {
+            SharedMemoryRing ring(100);
+        }
+        catch (const std::invalid_argument &e) {
+            std::cerr << e.what() << "\n";
+            catched = true;
+        }
+        if (!catched) return test::Result::FAILURE;
+        return test::Result::SUCCESS;
+    }
+
+    test::Result testLatencyHistograms() {
+        int fakeSocket[2];
+        if (createSocket(fakeSocket)) return test::Result::ERROR;
+        NetworkInputHandler inputHandler(fakeSocket[0], 8);
+        Histogram readTime;
+        Histogram messageTime;
+        inputHandler.setLatencyHistograms(&readTime, &messageTime);
+        write(fakeSocket[1], "Hel", 3);
+
+        std::string message;
+        int incompleteCode = inputHandler.readUntilDelimiter('\n', message, false, true);
+        std::this_thread::sleep_for(std::chrono::milliseconds(20));
+        write(fakeSocket[1], "lo\nab\n", 6);
+        // the first message started 20 ms ago, the second one is already received with it
+        int firstCode = inputHandler.readUntilDelimiter('\n', message, false, true);
+        int secondCode = inputHandler.readUntilDelimiter('\n', message, false, true);
+        close(fakeSocket[0]);
+        close(fakeSocket[1]);
+
+        if (incompleteCode != 1 || firstCode != 0 || secondCode != 0 || readTime.count() != 3 || messageTime.count() != 2
+            || messageTime.max() < 20'000'000 || messageTime.min() >= 20'000'000) {
+            std::cerr << readTime.count() << " reads timed, " << messageTime.count() << " messages timed between " << messageTime.min() << " and "
+                      << messageTime.max() << " ns\n";
+            return test::Result::FAILURE;
+        }
+        return test::Result::SUCCESS;
+    }
+
+    test::Result testGlobalStatistics() {
+        int fakeSocket[2];
+        if (createSocket(fakeSocket)) return test::Result::ERROR;
+        NetworkInputStatistics before = NetworkInputHandler::globalStatistics();
+        write(fakeSocket[1], "Hello", 5);
+
+        // the counters of a thread are kept once it ends
+        std::thread readThread([&fakeSocket] {
+            NetworkInputHandler inputHandler(fakeSocket[0]);
+            std::string_view message;
+            inputHandler.readView(5, message);
+        });
+        readThread.join();
+        write(fakeSocket[1], " world", 6);
+        NetworkInputHandler inputHandler(fakeSocket[0]);
+        std::string_view message;
+        inputHandler.readView(6, message);
+        NetworkInputStatistics after = NetworkInputHandler::globalStatistics();
+        close(fakeSocket[0]);
+        close(fakeSocket[1]);
+
+        if (after.bytesReceived - before.bytesReceived != 11 || after.messagesRead - before.messagesRead != 2 || after.largestMessage < 6) {
+            std::cerr << after.bytesReceived - before.bytesReceived << " bytes received, " << after.messagesRead - before.messagesRead << " messages\n";
+            return test::Result::FAILURE;
+        }
+        return test::Result::SUCCESS;
+    }
+
     void testNetwork(test::Tests *tests) {
         tests->beginTestBlock("test network input handler");
         tests->addTest(testBufferSizeOfZero, "buffer size of zero");
@@ -1319,15 +2924,102 @@ namespace networkTests {
         tests->addTest(testReadTwoMessagesWhoFitsInTheBuffer, "read two messages who fits in the buffer");
         tests->addTest(testReadTwoMessagesWhoDoesntFitsInTheBuffer, "read two messages who doesn't fits in the buffer");
         tests->addTest(testReadTwoMessagesWhoEachFitsInTheBuffer, "read two messages who each fits in the buffer");
+        tests->addTest(testReadKeepsBytesAfterError, "read keeps bytes after error");
+        tests->addTest(testReadView, "read view");
+        tests->addTest(testReadDirectlyIntoOutKeepsOvershoot, "read directly into out keeps overshoot");
+        tests->addTest(testReadDirectlyIntoOutKeepsBytesAfterError, "read directly into out keeps bytes after error");
+        tests->addTest(testReadBigMessageReceivedInParts, "read big message received in parts");
+        tests->addTest(testAdaptiveBufferSizeGrowsForBigMessage, "adaptive buffer size grows for big message");
+        tests->addTest(testAdaptiveBufferSizeShrinksForSmallMessages, "adaptive buffer size shrinks for small messages");
+        tests->addTest(testAdaptiveBufferSizeInvalidBounds, "adaptive buffer size invalid bounds");
+        tests->addTest(testReadWithIoUring, "read with io_uring");
+        tests->addTest(testDestroyIoUringReceiver, "destroy armed io_uring receiver");
 
         tests->beginTestBlock("retry if no byte received");
         tests->addTest(testReadRetryIfNoByteReceived, "read retry if no byte received");
         tests->addTest(testReadRetryIfNoByteReceivedAfterByteReceived, "read retry if no byte received after byte received");
+        tests->addTest(testReadRetryIfNoByteReceivedTimeout, "read retry if no byte received timeout");
+        tests->endTestBlock();
+        tests->endTestBlock();
+
+        tests->beginTestBlock("test delimiter search");
+        tests->addTest(testFindByteImplementations, "find byte implementations");
+        tests->addTest(testFindMultiByteDelimiter, "find multi-byte delimiter");
+        tests->endTestBlock();
+
+        tests->beginTestBlock("test batch read");
+        tests->addTest(testReadAllUntilDelimiter, "read all until delimiter");
+        tests->addTest(testReadAllUntilDelimiterStoppedByCallback, "read all until delimiter stopped by callback");
+        tests->addTest(testReadAllLengthPrefixed, "read all length prefixed");
+        tests->addTest(testReadAllLengthPrefixedOverflowingLength, "read all length prefixed overflowing length");
+        tests->endTestBlock();
+
+        tests->beginTestBlock("test statistics");
+        tests->addTest(testStatistics, "statistics");
+        tests->addTest(testGlobalStatistics, "global statistics");
+        tests->addTest(testLatencyHistograms, "latency histograms");
+        tests->endTestBlock();
+
+        tests->beginTestBlock("test transports");
+        tests->addTest(testFileTransportPipe, "file transport pipe");
+        tests->addTest(testMemoryTransport, "memory transport");
+        tests->endTestBlock();
+
+        tests->beginTestBlock("test capture");
+        tests->addTest(testCaptureAndReplay, "capture and replay");
+        tests->addTest(testPacedReplay, "paced replay");
+        tests->addTest(testCaptureFileInvalid, "capture file invalid");
+        tests->endTestBlock();
+
+        tests->beginTestBlock("test max message size");
+        tests->addTest(testMaxMessageSizeOfZero, "max message size of zero");
+        tests->addTest(testMaxMessageSizeKeepsRefusing, "max message size keeps refusing");
+        tests->addTest(testMaxMessageSizeDiscardAdversarialInput, "max message size discard adversarial input");
+        tests->addTest(testMaxMessageSizeDiscardCompleteMessage, "max message size discard complete message");
+        tests->addTest(testMaxMessageSizeLengthPrefixed, "max message size length prefixed");
+        tests->endTestBlock();
+
+        tests->beginTestBlock("test kernel tuning");
+        tests->addTest(testReceiveLowWatermark, "receive low watermark");
+        tests->addTest(testBusyPoll, "busy poll");
+        tests->endTestBlock();
+
+        tests->beginTestBlock("test shared memory");
+        tests->addTest(testSharedMemoryRoundTrip, "shared memory round trip");
+        tests->addTest(testSharedMemoryWrapAround, "shared memory wrap around");
+        tests->addTest(testSharedMemoryFull, "shared memory full");
+        tests->addTest(testSharedMemoryMessageBiggerThanRing, "shared memory message bigger than ring");
+        tests->addTest(testSharedMemoryWriteTimeout, "shared memory write timeout");
+        tests->addTest(testSharedMemoryReaderClosed, "shared memory reader closed");
+        tests->addTest(testSharedMemoryCorruptedHead, "shared memory corrupted head");
+        tests->addTest(testSharedMemoryInvalidCapacity, "shared memory invalid capacity");
+        tests->endTestBlock();
+
+        tests->beginTestBlock("test slab pool");
+        tests->addTest(testSlabPoolSizeOfZero, "slab pool size of zero");
+        tests->addTest(testSlabPoolGivenBackWhenDrained, "slab pool given back when drained");
+        tests->addTest(testSlabPoolIdleConnectionTakesNoSlab, "slab pool idle connection takes no slab");
+        tests->addTest(testSlabPoolBlockingSocket, "slab pool blocking socket");
+        tests->addTest(testSlabPoolMessageBiggerThanSlab, "slab pool message bigger than slab");
+        tests->addTest(testSlabPoolThreads, "slab pool threads");
         tests->endTestBlock();
+
+        tests->beginTestBlock("test frame reader");
+        tests->addTest(testReadFrameFixedHeader, "read frame with fixed header");
+        tests->addTest(testReadFrameFromMemory, "read frame from memory");
+        tests->addTest(testReadFrameVarintHeaderSplitBetweenTwoRecv, "read frame with varint header split between two recv");
+        tests->addTest(testReadFrameSplitHeaderDoesNotWait, "read frame split header does not wait");
+        tests->addTest(testReadFrameBiggerThanMaxFrameSize, "read frame bigger than max frame size");
+        tests->addTest(testReadFrameWithoutMaxFrameSize, "read frame without max frame size");
+        tests->addTest(testReadFrameInvalidVarint, "read frame with invalid varint");
         tests->endTestBlock();
 
         tests->beginTestBlock("test read until delimiter");
         tests->addTest(testReadUntilDelimiterCloseSocket, "read until delimiter close socket");
+        tests->addTest(testReadUntilDelimiterManyMessages, "read until delimiter many messages");
+        tests->addTest(testReadUntilDelimiterView, "read until delimiter view");
+        tests->addTest(testReadUntilMultiByteDelimiterSplitBetweenTwoRecv, "read until multi-byte delimiter split between two recv");
+        tests->addTest(testReadUntilEmptyDelimiter, "read until empty delimiter");
 
         tests->beginTestBlock("not including delimiter");
         tests->addTest(testReadUntilDelimiterSmallerThanBufferSize, "read until delimiter smaller than buffer size");
@@ -1388,6 +3080,7 @@ namespace networkTests {
         tests->addTest(testReadUntilDelimiterRetryIfNoByteReceived, "read until delimiter retry if no byte received");
         tests->addTest(testReadUntilDelimiterRetryIfNoByteReceivedAfterByteReceived,
                        "read until delimiter retry if no byte received after byte received");
+        tests->addTest(testReadUntilDelimiterRetryIfNoByteReceivedWithTimeout, "read until delimiter retry if no byte received with timeout");
         tests->endTestBlock();
         tests->endTestBlock();
         tests->endTestBlock();
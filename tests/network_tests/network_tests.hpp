@@ -2,8 +2,10 @@
 #define NETWORK_TESTS_HPP
 
 #include "../../cpp_tests/src/tests.hpp"
+#include "../../src/network_input_handler/frame_reader.hpp"
 #include "../../src/network_input_handler/network_input_handler.hpp"
 #include <fcntl.h>
+#include <poll.h>
 #include <thread>
 
 namespace networkTests {
@@ -0,0 +1,77 @@
+#include "network_trace_tests.hpp"
+
+namespace networkTraceTests {
+    test::Result testRecordAndSnapshot() {
+        networkTrace::clear();
+        networkTrace::record(networkTrace::Event::RECV, 3, 42);
+        networkTrace::record(networkTrace::Event::DELIMITER_FOUND, 3, 10);
+        std::vector<networkTrace::Record> records = networkTrace::snapshot();
+
+        if (records.size() != 2 || records[0].event != static_cast<uint16_t>(networkTrace::Event::RECV) || records[0].socket != 3
+            || records[0].value != 42 || records[1].event != static_cast<uint16_t>(networkTrace::Event::DELIMITER_FOUND) || records[1].value != 10
+            || records[0].ticks > records[1].ticks) {
+            std::cerr << records.size() << " records\n";
+            return test::Result::FAILURE;
+        }
+        return test::Result::SUCCESS;
+    }
+
+    test::Result testRingKeepsLastEvents() {
+        networkTrace::clear();
+        for (size_t i = 0; i < networkTrace::RING_CAPACITY + 10; i++) {
+            networkTrace::record(networkTrace::Event::RECV, 1, i);
+        }
+        std::vector<networkTrace::Record> records = networkTrace::snapshot();
+
+        if (records.size() != networkTrace::RING_CAPACITY || records.front().value != 10 || records.back().value != networkTrace::RING_CAPACITY + 9) {
+            std::cerr << records.size() << " records, first value " << (records.empty() ? 0 : records.front().value) << "\n";
+            return test::Result::FAILURE;
+        }
+        return test::Result::SUCCESS;
+    }
+
+    test::Result testRingPerThread() {
+        networkTrace::clear();
+        networkTrace::record(networkTrace::Event::RECV, 1, 1);
+        std::thread thread([] { networkTrace::record(networkTrace::Event::RECV, 2, 2); });
+        thread.join();
+        std::vector<networkTrace::Record> records = networkTrace::snapshot();
+
+        if (records.size() != 2 || records[0].thread == records[1].thread) {
+            std::cerr << records.size() << " records\n";
+            return test::Result::FAILURE;
+        }
+        return test::Result::SUCCESS;
+    }
+
+    test::Result testBinaryFile() {
+        networkTrace::clear();
+        networkTrace::record(networkTrace::Event::RECV_ERROR, 5, EAGAIN);
+        networkTrace::record(networkTrace::Event::WAIT, 5, -1);
+        std::string path = "/tmp/network_trace_test_" + std::to_string(getpid());
+        if (networkTrace::writeBinary(path)) return test::Result::ERROR;
+
+        std::vector<networkTrace::Record> records;
+        double ticksPerMicrosecond;
+        bool readError = networkTrace::readBinary(path, records, ticksPerMicrosecond);
+        std::remove(path.c_str());
+        std::ostringstream out;
+        networkTrace::print(out, records, ticksPerMicrosecond);
+
+        if (readError || records.size() != 2 || records[0].value != EAGAIN || out.str().find("recv error") == std::string::npos
+            || out.str().find("wait") == std::string::npos || out.str().find("-1") == std::string::npos) {
+            std::cerr << "read error: " << readError << ", decoded:\n" << out.str();
+            return test::Result::FAILURE;
+        }
+        return test::Result::SUCCESS;
+    }
+
+    void testNetworkTrace(test::Tests *tests) {
+        tests->beginTestBlock("test network trace");
+        tests->addTest(testRecordAndSnapshot, "record and snapshot");
+        tests->addTest(testRingKeepsLastEvents, "ring keeps last events");
+        tests->addTest(testRingPerThread, "ring per thread");
+        tests->addTest(testBinaryFile, "binary file");
+        tests->endTestBlock();
+    }
+} // namespace networkTraceTests
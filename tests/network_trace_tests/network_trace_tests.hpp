@@ -0,0 +1,14 @@
+#ifndef NETWORK_TRACE_TESTS_HPP
+#define NETWORK_TRACE_TESTS_HPP
+
+#include "../../cpp_tests/src/tests.hpp"
+#include "../../src/network_trace/network_trace.hpp"
+#include <cstdio>
+#include <sstream>
+#include <thread>
+
+namespace networkTraceTests {
+    void testNetworkTrace(test::Tests *tests);
+} // namespace networkTraceTests
+
+#endif // NETWORK_TRACE_TESTS_HPP
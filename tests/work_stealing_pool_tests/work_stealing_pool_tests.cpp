@@ -0,0 +1,80 @@
+#include "work_stealing_pool_tests.hpp"
+
+namespace workStealingPoolTests {
+    test::Result testZeroThreads() {
+        bool catched = false;
+
+        try {
+            WorkStealingPool(0);
+        }
+        catch (const std::invalid_argument &e) {
+            std::cerr << e.what() << '\n';
+            catched = true;
+        }
+
+        return catched ? test::Result::SUCCESS : test::Result::FAILURE;
+    }
+
+    test::Result testRunEveryTask() {
+        WorkStealingPool pool = WorkStealingPool(4);
+        std::atomic<size_t> count = 0;
+
+        for (size_t i = 0; i < 1000; i++) {
+            pool.submit([&count] { count++; });
+        }
+        pool.waitIdle();
+
+        if (count == 1000) return test::Result::SUCCESS;
+        std::cerr << "Expected 1000 tasks run, got " << count << "\n";
+        return test::Result::FAILURE;
+    }
+
+    test::Result testTasksSubmittingTasks() {
+        WorkStealingPool pool = WorkStealingPool(4);
+        std::atomic<size_t> count = 0;
+
+        // one task queuing every other task on its own thread, the other threads must steal them
+        pool.submit([&pool, &count] {
+            for (size_t i = 0; i < 1000; i++) {
+                pool.submit([&count] {
+                    std::this_thread::sleep_for(std::chrono::microseconds(10));
+                    count++;
+                });
+            }
+        });
+        pool.waitIdle();
+
+        if (count != 1000) {
+            std::cerr << "Expected 1000 tasks run, got " << count << "\n";
+            return test::Result::FAILURE;
+        }
+        if (pool.stolenTasks() == 0) {
+            std::cerr << "no task stolen\n";
+            return test::Result::FAILURE;
+        }
+        return test::Result::SUCCESS;
+    }
+
+    test::Result testDestructorRunsRemainingTasks() {
+        std::atomic<size_t> count = 0;
+        {
+            WorkStealingPool pool = WorkStealingPool(2);
+            for (size_t i = 0; i < 100; i++) {
+                pool.submit([&count] { count++; });
+            }
+        }
+
+        if (count == 100) return test::Result::SUCCESS;
+        std::cerr << "Expected 100 tasks run, got " << count << "\n";
+        return test::Result::FAILURE;
+    }
+
+    void testWorkStealingPool(test::Tests *tests) {
+        tests->beginTestBlock("test work stealing pool");
+        tests->addTest(testZeroThreads, "zero threads");
+        tests->addTest(testRunEveryTask, "run every task");
+        tests->addTest(testTasksSubmittingTasks, "tasks submitting tasks");
+        tests->addTest(testDestructorRunsRemainingTasks, "destructor runs remaining tasks");
+        tests->endTestBlock();
+    }
+} // namespace workStealingPoolTests
@@ -0,0 +1,11 @@
+#ifndef WORK_STEALING_POOL_TESTS_HPP
+#define WORK_STEALING_POOL_TESTS_HPP
+
+#include "../../cpp_tests/src/tests.hpp"
+#include "../../src/work_stealing_pool/work_stealing_pool.hpp"
+
+namespace workStealingPoolTests {
+    void testWorkStealingPool(test::Tests *tests);
+} // namespace workStealingPoolTests
+
+#endif // WORK_STEALING_POOL_TESTS_HPP
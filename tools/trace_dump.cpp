@@ -0,0 +1,22 @@
+#include "../src/network_trace/network_trace.hpp"
+#include <iostream>
+
+/**
+ * decodes a trace written by networkTrace::writeBinary.
+ * usage: trace_dump <trace file>
+ */
+int main(int argc, char *argv[]) {
+    if (argc != 2) {
+        std::cerr << "usage: " << argv[0] << " <trace file>\n";
+        return 1;
+    }
+    std::vector<networkTrace::Record> records;
+    double ticksPerMicrosecond;
+    if (networkTrace::readBinary(argv[1], records, ticksPerMicrosecond)) {
+        std::cerr << "can't read trace file " << argv[1] << "\n";
+        return 1;
+    }
+    std::cout << records.size() << " events\n";
+    networkTrace::print(std::cout, records, ticksPerMicrosecond);
+    return 0;
+}